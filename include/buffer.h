@@ -0,0 +1,63 @@
+/**
+ * @file buffer.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Growable in-memory text and byte buffers.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef BUFFER_H
+#define BUFFER_H
+
+#include <stddef.h>
+
+/**
+ * @brief A growable buffer; zero-initialize before first use.
+ *
+ * The contents are kept NUL-terminated so that text can be printed directly.
+ *
+ */
+typedef struct
+{
+    char *data;
+    size_t length;
+    size_t capacity;
+} buffer_t;
+
+/**
+ * @brief Appends formatted text.
+ *
+ * @param buffer Buffer to append to.
+ * @param format printf-style format.
+ * @return int Number of characters appended, or -1 on allocation failure.
+ */
+int buffer_printf(buffer_t *buffer, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Appends raw bytes.
+ *
+ * @param buffer Buffer to append to.
+ * @param data Bytes to append.
+ * @param size Number of bytes.
+ * @return int 0 on success, -1 on allocation failure.
+ */
+int buffer_write(buffer_t *buffer, const void *data, size_t size);
+
+/**
+ * @brief Empties the buffer without releasing its memory.
+ *
+ * @param buffer Buffer to empty.
+ */
+void buffer_clear(buffer_t *buffer);
+
+/**
+ * @brief Releases the buffer's memory and empties it.
+ *
+ * @param buffer Buffer to release.
+ */
+void buffer_free(buffer_t *buffer);
+
+#endif // BUFFER_H
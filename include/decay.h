@@ -19,7 +19,13 @@
  *
  */
 
+#ifndef DECAY_H
+#define DECAY_H
+
 #include <stdbool.h>
+#include "decay_atmosphere.h"
+#include "decay_checkpoint.h"
+#include "decay_weather.h"
 
 #define EARTH_RADIUS 6378000 // Radius of the Earth in meters.
 #define EARTH_MASS 5.98e24   // Mass of the Earth in kilograms.
@@ -28,47 +34,370 @@
 #define KARMAN_LINE 100000     // Minimum possible altitude in meters.
 #define TEMPORAL_RESOLUTION 60 // Seconds per step.
 #define MAX_ALTITUDE 5877.5 // km
+#define LIFETIME_LIMIT 1.577e9 // Seconds (~50 years) after which a calculation is abandoned.
+#define ADAPTIVE_TOLERANCE 1e-6 // Default relative tolerance on the re-entry time for the adaptive engine.
+#define ADAPTIVE_MAX_STEP (30 * 86400) // Largest step in seconds the adaptive engine may take.
+#define QUADRATURE_TOLERANCE 1e-10 // Relative tolerance of the altitude quadrature.
+#define ELLIPTICAL_CIRCULAR 0.01 // Elliptical orbits are propagated as circular once the density at apogee is within a factor exp(2 * ELLIPTICAL_CIRCULAR) of that at perigee.
+#define SOLVER_TOLERANCE 0.01 // Default width of the final bracket of the maximum average activity solvers.
+#define SOLVER_GUESS_SRF 70 // Default starting Solar Radio Flux of the solvers.
+#define SOLVER_GUESS_GEO 10 // Default starting Geomagnetic A Index of the solvers.
+
+/**
+ * @brief Integration engines available to the re-entry calculations.
+ *
+ */
+typedef enum
+{
+    DECAY_ENGINE_FIXED = 0, // Fixed steps of TEMPORAL_RESOLUTION seconds; the reference integrator.
+    DECAY_ENGINE_ADAPTIVE,  // Error-controlled Dormand-Prince 5(4) steps.
+    DECAY_ENGINE_QUADRATURE, // Lifetime integrated over radius; reports no trajectory.
+} decay_engine_t;
+
+/**
+ * @brief A lifetime integrated once in normalized time, which serves any mass and area.
+ *
+ * Mass and area only enter the model as the area-to-mass ratio, which scales the rate of decay. Integrating in normalized time (elapsed time times the ratio) therefore gives a result that is divided by the ratio to answer a query for any satellite at the same altitude and space weather.
+ *
+ */
+typedef struct
+{
+    double altitude;            // Initial altitude in kilometers.
+    double solar_radio_flux;    // Average Solar Radio Flux.
+    double geomagnetic_a_index; // Average Geomagnetic A Index.
+    double normalized_lifetime; // Lifetime times the area-to-mass ratio, in s m^2/kg.
+    double error_bound;         // Bound on the discretization error of normalized_lifetime, in s m^2/kg.
+} decay_normalized_t;
 
 /**
  * @brief Finds the maximum average Solar Radio Flux the given satellite can endure while maintaining a desired time of flight.
  *
+ * Brackets the answer from the guess and narrows it with the Illinois method. Each run is abandoned once it passes 1.5 times the mission time, since only whether re-entry comes before or after the mission time matters there.
+ *
  * @param satellite_mass Mass of the satellite in kilograms.
  * @param satellite_area Effective windward area of the satellite in square meters.
  * @param altitude The initial altitude of the satellite above the Earth's surface in kilometers.
  * @param geomagnetic_a_index The average Geomagnetic A Index during the satellite's lifetime.
  * @param mission_time The desired mission duration in days.
- * @return double Maximum average Solar Radio Flux.
+ * @param engine Integration engine used for each run.
+ * @param guess Warm-start guess, e.g. a previous answer; values <= 0 start from SOLVER_GUESS_SRF.
+ * @param tolerance Width in sfu below which the search stops; values <= 0 use SOLVER_TOLERANCE.
+ * @return double Maximum average Solar Radio Flux, or -1 if none was found.
  */
-double decay_max_avg_srf(double satellite_mass, double satellite_area, double altitude, double geomagnetic_a_index, int mission_time);
+double decay_max_avg_srf(double satellite_mass, double satellite_area, double altitude, double geomagnetic_a_index, int mission_time, decay_engine_t engine, double guess, double tolerance);
 
 /**
  * @brief Calculates the maximum average Geomagnetic A Index the given satellite can endure while maintaining a desired time of flight.
  *
+ * Solved the same way as decay_max_avg_srf(...).
+ *
  * @param satellite_mass Mass of the satellite in kilograms.
  * @param satellite_area Effective windward area of the satellite in square meters.
  * @param altitude The initial altitude of the satellite above the Earth's surface in kilometers.
  * @param solar_radio_flux The average Solar Radio Flux during the satellite's lifetime.
  * @param mission_time The desired mission duration in days.
- * @return double Maximum average Geomagnetic A Index.
+ * @param engine Integration engine used for each run.
+ * @param guess Warm-start guess, e.g. a previous answer; values <= 0 start from SOLVER_GUESS_GEO.
+ * @param tolerance Width in index units below which the search stops; values <= 0 use SOLVER_TOLERANCE.
+ * @return double Maximum average Geomagnetic A Index, or -1 if none was found.
+ */
+double decay_max_avg_geo(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, int mission_time, decay_engine_t engine, double guess, double tolerance);
+
+// decay_max_avg_srf(...) without prints, taking a fractional mission time in days.
+double decay_max_avg_srf_suppressed(double satellite_mass, double satellite_area, double altitude, double geomagnetic_a_index, double mission_time, decay_engine_t engine, double guess, double tolerance);
+
+// decay_max_avg_geo(...) without prints, taking a fractional mission time in days.
+double decay_max_avg_geo_suppressed(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double mission_time, decay_engine_t engine, double guess, double tolerance);
+
+/**
+ * @brief Outcome of decay_run(...).
+ *
+ */
+typedef enum
+{
+    DECAY_STATUS_REENTERED = 0, // Fell below the Karman Line within the time limit.
+    DECAY_STATUS_LIMIT,         // Still in orbit at the time limit.
+    DECAY_STATUS_STOPPED,       // Stopped by the sample callback.
+    DECAY_STATUS_INVALID,       // Invalid configuration.
+} decay_status_t;
+
+/**
+ * @brief Receives the trajectory at regular intervals.
+ *
+ * @param elapsed_time Seconds since the start of the propagation.
+ * @param altitude Altitude in kilometers.
+ * @param orbital_period Orbital period in seconds.
+ * @param context decay_config_t::context.
+ * @return int 0 to continue, or any other value to stop the propagation.
+ */
+typedef int (*decay_sample_callback_t)(double elapsed_time, double altitude, double orbital_period, void *context);
+
+/**
+ * @brief Derivatives of the lifetime with respect to the inputs, from decay_run(...).
+ *
+ * The model is a single equation for the period, dP/dt = f(P), whose variational equation has the solution dP/dx = f(P) q(t), where q is the integral of (df/dx) / f over time. The re-entry time therefore moves by -q at re-entry, and q is accumulated along the trajectory by every engine. Changes of a space weather history rescale q so that dP/dx stays continuous. With a history, F10.7 and Ap are unused and their derivatives are zero, as they are with the standard atmosphere.
+ *
+ */
+typedef struct
+{
+    double solar_radio_flux;    // Seconds of lifetime per sfu of average F10.7.
+    double geomagnetic_a_index; // Seconds of lifetime per unit of average Ap.
+    double area_mass;           // Seconds of lifetime per m^2/kg of area-to-mass ratio.
+} decay_sensitivity_t;
+
+/**
+ * @brief Events located by decay_run(...) in the same propagation, each interpolated within the step that passes it.
+ *
+ * The steps are interpolated by their dense output: straight lines through the fixed engine's Euler steps, and cubic Hermite polynomials through the steps of the adaptive engine and of the elliptical phase. The quadrature engine integrates the time to each altitude instead, and solves for the altitude at each epoch. Altitudes are those the samples report, that of the semi-major axis while an orbit is elliptical.
+ *
+ * Events the run does not reach, because it re-enters, reaches its time limit, or is stopped first, are set to -1.
+ *
+ */
+typedef struct
+{
+    const double *altitudes; // Kilometers.
+    double *crossing_times;  // Set to the first time in seconds at which the altitude is below each of altitudes; 0 if it starts below.
+    int altitude_count;
+    const double *epochs;    // Seconds since the start of the propagation.
+    double *epoch_altitudes; // Set to the altitude in kilometers at each of epochs.
+    int epoch_count;
+    double period;           // Seconds; values <= 0 locate no period event.
+    double period_time;      // Set to the first time in seconds at which the orbital period is below period; 0 if it starts below.
+} decay_events_t;
+
+/**
+ * @brief Inputs of decay_run(...). Zero-initialize, then set the satellite and space weather.
+ *
+ */
+typedef struct
+{
+    decay_engine_t engine;
+    double satellite_mass;          // Kilograms.
+    double satellite_area;          // Effective windward area in square meters.
+    double altitude;                // Initial altitude above the Earth's surface in kilometers.
+    double solar_radio_flux;        // Average Solar Radio Flux; unused with a history.
+    double geomagnetic_a_index;     // Average Geomagnetic A Index; unused with a history.
+    const decay_weather_t *weather; // Space weather history, or NULL for the averages.
+    double tolerance;               // Relative tolerance of the adaptive engine; values <= 0 use ADAPTIVE_TOLERANCE.
+    double time_limit;              // Seconds after which the propagation is abandoned; values <= 0 use LIFETIME_LIMIT.
+    double sample_interval;         // Seconds between calls of on_sample, starting at zero.
+    decay_sample_callback_t on_sample; // Optional; the quadrature engine only samples the initial state.
+    void *context;                  // Passed to on_sample.
+    double step;                    // Seconds per step of the fixed engine; values <= 0 use TEMPORAL_RESOLUTION.
+    decay_atmosphere_t atmosphere;  // Density model; zero selects DECAY_ATMOSPHERE_EXPONENTIAL.
+    decay_sensitivity_t *sensitivity; // Optional; set to the derivatives of the lifetime, or to NAN unless the satellite re-entered from a circular orbit.
+    double apogee;                  // Apogee altitude in kilometers of an elliptical orbit whose perigee is altitude; values <= altitude give a circular orbit. Below DECAY_ATMOSPHERE_EXPONENTIAL_CEILING with the exponential model.
+    decay_checkpoints_t *checkpoints; // Optional; resumed from and updated by the run, see decay_run(...).
+    decay_events_t *events;         // Optional; located during the run.
+} decay_config_t;
+
+/**
+ * @brief Outputs of decay_run(...).
+ *
+ */
+typedef struct
+{
+    decay_status_t status;
+    double lifetime;       // Seconds before falling below the Karman Line, or -1 unless status is DECAY_STATUS_REENTERED.
+    double elapsed_time;   // Seconds at the final state.
+    double altitude;       // Altitude at the final state in kilometers.
+    double orbital_period; // Orbital period at the final state in seconds.
+    long steps;            // Integration steps taken, from the checkpoint resumed if any; 0 for the quadrature engine.
+} decay_result_t;
+
+/**
+ * @brief Propagates one satellite to re-entry.
+ *
+ * Reentrant and allocation-free: all state lives on the caller's stack, so any number of threads may call it at once. Nothing is printed or written; the trajectory is only available through the optional sample callback.
+ *
+ * The final state after a re-entry is that of the last fixed step, or the Karman Line itself for the other engines, as in the print-out of decay_calculate(...).
+ *
+ * With config->sensitivity set, the derivatives of the lifetime are carried along the same propagation; the maximum average activity solvers use them for Newton steps.
+ *
+ * An elliptical orbit (config->apogee above config->altitude) is first propagated as its semi-major axis and eccentricity under orbit-averaged drag, with error-controlled Dormand-Prince 5(4) steps at config->tolerance whatever the engine. The density average around each orbit takes a few density evaluations by the trapezoidal rule over the eccentric anomaly, or Gauss-Kronrod panels for sharp perigee peaks and the bands of the standard atmosphere. Once the density at apogee is within a factor exp(2 * ELLIPTICAL_CIRCULAR) of that at perigee, the orbit continues on the circular model and the chosen engine from its semi-major axis. Meanwhile, samples and the final state report the altitude and model period of the semi-major axis, and a perigee that falls below the Karman Line first ends the run. An orbit that reaches DECAY_ATMOSPHERE_EXPONENTIAL_CEILING, circular or elliptical, is invalid with the exponential model, whose density is undefined there, and a step whose orbit averages are not finite ends the run as DECAY_STATUS_INVALID rather than as a re-entry.
+ *
+ * With config->checkpoints, the run resumes from the latest checkpoint that it would have passed through itself: one recorded with the same satellite, orbit, engine, step, tolerance, and atmosphere, at or before the time limit, and under the same space weather up to its time. Later checkpoints are replaced by those of the run, and a set recorded with other inputs is cleared first. A resumed run gives the same result as an uninterrupted one, and samples from the checkpoint on. Runs with config->sensitivity or config->events set start from the beginning, since checkpoints do not hold the sensitivity integrals or the earlier events, and the quadrature engine records none.
+ *
+ * @param config Inputs.
+ * @param result Set to the outcome.
+ * @return int 0 on success, -1 if the configuration is invalid.
+ */
+int decay_run(const decay_config_t *config, decay_result_t *result);
+
+/**
+ * @brief Keplerian period of a circular orbit, as used for every initial condition.
+ *
+ * @param altitude Altitude above the Earth's surface in kilometers.
+ * @return double Orbital period in seconds.
+ */
+double decay_circular_period(double altitude);
+
+/**
+ * @brief Orbital period at which a propagation passes an altitude, the inverse of the model's radius update. Differs slightly from decay_circular_period(...) because of the model's cube root exponent.
+ *
+ * @param altitude Altitude above the Earth's surface in kilometers.
+ * @return double Orbital period in seconds.
+ */
+double decay_model_period(double altitude);
+
+/**
+ * @brief Initial altitude of one run of a multi-run sweep, placed exactly as decay_calculate(...) and decay_calculate_sweep(...) place them.
+ *
+ * @param altitude The initial altitude of the first run in kilometers.
+ * @param run_increment Delta-altitude per run (km).
+ * @param run Run number, from 1.
+ * @return double Initial altitude in kilometers.
+ */
+double decay_sweep_altitude(double altitude, float run_increment, int run);
+
+
+/**
+ * @brief Calculates the time to re-entry using error-controlled adaptive steps.
+ *
+ * Propagates the same model as decay_calculate_suppressed(...), but with Dormand-Prince 5(4) steps that grow to days while decay is slow and shrink near re-entry. The local error of each step is converted into the time shift it causes along the trajectory and kept below tolerance times the step size, so the accumulated error in the re-entry time stays near tolerance times the lifetime. The Karman Line crossing is located within the final step by cubic Hermite interpolation.
+ *
+ * @param satellite_mass Mass of the satellite in kilograms.
+ * @param satellite_area Effective windward area of the satellite in square meters.
+ * @param altitude The initial altitude of the satellite above the Earth's surface in kilometers.
+ * @param solar_radio_flux The average Solar Radio Flux during the satellite's lifetime.
+ * @param geomagnetic_a_index The average Geomagnetic A Index during the satellite's lifetime.
+ * @param tolerance Relative tolerance on the re-entry time, e.g. ADAPTIVE_TOLERANCE.
+ * @return double Elapsed time in seconds before falling below the Karman Line, or -1 if the lifetime exceeds 50 years.
+ */
+double decay_calculate_adaptive(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, double tolerance);
+
+/**
+ * @brief Calculates the time to re-entry by integrating over orbital radius instead of time.
+ *
+ * With constant space weather the model is a one-dimensional ODE in the orbital period, so the lifetime is the integral of dt/dr = (dP/dr) / (dP/dt) from the Karman Line up to the initial radius. The integral is evaluated with adaptive Gauss-Kronrod (7, 15) quadrature using the same SH and density formula as decay_calculate_suppressed(...), which takes tens to hundreds of density evaluations instead of one per 60 second step.
+ *
+ * @param satellite_mass Mass of the satellite in kilograms.
+ * @param satellite_area Effective windward area of the satellite in square meters.
+ * @param altitude The initial altitude of the satellite above the Earth's surface in kilometers.
+ * @param solar_radio_flux The average Solar Radio Flux during the satellite's lifetime.
+ * @param geomagnetic_a_index The average Geomagnetic A Index during the satellite's lifetime.
+ * @return double Elapsed time in seconds before falling below the Karman Line, or -1 if the lifetime exceeds 50 years.
+ */
+double decay_calculate_quadrature(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index);
+
+/**
+ * @brief Calculates the time to re-entry with the chosen engine, without prints.
+ *
+ * @param engine Integration engine used for the calculation.
+ * @param satellite_mass Mass of the satellite in kilograms.
+ * @param satellite_area Effective windward area of the satellite in square meters.
+ * @param altitude The initial altitude of the satellite above the Earth's surface in kilometers.
+ * @param solar_radio_flux The average Solar Radio Flux during the satellite's lifetime.
+ * @param geomagnetic_a_index The average Geomagnetic A Index during the satellite's lifetime.
+ * @param tolerance Relative tolerance on the re-entry time; only used by DECAY_ENGINE_ADAPTIVE.
+ * @param time_limit Time in seconds after which the calculation is abandoned, e.g. LIFETIME_LIMIT or INFINITY.
+ * @return double Elapsed time in seconds before falling below the Karman Line, or -1 if the lifetime exceeds time_limit.
+ */
+double decay_calculate_lifetime(decay_engine_t engine, double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, double tolerance, double time_limit);
+
+/**
+ * @brief Calculates the time to re-entry under a space weather history, without prints.
+ *
+ * The fixed engine takes the scale height numerator of the sample in effect at the start of each step. The adaptive engine ends its steps at the history's sample boundaries and integrates each interval with that interval's values. The quadrature engine cannot follow a history and is replaced by the adaptive engine.
+ *
+ * @param engine Integration engine used for the calculation.
+ * @param satellite_mass Mass of the satellite in kilograms.
+ * @param satellite_area Effective windward area of the satellite in square meters.
+ * @param altitude The initial altitude of the satellite above the Earth's surface in kilometers.
+ * @param weather Space weather history, with time zero at the start of the propagation.
+ * @param tolerance Relative tolerance on the re-entry time; only used by DECAY_ENGINE_ADAPTIVE.
+ * @param time_limit Time in seconds after which the calculation is abandoned, e.g. LIFETIME_LIMIT or INFINITY.
+ * @return double Elapsed time in seconds before falling below the Karman Line, or -1 if the lifetime exceeds time_limit.
+ */
+double decay_calculate_lifetime_weather(decay_engine_t engine, double satellite_mass, double satellite_area, double altitude, const decay_weather_t *weather, double tolerance, double time_limit);
+
+/**
+ * @brief Estimates the time to re-entry with the quadrature engine, to plan work such as starting the longest runs first.
+ *
+ * Unlike decay_calculate_lifetime(...), the estimate is not counted by the runtime statistics (decay_stats.h), whose runs are those whose results are used.
+ *
+ * @param satellite_mass Mass of the satellite in kilograms.
+ * @param satellite_area Effective windward area of the satellite in square meters.
+ * @param altitude The initial altitude of the satellite above the Earth's surface in kilometers.
+ * @param solar_radio_flux The average Solar Radio Flux during the satellite's lifetime.
+ * @param geomagnetic_a_index The average Geomagnetic A Index during the satellite's lifetime.
+ * @return double Elapsed time in seconds before falling below the Karman Line, without a time limit, or -1 on invalid inputs.
  */
-double decay_max_avg_geo(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, int mission_time);
+double decay_estimate_lifetime(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index);
 
 /**
- * @brief Calculates the amount of time it will take a satellite to descend to below the Karman Line due to air resistance.
+ * @brief Estimates the relative run time of a propagation, to order work with pool_order(...).
  *
- * All values should be in meters, seconds, or kilograms.
+ * Fixed steps cost in proportion to the lifetime, which decay_estimate_lifetime(...) gives in about a microsecond, up to LIFETIME_LIMIT. The adaptive and quadrature engines take about as long whatever the lifetime, so their cost is 1.
  *
+ * @param engine Engine of the propagation.
  * @param satellite_mass Mass of the satellite in kilograms.
  * @param satellite_area Effective windward area of the satellite in square meters.
  * @param altitude The initial altitude of the satellite above the Earth's surface in kilometers.
  * @param solar_radio_flux The average Solar Radio Flux during the satellite's lifetime.
  * @param geomagnetic_a_index The average Geomagnetic A Index during the satellite's lifetime.
- * @param save_to_csv True - saves the run data in a .csv file; False - Does not.
- * @param runs Number of times to run the calculation.
+ * @return double Relative cost; 1 on invalid inputs.
+ */
+double decay_estimate_cost(decay_engine_t engine, double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index);
+
+/**
+ * @brief Calculates the lifetimes of a multi-run altitude sweep from a single integration.
+ *
+ * With constant space weather a satellite started at the highest altitude passes through every lower one, so the lifetime from a lower altitude is the top run's lifetime less the time taken to descend to it. The highest run is integrated once and the time at which it passes each lower run's initial period is recorded. Runs are placed exactly as in decay_calculate(...). For the fixed engine each lifetime matches a separate run to within a step or two.
+ *
+ * Runs whose lifetime clearly exceeds 50 years are identified beforehand with the quadrature engine and are not integrated.
+ *
+ * @param engine Integration engine used for the pass.
+ * @param satellite_mass Mass of the satellite in kilograms.
+ * @param satellite_area Effective windward area of the satellite in square meters.
+ * @param altitude The initial altitude of the first run above the Earth's surface in kilometers.
+ * @param solar_radio_flux The average Solar Radio Flux during the satellite's lifetime.
+ * @param geomagnetic_a_index The average Geomagnetic A Index during the satellite's lifetime.
+ * @param runs Number of runs.
  * @param run_increment Delta-altitude per run (km).
- * @return int Elapsed time in seconds before falling below the Karman Line.
+ * @param tolerance Relative tolerance on the re-entry time; only used by DECAY_ENGINE_ADAPTIVE.
+ * @param lifetimes Array of runs elements, set to each run's lifetime in seconds or -1 if it exceeds 50 years.
+ * @return int 0 on success.
+ */
+int decay_calculate_sweep(decay_engine_t engine, double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, int runs, float run_increment, double tolerance, double *lifetimes);
+
+/**
+ * @brief Integrates a lifetime once in normalized time for later queries with decay_normalized_lifetime(...).
+ *
+ * Uses the adaptive engine, since the fixed engine's 60 second steps are fixed in real time and do not scale with the area-to-mass ratio. The integration is run at the given tolerance and again at a sixteenth of it; the refined result is kept, and the error bound combines the refined run's tolerance with the difference between the runs.
+ *
+ * @param altitude The initial altitude of the satellite above the Earth's surface in kilometers.
+ * @param solar_radio_flux The average Solar Radio Flux during the satellite's lifetime.
+ * @param geomagnetic_a_index The average Geomagnetic A Index during the satellite's lifetime.
+ * @param tolerance Relative tolerance on the re-entry time; values <= 0 use ADAPTIVE_TOLERANCE.
+ * @param normalized Set to the normalized lifetime and its error bound.
+ * @return int 0 on success, -1 on failure.
+ */
+int decay_normalize(double altitude, double solar_radio_flux, double geomagnetic_a_index, double tolerance, decay_normalized_t *normalized);
+
+/**
+ * @brief Rescales a normalized lifetime to a particular satellite.
+ *
+ * @param normalized Result of decay_normalize(...).
+ * @param satellite_mass Mass of the satellite in kilograms.
+ * @param satellite_area Effective windward area of the satellite in square meters.
+ * @param error_bound If not NULL, set to the bound on the lifetime's discretization error in seconds.
+ * @return double Elapsed time in seconds before falling below the Karman Line, or -1 if the lifetime exceeds 50 years.
+ */
+double decay_normalized_lifetime(const decay_normalized_t *normalized, double satellite_mass, double satellite_area, double *error_bound);
+
+/**
+ * @brief Determines whether re-entry happens before a target time, stopping the run as soon as it passes the target.
+ *
+ * @param engine Integration engine used for the run.
+ * @param satellite_mass Mass of the satellite in kilograms.
+ * @param satellite_area Effective windward area of the satellite in square meters.
+ * @param altitude The initial altitude of the satellite above the Earth's surface in kilometers.
+ * @param solar_radio_flux The average Solar Radio Flux during the satellite's lifetime.
+ * @param geomagnetic_a_index The average Geomagnetic A Index during the satellite's lifetime.
+ * @param target_time Target time in seconds.
+ * @return int 1 if the satellite falls below the Karman Line by the target time, 0 otherwise.
  */
-int decay_calculate(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, bool save_to_csv, int runs, float run_increment);
+int decay_reentry_before(decay_engine_t engine, double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, double target_time);
 
-// Decay calculate without prints, used by decay_max_avg_activity(...).
-int decay_calculate_suppressed(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index);
\ No newline at end of file
+#endif // DECAY_H
\ No newline at end of file
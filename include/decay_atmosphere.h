@@ -0,0 +1,79 @@
+/**
+ * @file decay_atmosphere.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Atmospheric density models.
+ *
+ * The exponential model of the original program, whose scale height follows the space weather, is the default. The standard model is a static piecewise-exponential atmosphere after CIRA-72 and the US Standard Atmosphere 1976 (the band table of Vallado, Fundamentals of Astrodynamics and Applications). It ignores the space weather and is evaluated from a precomputed 1 km table without calling exp.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef DECAY_ATMOSPHERE_H
+#define DECAY_ATMOSPHERE_H
+
+#include <math.h>
+
+#define DECAY_ATMOSPHERE_EXPONENTIAL_CEILING 2450.0 // Kilometers; from here up the exponential model's scale height is no longer positive.
+
+/**
+ * @brief Density models available to the re-entry calculations.
+ *
+ */
+typedef enum
+{
+    DECAY_ATMOSPHERE_EXPONENTIAL = 0, // Exponential with a scale height set by F10.7 and Ap; the reference model.
+    DECAY_ATMOSPHERE_STANDARD,        // Tabulated static standard atmosphere; independent of the space weather.
+} decay_atmosphere_t;
+
+/**
+ * @brief Density of the exponential model, kept inline for the integration loops.
+ *
+ * @param altitude Meters.
+ * @param sh_numerator 900 + 2.5 (F10.7 - 70) + 1.5 Ap.
+ * @return double Density in kg/m^3.
+ */
+static inline double decay_atmosphere_exponential(double altitude, double sh_numerator)
+{
+    double SH = sh_numerator / (27 - 0.012 * ((altitude / 1000) - 200)); // A placeholder calculation for atmospheric_density.
+    return 6e-10 * exp(-((altitude / 1000) - 175) / SH);
+}
+
+/**
+ * @brief Density of the standard model.
+ *
+ * The table is built on the first call. Within each 1 km bin the exponential decay of its band is evaluated with a fourth-order polynomial plus a linear term that keeps the density continuous from bin to bin. The result is within 2e-6 of the band formulas, except in the last kilometer below a band's base, where it also closes the small jumps between the bands.
+ *
+ * @param altitude Meters.
+ * @return double Density in kg/m^3.
+ */
+double decay_atmosphere_standard(double altitude);
+
+/**
+ * @brief Altitudes at which the density of a model changes its scale height abruptly: the band bases of the standard model.
+ *
+ * Quadratures across a range of altitudes split their panels there, since the density is only smooth between them.
+ *
+ * @param model Density model.
+ * @param lower Meters.
+ * @param upper Meters.
+ * @param breaks Set to the altitudes in meters strictly between lower and upper, in increasing order.
+ * @param size Capacity of breaks.
+ * @return int Altitudes written, at most size; 0 for the exponential model.
+ */
+int decay_atmosphere_breaks(decay_atmosphere_t model, double lower, double upper, double *breaks, int size);
+
+/**
+ * @brief Density of any model.
+ *
+ * @param model Density model.
+ * @param altitude Meters.
+ * @param sh_numerator 900 + 2.5 (F10.7 - 70) + 1.5 Ap; ignored by the standard model.
+ * @return double Density in kg/m^3, or NAN for an unknown model.
+ */
+double decay_atmosphere_density(decay_atmosphere_t model, double altitude, double sh_numerator);
+
+#endif // DECAY_ATMOSPHERE_H
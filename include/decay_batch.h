@@ -0,0 +1,53 @@
+/**
+ * @file decay_batch.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Batched fixed-step decay calculations for many satellites in lockstep.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef DECAY_BATCH_H
+#define DECAY_BATCH_H
+
+#include "decay.h"
+
+/**
+ * @brief Instruction sets the batched kernel can run on.
+ *
+ */
+typedef enum
+{
+    DECAY_BATCH_AUTO = 0, // Best instruction set supported by the running CPU.
+    DECAY_BATCH_SCALAR,   // One satellite at a time with decay_calculate_suppressed(...)'s loop.
+    DECAY_BATCH_AVX2,     // Four satellites per step with AVX2 and FMA.
+    DECAY_BATCH_AVX512,   // Eight satellites per step with AVX-512F.
+} decay_batch_isa_t;
+
+/**
+ * @brief Best instruction set supported by the running CPU.
+ *
+ * @return decay_batch_isa_t DECAY_BATCH_AVX512, DECAY_BATCH_AVX2, or DECAY_BATCH_SCALAR.
+ */
+decay_batch_isa_t decay_batch_isa(void);
+
+/**
+ * @brief Calculates the time to re-entry of many satellites, as decay_calculate_suppressed(...) does for one.
+ *
+ * Satellites are given as structure-of-arrays. The vector kernels step four or eight satellites together in fixed TEMPORAL_RESOLUTION steps, using vectorized exp and log in place of the libm calls. When a satellite re-enters or passes 50 years its lane is refilled with the next unstarted satellite, and lanes left without work are masked out. Because the vector exp and log round differently from libm, a lifetime may differ from decay_calculate_suppressed(...) by a step.
+ *
+ * @param count Number of satellites.
+ * @param satellite_mass Mass of each satellite in kilograms.
+ * @param satellite_area Effective windward area of each satellite in square meters.
+ * @param altitude Initial altitude of each satellite above the Earth's surface in kilometers.
+ * @param solar_radio_flux Average Solar Radio Flux during each satellite's lifetime.
+ * @param geomagnetic_a_index Average Geomagnetic A Index during each satellite's lifetime.
+ * @param lifetimes Set to each satellite's elapsed time in seconds before falling below the Karman Line, or -1 if it exceeds 50 years.
+ * @param isa Instruction set to use; DECAY_BATCH_AUTO selects the best one at runtime.
+ * @return int The instruction set used, or -1 if the requested one is not supported by the CPU.
+ */
+int decay_calculate_batch(int count, const double *satellite_mass, const double *satellite_area, const double *altitude, const double *solar_radio_flux, const double *geomagnetic_a_index, double *lifetimes, decay_batch_isa_t isa);
+
+#endif // DECAY_BATCH_H
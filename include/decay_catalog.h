@@ -0,0 +1,102 @@
+/**
+ * @file decay_catalog.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Re-entry screening of a catalog of two-line element sets.
+ *
+ * A catalog is a text file of two-line element sets (TLEs), each optionally preceded by a name line, as distributed by CelesTrak and Space-Track ("0 NAME" lines are accepted). Only the fields the model needs are read from their fixed columns: the catalog number (numeric or Alpha-5), the epoch, B*, the eccentricity, and the mean motion. Checksums and the remaining elements are ignored.
+ *
+ * The mean motion gives the semi-major axis, and with the eccentricity the perigee and apogee of the initial orbit, which decay_run(...) propagates as elliptical until it is nearly circular. B* gives the area-to-mass ratio through B* = rho0 (Cd A / m) / 2 with rho0 = 0.15696615 kg/m^2/ER, so the ratio used is the ballistic term Cd A / m (the model's effective area includes the drag coefficient). A mass and area map overrides B* for the objects it lists, which is preferable for payloads with known properties, since B* also absorbs other unmodeled forces and is often zero or negative.
+ *
+ * Lifetimes are computed from each object's epoch with the average F10.7 and Ap of the options. The results are written as CSV, soonest re-entry first:
+ *
+ *     rank,catalog,name,epoch,altitude,area_mass,source,days,reentry
+ *
+ * where epoch and reentry are UTC dates (YYYY-MM-DD), altitude is that of the semi-major axis in kilometers, area_mass in m^2/kg, source is "map" or "bstar", and days is the lifetime after the epoch. Objects that stay up more than 50 years follow with days of -1 and no date. Objects that were not propagated come last with empty days and reentry: those without a usable area-to-mass ratio, which have the source "none", and those whose orbit the atmosphere model does not cover, such as an apogee at or above DECAY_ATMOSPHERE_EXPONENTIAL_CEILING with the exponential model.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef DECAY_CATALOG_H
+#define DECAY_CATALOG_H
+
+#include <stdio.h>
+#include "decay.h"
+
+#define DECAY_CATALOG_NAME 25              // Longest name kept, including the terminator.
+#define DECAY_CATALOG_BSTAR_RHO 0.15696615 // Reference density of B* in kg/m^2 per Earth radius.
+#define DECAY_CATALOG_SRF 150              // Default average Solar Radio Flux of a screening.
+#define DECAY_CATALOG_GEO 15               // Default average Geomagnetic A Index of a screening.
+
+/**
+ * @brief Where an object's area-to-mass ratio comes from.
+ *
+ */
+typedef enum
+{
+    DECAY_CATALOG_NONE = 0, // Not listed in the map and B* is not positive; not propagated.
+    DECAY_CATALOG_BSTAR,    // From the TLE's B* drag term.
+    DECAY_CATALOG_MAP,      // From the mass and area map.
+} decay_catalog_source_t;
+
+/**
+ * @brief One object of a catalog.
+ *
+ */
+typedef struct
+{
+    int catalog;                   // NORAD catalog number; Alpha-5 numbers continue from 100000.
+    char name[DECAY_CATALOG_NAME]; // Name line, or empty.
+    double epoch;                  // Days since 1970-01-01 UTC.
+    double altitude;               // Altitude of the semi-major axis in kilometers, from the mean motion.
+    double eccentricity;           // Mean eccentricity of the TLE.
+    double bstar;                  // B* in 1/ER.
+    double area_mass;              // m^2/kg used for the propagation.
+    decay_catalog_source_t source;
+    double lifetime;               // Seconds after the epoch, -1 if beyond 50 years, or NAN if not propagated.
+} decay_catalog_object_t;
+
+/**
+ * @brief Settings of a screening.
+ *
+ */
+typedef struct
+{
+    decay_engine_t engine;
+    double tolerance;              // Relative tolerance of the adaptive engine; values <= 0 use ADAPTIVE_TOLERANCE.
+    int threads;                   // Threads to use, including the caller; values < 1 use pool_default_threads().
+    double solar_radio_flux;       // Average Solar Radio Flux over every lifetime.
+    double geomagnetic_a_index;    // Average Geomagnetic A Index over every lifetime.
+    decay_atmosphere_t atmosphere; // Density model.
+    int limit;                     // Rows written, soonest first; values < 1 write every object.
+} decay_catalog_options_t;
+
+/**
+ * @brief Parses one two-line element set.
+ *
+ * Each line ends at a line break or a terminator, and only its first 69 characters are read, so lines may be parsed in place within a larger text.
+ *
+ * @param line1 First line of the set, starting "1 ".
+ * @param line2 Second line of the set, starting "2 ".
+ * @param object Set to the object, without a name, area-to-mass ratio, or lifetime.
+ * @return int 0 on success, -1 if the lines are not a matching element set.
+ */
+int decay_catalog_parse(const char *line1, const char *line2, decay_catalog_object_t *object);
+
+/**
+ * @brief Screens every object of a catalog and writes the ranked results.
+ *
+ * The catalog is memory-mapped where possible and parsed in place in one pass. The objects are then propagated across a worker pool, ranked by re-entry date, and written.
+ *
+ * @param path Catalog file.
+ * @param map_path Optional mass and area map, or NULL: one "CATALOG MASS AREA" line per object, in kilograms and square meters, separated by commas or whitespace; blank lines and lines starting with '#' are skipped.
+ * @param output Destination of the results.
+ * @param options Settings of the screening.
+ * @return int Number of objects in the catalog, or -1 if a file cannot be read or memory runs out.
+ */
+int decay_catalog_run(const char *path, const char *map_path, FILE *output, const decay_catalog_options_t *options);
+
+#endif // DECAY_CATALOG_H
@@ -0,0 +1,147 @@
+/**
+ * @file decay_checkpoint.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Checkpoints of a propagation, from which a later run resumes.
+ *
+ * A set of checkpoints is attached to decay_run(...) through decay_config_t::checkpoints. The run records its state at regular intervals, and a later run with the same satellite and settings resumes from the latest checkpoint whose space weather it would have followed too. When a forecast only changes after some time, re-running a prediction therefore only propagates from the last checkpoint before the change.
+ *
+ * Each checkpoint keeps the time, period, and radius of the state, the eccentricity of an orbit still propagated as elliptical, the adaptive engines' next step size, and a digest of the space weather that led to it (see decay_weather_digest(...)). Resumed runs reproduce the uninterrupted run exactly.
+ *
+ * A set holds at most DECAY_CHECKPOINT_CAPACITY checkpoints. When it is full, every other checkpoint is dropped and the interval doubles, so long lifetimes keep checkpoints spread over the whole propagation.
+ *
+ * Sets are saved in a binary file: a decay_checkpoint_header_t followed by count decay_checkpoint_t records, all native.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef DECAY_CHECKPOINT_H
+#define DECAY_CHECKPOINT_H
+
+#include <stdint.h>
+
+#define DECAY_CHECKPOINT_MAGIC "DCYCHKPT"
+#define DECAY_CHECKPOINT_VERSION 1
+#define DECAY_CHECKPOINT_BYTE_ORDER 0x01020304 // Read back as another value on hosts of the other byte order.
+#define DECAY_CHECKPOINT_INTERVAL (10 * 86400) // Default seconds between checkpoints.
+#define DECAY_CHECKPOINT_CAPACITY 256          // Most checkpoints kept by a set.
+
+/**
+ * @brief State of a propagation at the end of a step.
+ *
+ */
+typedef struct
+{
+    double elapsed_time;   // Seconds since the start of the propagation.
+    double orbital_period; // Seconds; the model period of the semi-major axis while the orbit is elliptical.
+    double orbital_radius; // Meters; the semi-major axis while the orbit is elliptical.
+    double eccentricity;   // Zero once the orbit is propagated as circular.
+    double step;           // Next trial step in seconds of the adaptive engine or of the elliptical propagation.
+    uint64_t weather;      // Digest of the space weather followed up to elapsed_time.
+} decay_checkpoint_t;
+
+/**
+ * @brief Header of a set, and of its binary file.
+ *
+ * The inputs below interval are those of the propagation that recorded the checkpoints; a run with other inputs clears the set.
+ *
+ */
+typedef struct
+{
+    char magic[8];         // DECAY_CHECKPOINT_MAGIC, without a terminator.
+    uint32_t version;      // DECAY_CHECKPOINT_VERSION.
+    uint32_t header_size;  // sizeof(decay_checkpoint_header_t).
+    uint32_t byte_order;   // DECAY_CHECKPOINT_BYTE_ORDER.
+    uint32_t count;        // Number of checkpoints, in increasing order of time.
+    double interval;       // Seconds between checkpoints.
+    int32_t engine;        // decay_config_t::engine.
+    int32_t atmosphere;    // decay_config_t::atmosphere.
+    double satellite_mass; // Kilograms.
+    double satellite_area; // Square meters.
+    double altitude;       // Kilometers.
+    double apogee;         // Kilometers, or 0 for a circular orbit.
+    double tolerance;      // Relative tolerance in effect.
+    double step;           // Seconds per step of the fixed engine, or 0 for the others.
+} decay_checkpoint_header_t;
+
+typedef struct decay_checkpoints decay_checkpoints_t;
+
+/**
+ * @brief Creates an empty set.
+ *
+ * @param interval Seconds between checkpoints; values <= 0 use DECAY_CHECKPOINT_INTERVAL.
+ * @return decay_checkpoints_t* The set, or NULL on allocation failure.
+ */
+decay_checkpoints_t *decay_checkpoints_create(double interval);
+
+/**
+ * @brief Loads a set saved by decay_checkpoints_save(...).
+ *
+ * @param path File to load.
+ * @return decay_checkpoints_t* The set, or NULL if the file is missing (reported only if it exists but cannot be read) or not a checkpoint file for this host.
+ */
+decay_checkpoints_t *decay_checkpoints_open(const char *path);
+
+/**
+ * @brief Writes a set in the binary format.
+ *
+ * @param checkpoints A set.
+ * @param path File to create.
+ * @return int 0 on success, -1 on failure.
+ */
+int decay_checkpoints_save(const decay_checkpoints_t *checkpoints, const char *path);
+
+/**
+ * @brief Releases a set.
+ *
+ * @param checkpoints Set returned by decay_checkpoints_create(...) or decay_checkpoints_open(...); may be NULL.
+ */
+void decay_checkpoints_close(decay_checkpoints_t *checkpoints);
+
+/**
+ * @brief Returns a set's header.
+ *
+ * @param checkpoints A set.
+ * @return const decay_checkpoint_header_t* The header.
+ */
+const decay_checkpoint_header_t *decay_checkpoints_header(const decay_checkpoints_t *checkpoints);
+
+/**
+ * @brief Returns one checkpoint of a set.
+ *
+ * @param checkpoints A set.
+ * @param index From 0 to header->count - 1, earliest first.
+ * @return const decay_checkpoint_t* The checkpoint.
+ */
+const decay_checkpoint_t *decay_checkpoints_get(const decay_checkpoints_t *checkpoints, uint32_t index);
+
+/**
+ * @brief Empties a set and sets the inputs of the propagation that will record into it; used by decay_run(...).
+ *
+ * @param checkpoints A set.
+ * @param inputs Header whose fields from engine on are copied.
+ */
+void decay_checkpoints_reset(decay_checkpoints_t *checkpoints, const decay_checkpoint_header_t *inputs);
+
+/**
+ * @brief Keeps the earliest checkpoints of a set and drops the rest; used by decay_run(...).
+ *
+ * @param checkpoints A set.
+ * @param count Checkpoints kept.
+ * @return double Time in seconds at which the next checkpoint is due.
+ */
+double decay_checkpoints_truncate(decay_checkpoints_t *checkpoints, uint32_t count);
+
+/**
+ * @brief Appends a checkpoint, thinning the set if it is full; used by decay_run(...).
+ *
+ * @param checkpoints A set.
+ * @param checkpoint State later than every checkpoint of the set.
+ * @return double Time in seconds at which the next checkpoint is due.
+ */
+double decay_checkpoints_record(decay_checkpoints_t *checkpoints, const decay_checkpoint_t *checkpoint);
+
+#endif // DECAY_CHECKPOINT_H
@@ -0,0 +1,127 @@
+/**
+ * @file decay_monte_carlo.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Monte Carlo re-entry time uncertainty.
+ *
+ * Samples the uncertain inputs of a re-entry calculation from given distributions, propagates every sample across a worker pool, and summarizes the resulting re-entry times as percentiles and a histogram.
+ *
+ * Every sample draws from its own random stream, derived from the seed and the sample's index, so results are reproducible for a given seed regardless of the thread count or the order in which workers claim samples.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef DECAY_MONTE_CARLO_H
+#define DECAY_MONTE_CARLO_H
+
+#include <stdint.h>
+#include "decay.h"
+
+#define DECAY_MONTE_CARLO_LEVELS 7 // Percentiles reported: 5, 10, 25, 50, 75, 90, and 95.
+#define DECAY_MONTE_CARLO_BINS 20  // Histogram bins spanning the shortest to the longest re-entry time.
+
+/**
+ * @brief Kinds of input distributions.
+ *
+ */
+typedef enum
+{
+    DECAY_DISTRIBUTION_FIXED = 0, // Always a.
+    DECAY_DISTRIBUTION_UNIFORM,   // Uniform on [a, b].
+    DECAY_DISTRIBUTION_NORMAL,    // Normal with mean a and standard deviation b, truncated to non-negative values (positive for the mass and area).
+} decay_distribution_kind_t;
+
+/**
+ * @brief Distribution of one input.
+ *
+ */
+typedef struct
+{
+    decay_distribution_kind_t kind;
+    double a;
+    double b;
+} decay_distribution_t;
+
+/**
+ * @brief Inputs of a Monte Carlo run.
+ *
+ */
+typedef struct
+{
+    decay_distribution_t satellite_mass;      // Kilograms.
+    decay_distribution_t satellite_area;      // Square meters.
+    double altitude;                          // Initial altitude in kilometers.
+    decay_distribution_t solar_radio_flux;    // Average Solar Radio Flux.
+    decay_distribution_t geomagnetic_a_index; // Average Geomagnetic A Index.
+    int samples;                              // Number of samples to propagate.
+    uint64_t seed;                            // Seed of the random streams.
+    decay_engine_t engine;                    // Engine used for every sample.
+    double tolerance;                         // Relative tolerance of the adaptive engine; values <= 0 use ADAPTIVE_TOLERANCE.
+    int threads;                              // Threads to use, including the caller; values < 1 use pool_default_threads().
+    int offset;                               // Index of the first sample, so that a part of a larger run (see decay_shard.h) draws the same streams as the whole; usually 0.
+} decay_monte_carlo_t;
+
+/**
+ * @brief Summary of the re-entry times of a Monte Carlo run.
+ *
+ * Samples that exceed 50 years are ordered after all others, so a percentile falling among them is reported as -1.
+ *
+ */
+typedef struct
+{
+    int samples;                                 // Number of samples summarized.
+    int exceeded;                                // Samples whose lifetime exceeds 50 years.
+    double mean;                                 // Mean re-entry time in seconds of the samples that re-entered.
+    double level[DECAY_MONTE_CARLO_LEVELS];      // Percent levels of percentile[].
+    double percentile[DECAY_MONTE_CARLO_LEVELS]; // Re-entry times in seconds, or -1 if beyond 50 years.
+    double histogram_first;                      // Lower edge of the first histogram bin in seconds.
+    double histogram_width;                      // Width of each histogram bin in seconds.
+    int histogram[DECAY_MONTE_CARLO_BINS];       // Samples that re-entered within each bin.
+} decay_monte_carlo_summary_t;
+
+/**
+ * @brief Parses a distribution: "X" is fixed at X, "X:S" is normal with mean X and standard deviation S, and "L..H" is uniform on [L, H].
+ *
+ * @param text Text to parse.
+ * @param distribution Set to the parsed distribution.
+ * @return int 0 on success, -1 if the text is not a distribution.
+ */
+int decay_distribution_parse(const char *text, decay_distribution_t *distribution);
+
+/**
+ * @brief Samples and propagates every Monte Carlo sample.
+ *
+ * With the fixed engine, samples are propagated in batches by decay_calculate_batch(...). Workers claim batches (or single samples, with the other engines) from a shared atomic counter, so long-lived samples never leave other threads idle while work remains.
+ *
+ * @param config Inputs of the run.
+ * @param lifetimes Set to the re-entry time in seconds of samples config->offset onwards, or -1 if it exceeds 50 years; config->samples long.
+ * @return int 0 on success, -1 on invalid inputs or if a sample rounds outside its input's range.
+ */
+int decay_monte_carlo(const decay_monte_carlo_t *config, double *lifetimes);
+
+/**
+ * @brief First-order estimate of the re-entry time and its standard deviation from a single propagation.
+ *
+ * Propagates the mean inputs with their sensitivities (decay_sensitivity_t) and combines the inputs' standard deviations as if they were independent and the lifetime were linear in each. This costs one run instead of config->samples, but the lifetime is strongly nonlinear in the space weather, so the estimate is only reliable while the deviation is small next to the lifetime; a full run also gives the skew that a deviation cannot. config->samples, seed, and threads are unused.
+ *
+ * @param config Inputs of the run.
+ * @param lifetime Set to the re-entry time in seconds at the mean inputs, or -1.
+ * @param deviation Set to the standard deviation of the re-entry time in seconds, or -1.
+ * @return int 0 on success, -1 on invalid inputs or if the mean inputs do not re-enter within 50 years.
+ */
+int decay_monte_carlo_linearized(const decay_monte_carlo_t *config, double *lifetime, double *deviation);
+
+/**
+ * @brief Computes the percentiles, mean, and histogram of a set of re-entry times.
+ *
+ * @param lifetimes Re-entry times in seconds, or -1 for samples that exceed 50 years.
+ * @param samples Number of re-entry times.
+ * @param summary Set to the summary.
+ * @return int 0 on success, -1 on allocation failure or if there are no samples.
+ */
+int decay_monte_carlo_summarize(const double *lifetimes, int samples, decay_monte_carlo_summary_t *summary);
+
+#endif // DECAY_MONTE_CARLO_H
@@ -0,0 +1,61 @@
+/**
+ * @file decay_report.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Console and CSV print-outs of re-entry calculations.
+ *
+ * The front end of the interactive program. Everything here is built on decay_run(...) and prints to the console or writes data.csv, so none of it is part of libdecay.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef DECAY_REPORT_H
+#define DECAY_REPORT_H
+
+#include <stdbool.h>
+#include "decay.h"
+#include "decay_trajectory.h"
+
+#define REPORT_INTERVAL (7 * 86400) // Seconds between rows of the printed trajectory table; 86400 sec = 1 day.
+
+/**
+ * @brief Trajectory files written by decay_calculate(...) alongside its print-out, one per run.
+ *
+ */
+typedef struct
+{
+    const char *path; // File of the first run; later runs insert _RUN before the extension, e.g. traj_2.bin.
+    decay_trajectory_format_t format;
+    double interval;  // Seconds between rows. The printed table stays weekly; intervals that divide or are multiples of REPORT_INTERVAL sample no more often than the file's rows.
+} decay_report_trajectory_t;
+
+/**
+ * @brief Calculates the amount of time it will take a satellite to descend to below the Karman Line due to air resistance.
+ *
+ * All values should be in meters, seconds, or kilograms.
+ *
+ * @param satellite_mass Mass of the satellite in kilograms.
+ * @param satellite_area Effective windward area of the satellite in square meters.
+ * @param altitude The initial altitude of the satellite above the Earth's surface in kilometers.
+ * @param solar_radio_flux The average Solar Radio Flux during the satellite's lifetime.
+ * @param geomagnetic_a_index The average Geomagnetic A Index during the satellite's lifetime.
+ * @param save_to_csv True - saves the run data in a .csv file; False - Does not.
+ * @param runs Number of times to run the calculation.
+ * @param run_increment Delta-altitude per run (km).
+ * @param engine Integration engine used to propagate each run.
+ * @param tolerance Relative tolerance on the re-entry time; only used by DECAY_ENGINE_ADAPTIVE.
+ * @param threads Number of threads to spread the runs across; 1 prints each run as it finishes, values < 1 use every processor. Output order does not depend on the thread count.
+ * @param single_pass True - derives every run's lifetime from one integration with decay_calculate_sweep(...) and prints only its end points; False - integrates each run separately. Ignored with a space weather history.
+ * @param weather Space weather history used in place of solar_radio_flux and geomagnetic_a_index, or NULL. DECAY_ENGINE_QUADRATURE is replaced by DECAY_ENGINE_ADAPTIVE with a history.
+ * @param trajectory Trajectory files to write, or NULL. Ignored by single-pass sweeps and the quadrature engine, which have no per-run trajectory.
+ * @return int Elapsed time in seconds of the last run before falling below the Karman Line, or -1 if a lifetime exceeds 50 years.
+ */
+int decay_calculate(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, bool save_to_csv, int runs, float run_increment, decay_engine_t engine, double tolerance, int threads, bool single_pass, const decay_weather_t *weather, const decay_report_trajectory_t *trajectory);
+
+// Decay calculate without prints, used by decay_max_avg_activity(...).
+int decay_calculate_suppressed(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index);
+
+#endif // DECAY_REPORT_H
@@ -0,0 +1,125 @@
+/**
+ * @file decay_scenario.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Non-interactive processing of scenario files.
+ *
+ * A scenario file has one satellite per line:
+ *
+ *     MASS AREA ALTITUDE F10.7 AP [MISSION_DAYS] [ttr|srf|geo]
+ *
+ * Fields are separated by commas or whitespace; blank lines and lines starting with '#' are skipped. The mode defaults to ttr (time to re-entry). The srf and geo modes find the maximum average Solar Radio Flux or Geomagnetic A Index that still meets the mission time, and use the given F10.7 or Ap as their starting guess.
+ *
+ * Results are written as CSV, one line per scenario in input order:
+ *
+ *     LINE,MODE,RESULT
+ *
+ * RESULT is the time to re-entry in days, or the maximum average index, or -1 if the lifetime exceeds 50 years or no index meets the mission time. Lines that cannot be parsed are reported with the mode "error" and an empty result.
+ *
+ * A file can be split into shards that run as separate processes (see decay_shard.h). Each shard reads the whole file, runs every N-th scenario, and writes its results to a partial result file whose records are merged into the CSV above.
+ *
+ * With a checkpoint directory, each ttr scenario resumes from and updates the checkpoints of its line, LINE.ckpt (see decay_checkpoint.h). Re-running a file after its space weather history is extended or revised then only propagates each satellite from its last checkpoint before the first changed sample, and a line whose satellite changed starts over.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef DECAY_SCENARIO_H
+#define DECAY_SCENARIO_H
+
+#include <stdio.h>
+#include "decay.h"
+#include "decay_shard.h"
+#include "decay_table.h"
+
+#define DECAY_SCENARIO_CHUNK 4096                 // Scenarios read, run, and written at a time.
+#define DECAY_SCENARIO_COLUMNS "line,mode,result" // First line of the results.
+
+/**
+ * @brief What a scenario calculates.
+ *
+ */
+typedef enum
+{
+    DECAY_SCENARIO_TTR = 0, // Time to re-entry.
+    DECAY_SCENARIO_SRF,     // Maximum average Solar Radio Flux over the mission time.
+    DECAY_SCENARIO_GEO,     // Maximum average Geomagnetic A Index over the mission time.
+    DECAY_SCENARIO_ERROR,   // The line could not be parsed.
+} decay_scenario_mode_t;
+
+/**
+ * @brief One line of a scenario file.
+ *
+ */
+typedef struct
+{
+    int line; // Line number in the file, from 1.
+    decay_scenario_mode_t mode;
+    double satellite_mass;
+    double satellite_area;
+    double altitude;
+    double solar_radio_flux;
+    double geomagnetic_a_index;
+    double mission_time; // Days; required by the srf and geo modes.
+    double cost;         // Estimated relative run time, used to start the longest scenarios first.
+    double result;       // Days to re-entry or the maximum average index, or -1.
+} decay_scenario_t;
+
+/**
+ * @brief Settings shared by every scenario of a file.
+ *
+ */
+typedef struct
+{
+    decay_engine_t engine;
+    double tolerance;               // Relative tolerance of the adaptive engine; values <= 0 use ADAPTIVE_TOLERANCE.
+    int threads;                    // Threads to use, including the caller; values < 1 use pool_default_threads().
+    const decay_weather_t *weather; // Space weather history used by ttr scenarios in place of F10.7 and Ap, or NULL.
+    decay_atmosphere_t atmosphere;  // Density model of ttr scenarios; the solvers need the space weather of the exponential model.
+    const char *checkpoints;        // Existing directory holding a checkpoint file per ttr scenario, named by line number, or NULL.
+    decay_shard_t shard;            // Scenarios run, dealt out in turn by position among the file's scenarios; a count < 2 runs every one.
+    const char *partial;            // Partial result file written in place of the CSV, or NULL.
+    const decay_table_t *table;     // Lifetime table answering the ttr scenarios inside its grid, or NULL; unused with a history or the standard atmosphere.
+} decay_scenario_options_t;
+
+/**
+ * @brief Parses one line of a scenario file.
+ *
+ * @param text The line.
+ * @param line Its line number.
+ * @param scenario Set to the scenario; its mode is DECAY_SCENARIO_ERROR if the line is malformed.
+ * @return int 1 if the line holds a scenario (possibly malformed), 0 if it is blank or a comment.
+ */
+int decay_scenario_parse(const char *text, int line, decay_scenario_t *scenario);
+
+/**
+ * @brief Runs one scenario and sets its result.
+ *
+ * @param scenario A parsed scenario; nothing is run for DECAY_SCENARIO_ERROR, whose result stays -1. A scenario whose orbit the atmosphere model does not cover, e.g. one at or above DECAY_ATMOSPHERE_EXPONENTIAL_CEILING with the exponential model, is set to DECAY_SCENARIO_ERROR rather than reported as exceeding 50 years.
+ * @param options Settings of the run.
+ */
+void decay_scenario_evaluate(decay_scenario_t *scenario, const decay_scenario_options_t *options);
+
+/**
+ * @brief Writes the CSV line of a scenario's result.
+ *
+ * @param output Destination of the line.
+ * @param scenario A scenario that has been run.
+ */
+void decay_scenario_write(FILE *output, const decay_scenario_t *scenario);
+
+/**
+ * @brief Runs every scenario of a file, or of a shard of it, and writes the results.
+ *
+ * Scenarios are read DECAY_SCENARIO_CHUNK at a time. Each chunk is run across a worker pool, longest estimated scenario first so that one long run does not hold up the end of the chunk, and its results are written in input order before the next chunk is read.
+ *
+ * @param input Scenario file.
+ * @param output Destination of the results, unless options->partial is given.
+ * @param options Settings shared by every scenario.
+ * @return int Number of scenarios run, or -1 on allocation failure or if the partial result file cannot be written.
+ */
+int decay_scenario_run(FILE *input, FILE *output, const decay_scenario_options_t *options);
+
+#endif // DECAY_SCENARIO_H
@@ -0,0 +1,88 @@
+/**
+ * @file decay_server.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Long-running query server with a cache of recent results.
+ *
+ * The server reads line-delimited requests from standard input or from the clients of a local Unix socket and answers each with one line:
+ *
+ *     ID MASS AREA ALTITUDE F10.7 AP [MISSION_DAYS] [ttr|srf|geo]   ->   ID,MODE,RESULT
+ *
+ * ID is any token chosen by the client and echoed back; the rest of the request and the response are those of a scenario file (see decay_scenario.h). The commands "stats" (counters as one line of key=value pairs), "quit" (close this connection), and "shutdown" (stop the server) may be sent in place of a request.
+ *
+ * Requests are served in batches: everything available when the server wakes is parsed, answered from the cache where possible, and the remaining distinct requests are run across a worker pool before the responses are written in arrival order. A burst of queries is therefore run in parallel, and repeats within the burst are run once.
+ *
+ * The cache holds the most recently used results, keyed by the request's mode and inputs rounded to a relative precision. The rounded inputs are the ones run, so a result never depends on which of several nearly equal requests arrived first.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef DECAY_SERVER_H
+#define DECAY_SERVER_H
+
+#include <signal.h>
+#include <stdint.h>
+#include "decay_scenario.h"
+
+#define DECAY_SERVER_CACHE 65536     // Default number of cached results.
+#define DECAY_SERVER_QUANTUM 1e-6    // Default relative precision of the cache keys.
+#define DECAY_SERVER_CHUNK 1024      // Most requests served in one batch.
+#define DECAY_SERVER_CLIENTS 64      // Most simultaneous socket clients.
+#define DECAY_SERVER_LATENCY_BINS 32 // Power-of-two microsecond bins of the latency histogram.
+
+/**
+ * @brief Settings of a server.
+ *
+ */
+typedef struct
+{
+    decay_scenario_options_t scenario; // Engine, threads, space weather, and atmosphere of every request.
+    int cache_entries;                 // Results kept; 0 disables the cache and values < 0 use DECAY_SERVER_CACHE.
+    double quantum;                    // Relative precision of the cache keys; values <= 0 use DECAY_SERVER_QUANTUM.
+    volatile sig_atomic_t *stop;       // Optional; a socket server stops as if shut down once *stop is nonzero, so a signal handler may set it.
+} decay_server_options_t;
+
+/**
+ * @brief Counters of a server since it started.
+ *
+ * Requests are counted as their responses are built, in arrival order, so a stats command reports exactly the requests answered before it, including those earlier in its own batch. Latency is measured from the read that completed a request until its response is built, just before the batch is written.
+ *
+ */
+typedef struct
+{
+    uint64_t requests;    // Requests answered, including malformed ones.
+    uint64_t hits;        // Requests answered from the cache or by a repeat within the same batch.
+    uint64_t misses;      // Requests run.
+    uint64_t errors;      // Malformed requests.
+    int entries;          // Results currently cached.
+    double latency_total; // Seconds.
+    double latency_max;   // Seconds.
+    uint64_t latency_histogram[DECAY_SERVER_LATENCY_BINS]; // Requests by latency: bin i holds latencies below 2^i microseconds, and the last bin the rest.
+} decay_server_stats_t;
+
+/**
+ * @brief Serves requests until the input ends or a shutdown command arrives.
+ *
+ * The server installs no signal handlers. A caller serving a socket should ignore SIGPIPE, so that a client that disconnects before its responses are written does not end the process, and may set options->stop from SIGINT and SIGTERM handlers, so that the socket file is removed on the way out; poll(...) is interrupted by the signal, so the flag is seen at once.
+ *
+ * @param path Path of the Unix socket to create (an existing socket file is replaced), or "-" for standard input and output. Sockets are unavailable on Windows.
+ * @param options Settings of the server.
+ * @param stats Optional; set to the counters when the server stops.
+ * @return int 0 when stopped normally, -1 if the socket or the cache cannot be set up.
+ */
+int decay_server_run(const char *path, const decay_server_options_t *options, decay_server_stats_t *stats);
+
+/**
+ * @brief Writes counters as one line of key=value pairs, the response to the stats command.
+ *
+ * @param stats Counters.
+ * @param buffer Destination.
+ * @param size Size of buffer.
+ * @return int Characters written, as snprintf(...).
+ */
+int decay_server_format_stats(const decay_server_stats_t *stats, char *buffer, int size);
+
+#endif // DECAY_SERVER_H
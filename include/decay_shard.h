@@ -0,0 +1,212 @@
+/**
+ * @file decay_shard.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Jobs split across processes, with mergeable partial results.
+ *
+ * A scenario batch, a multi-run sweep, or a Monte Carlo run can be split into N shards, numbered 0 to N - 1, that run as separate processes on one or several machines. Shard i runs its share of the job and writes a partial result file, and decay_shard_merge(...) combines the partial files of every shard into exactly the output of a single-process run.
+ *
+ * Batch scenarios and sweep runs are dealt out in turn, so that expensive neighbours (e.g. the highest runs of a sweep) land on different shards. Monte Carlo samples are identically distributed and each draws from a stream set by its index (see decay_monte_carlo.h), so shard i takes a contiguous block of indices and draws exactly the samples a single run would.
+ *
+ * A partial file is a decay_shard_header_t followed by count decay_shard_record_t records, all native. Records keep every item's result rather than a summary of the shard: percentiles need every value, and the histogram of a run spans its overall shortest to longest re-entry time, so Monte Carlo summaries are computed once, from the merged results. The header's job digest covers the inputs shared by the shards, so partial files of different jobs are not merged.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef DECAY_SHARD_H
+#define DECAY_SHARD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "decay.h"
+#include "decay_monte_carlo.h"
+
+#define DECAY_SHARD_MAGIC "DCYSHARD"
+#define DECAY_SHARD_VERSION 1
+#define DECAY_SHARD_BYTE_ORDER 0x01020304 // Read back as another value on hosts of the other byte order.
+
+/**
+ * @brief One shard of a job.
+ *
+ */
+typedef struct
+{
+    int index; // From 0 to count - 1.
+    int count; // Shards of the job; values < 2 run the whole job.
+} decay_shard_t;
+
+/**
+ * @brief Jobs that can be split into shards.
+ *
+ */
+typedef enum
+{
+    DECAY_SHARD_BATCH = 0,   // Scenario file; see decay_scenario.h.
+    DECAY_SHARD_SWEEP,       // Multi-run altitude sweep.
+    DECAY_SHARD_MONTE_CARLO, // Monte Carlo run.
+} decay_shard_kind_t;
+
+/**
+ * @brief Header of a partial result file.
+ *
+ */
+typedef struct
+{
+    char magic[8];        // DECAY_SHARD_MAGIC, without a terminator.
+    uint32_t version;     // DECAY_SHARD_VERSION.
+    uint32_t header_size; // sizeof(decay_shard_header_t).
+    uint32_t byte_order;  // DECAY_SHARD_BYTE_ORDER.
+    uint32_t kind;        // decay_shard_kind_t.
+    uint32_t index;       // Shard that wrote the file.
+    uint32_t shards;      // Shards of the job.
+    uint64_t job;         // Digest of the inputs of the job; equal in every shard's file.
+    uint32_t total;       // Items of the whole job.
+    uint32_t count;       // Records in this file.
+} decay_shard_header_t;
+
+/**
+ * @brief Result of one item of a job.
+ *
+ */
+typedef struct
+{
+    uint32_t index; // Line number of a scenario, run number of a sweep from 1, or index of a Monte Carlo sample.
+    int32_t mode;   // decay_scenario_mode_t of a scenario; 0 otherwise.
+    double input;   // Initial altitude in kilometers of a sweep run; 0 otherwise.
+    double value;   // Result of a scenario or days to re-entry of a sweep run, as written to the CSV, or seconds to re-entry of a sample; -1 if beyond 50 years.
+} decay_shard_record_t;
+
+typedef struct decay_partial decay_partial_t;
+
+/**
+ * @brief Settings of a multi-run sweep.
+ *
+ * Runs are placed as in decay_calculate(...) and each is propagated separately, since single-pass sweeps share one integration across the runs. The results are written as CSV, one line per run:
+ *
+ *     run,altitude,days
+ *
+ * where days is -1 if the lifetime exceeds 50 years.
+ *
+ */
+typedef struct
+{
+    decay_engine_t engine;
+    double satellite_mass;      // Kilograms.
+    double satellite_area;      // Square meters.
+    double altitude;            // Initial altitude of the first run in kilometers.
+    double solar_radio_flux;    // Average Solar Radio Flux.
+    double geomagnetic_a_index; // Average Geomagnetic A Index.
+    int runs;                   // Number of runs.
+    float run_increment;        // Delta-altitude per run (km).
+    double tolerance;           // Relative tolerance of the adaptive engine; values <= 0 use ADAPTIVE_TOLERANCE.
+    int threads;                // Threads to use, including the caller; values < 1 use pool_default_threads().
+} decay_shard_sweep_t;
+
+/**
+ * @brief Parses a shard written "I/N".
+ *
+ * @param text Text to parse.
+ * @param shard Set to the shard.
+ * @return int 0 on success, -1 unless 0 <= I < N.
+ */
+int decay_shard_parse(const char *text, decay_shard_t *shard);
+
+/**
+ * @brief Whether a shard runs an item of a job whose items are dealt out in turn.
+ *
+ * @param shard A shard.
+ * @param item Position of the item in the job, from 0.
+ * @return bool True if the shard runs the item.
+ */
+static inline bool decay_shard_owns(const decay_shard_t *shard, int item)
+{
+    return shard->count < 2 || item % shard->count == shard->index;
+}
+
+/**
+ * @brief Block of items of a job split into contiguous blocks.
+ *
+ * @param shard A shard.
+ * @param total Items of the whole job.
+ * @param first Set to the first item of the shard.
+ * @param count Set to the number of items of the shard; the first total % shard->count shards take one more.
+ */
+void decay_shard_range(const decay_shard_t *shard, int total, int *first, int *count);
+
+/**
+ * @brief Creates a partial result file.
+ *
+ * @param path File to create.
+ * @param kind Job of the file.
+ * @param shard Shard that writes it.
+ * @return decay_partial_t* The file, or NULL if it cannot be created.
+ */
+decay_partial_t *decay_partial_create(const char *path, decay_shard_kind_t kind, const decay_shard_t *shard);
+
+/**
+ * @brief Appends the result of one item.
+ *
+ * @param partial A file from decay_partial_create(...).
+ * @param record The result.
+ * @return int 0 on success, -1 on a write error.
+ */
+int decay_partial_write(decay_partial_t *partial, const decay_shard_record_t *record);
+
+/**
+ * @brief Completes the header of a partial result file and closes it.
+ *
+ * @param partial A file from decay_partial_create(...); may be NULL.
+ * @param job Digest of the job's inputs.
+ * @param total Items of the whole job.
+ * @return int 0 on success, -1 if a write failed.
+ */
+int decay_partial_close(decay_partial_t *partial, uint64_t job, int total);
+
+/**
+ * @brief Runs the share of a sweep's runs that belongs to a shard.
+ *
+ * The shard's runs are propagated across a worker pool.
+ *
+ * @param sweep Settings of the sweep.
+ * @param shard Shard to run; NULL or a count < 2 runs every run.
+ * @param output Destination of the CSV of the shard's runs, unless partial is given.
+ * @param partial Partial result file to write instead, or NULL.
+ * @return int Number of runs propagated, or -1 on invalid inputs or a file error.
+ */
+int decay_shard_sweep(const decay_shard_sweep_t *sweep, const decay_shard_t *shard, FILE *output, const char *partial);
+
+/**
+ * @brief Runs the block of a Monte Carlo run's samples that belongs to a shard.
+ *
+ * The summary is written as CSV:
+ *
+ *     statistic,days,samples
+ *
+ * with a row "all" of the number of samples, "exceeded" of those beyond 50 years, "mean" of the mean re-entry time of the others and their number, p5 to p95 of the percentiles (-1 beyond 50 years), and one "bin" row per histogram bin with its lower edge and count.
+ *
+ * @param config Inputs of the whole run; its offset must be 0.
+ * @param shard Shard to run; NULL or a count < 2 runs every sample.
+ * @param output Destination of the summary of the shard's samples, unless partial is given.
+ * @param partial Partial result file to write instead, or NULL.
+ * @return int Number of samples propagated, or -1 on invalid inputs, allocation failure, or a file error.
+ */
+int decay_shard_monte_carlo(const decay_monte_carlo_t *config, const decay_shard_t *shard, FILE *output, const char *partial);
+
+/**
+ * @brief Combines the partial result files of every shard of a job.
+ *
+ * The files must come from the same job and cover each of its shards exactly once, in any order. The output is that of the job run as a single shard.
+ *
+ * @param paths Partial result files.
+ * @param count Number of files.
+ * @param output Destination of the combined output.
+ * @return int Number of items of the job, or -1 if a file cannot be read, the files do not make up one whole job, or memory runs out.
+ */
+int decay_shard_merge(const char *const *paths, int count, FILE *output);
+
+#endif // DECAY_SHARD_H
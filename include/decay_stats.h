@@ -0,0 +1,94 @@
+/**
+ * @file decay_stats.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Runtime counters and timers of the re-entry calculations.
+ *
+ * Each propagation counts its steps and model evaluations in a local structure, which costs a few additions per step, and merges them into process-wide totals when it ends. Merging and the timers only run while collection is enabled with decay_stats_enable(...), and building with -DDECAY_NO_STATS removes the counting altogether.
+ *
+ * Time is split between physics, the propagation itself, and I/O: the sample callbacks of decay_run(...), which write trajectories and reports, and the writing of results and trajectory files. Both are summed over threads, so they can exceed the wall time of a parallel job.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef DECAY_STATS_H
+#define DECAY_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief Counters and timers, as totals since the last decay_stats_reset().
+ *
+ * exp and pow count the calls the model makes to the library functions; powers with constant integer exponents are folded by the compiler and not counted. The lockstep kernels of decay_calculate_batch(...) only count their runs and time.
+ *
+ */
+typedef struct
+{
+    uint64_t runs;                // Propagations: decay_run(...) calls, single-pass sweeps, and batched satellites.
+    uint64_t steps;               // Accepted integration steps.
+    uint64_t rejected_steps;      // Adaptive trial steps retried with a smaller step.
+    uint64_t density_evaluations; // Evaluations of the atmospheric density.
+    uint64_t exp_calls;
+    uint64_t pow_calls;
+    uint64_t solves;              // Maximum average activity solves.
+    uint64_t solver_iterations;   // Lifetime runs made by those solves.
+    uint64_t solver_failures;     // Solves without an answer or stopped at SOLVER_MAX_ATTEMPTS.
+    double physics_time;          // Seconds of propagation, excluding I/O.
+    double io_time;               // Seconds in sample callbacks and writing results.
+    long peak_memory;             // Peak resident set size in KiB, or 0 where it is not available.
+} decay_stats_t;
+
+/**
+ * @brief Starts or stops collecting. Collection is off at startup.
+ *
+ * @param enabled Whether to collect; ignored when built with DECAY_NO_STATS.
+ */
+void decay_stats_enable(bool enabled);
+
+/**
+ * @brief Whether counts and times are being collected.
+ *
+ * @return bool true while collecting.
+ */
+bool decay_stats_enabled(void);
+
+/**
+ * @brief Zeroes the totals.
+ *
+ */
+void decay_stats_reset(void);
+
+/**
+ * @brief Copies the totals.
+ *
+ * @param stats Set to the totals and the current peak memory.
+ */
+void decay_stats_get(decay_stats_t *stats);
+
+/**
+ * @brief Adds counts and times to the totals. Used by the instrumented modules; does nothing while collection is off.
+ *
+ * @param delta Amounts to add; peak_memory is ignored.
+ */
+void decay_stats_add(const decay_stats_t *delta);
+
+/**
+ * @brief Monotonic time in seconds for the timers, or 0 while collection is off.
+ *
+ * @return double Seconds from an arbitrary origin.
+ */
+double decay_stats_clock(void);
+
+/**
+ * @brief Writes a summary of the totals.
+ *
+ * @param stream Destination, e.g. stderr.
+ */
+void decay_stats_print(FILE *stream);
+
+#endif // DECAY_STATS_H
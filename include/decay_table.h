@@ -0,0 +1,111 @@
+/**
+ * @file decay_table.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Precomputed lifetime tables.
+ *
+ * A table holds natural logarithms of re-entry times on a regular grid of initial altitude, log area-to-mass ratio, Solar Radio Flux, and Geomagnetic A Index. Queries are answered by multilinear interpolation of the logarithm, which is exact along the area-to-mass axis because the lifetime is inversely proportional to that ratio.
+ *
+ * The file is a fixed-size decay_table_header_t followed immediately by the grid as native doubles, Ap varying fastest and altitude slowest, so it can be memory-mapped and used in place.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef DECAY_TABLE_H
+#define DECAY_TABLE_H
+
+#include <stdint.h>
+#include "decay.h"
+
+#define DECAY_TABLE_MAGIC "DCYTABLE"
+#define DECAY_TABLE_VERSION 1
+#define DECAY_TABLE_BYTE_ORDER 0x01020304 // Read back as another value on hosts of the other byte order.
+#define DECAY_TABLE_AXES 4
+
+/**
+ * @brief Grid axes, in order of storage.
+ *
+ */
+typedef enum
+{
+    DECAY_TABLE_ALTITUDE = 0,  // Initial altitude in kilometers.
+    DECAY_TABLE_AREA_MASS = 1, // Natural logarithm of the area-to-mass ratio in m^2/kg.
+    DECAY_TABLE_SRF = 2,       // Solar Radio Flux (F10.7).
+    DECAY_TABLE_GEO = 3,       // Geomagnetic A Index.
+} decay_table_axis_t;
+
+/**
+ * @brief On-disk header; the grid follows at header_size bytes from the start of the file.
+ *
+ */
+typedef struct
+{
+    char magic[8];                     // DECAY_TABLE_MAGIC, without a terminator.
+    uint32_t version;                  // DECAY_TABLE_VERSION.
+    uint32_t header_size;              // sizeof(decay_table_header_t).
+    uint32_t byte_order;               // DECAY_TABLE_BYTE_ORDER.
+    uint32_t engine;                   // decay_engine_t used to fill the grid.
+    uint32_t count[DECAY_TABLE_AXES];  // Grid points per axis.
+    double first[DECAY_TABLE_AXES];    // First grid point per axis.
+    double last[DECAY_TABLE_AXES];     // Last grid point per axis.
+    double max_error;                  // Largest relative lifetime error measured at cell centers.
+    double rms_error;                  // Root-mean-square relative lifetime error measured at cell centers.
+} decay_table_header_t;
+
+typedef struct decay_table decay_table_t;
+
+/**
+ * @brief Fills a grid by running the given engine at every point and writes it to a file.
+ *
+ * Lifetimes beyond 50 years are stored as well so that interpolation near the limit stays smooth. After filling, the engine is run again at every cell center to measure the interpolation error recorded in the header.
+ *
+ * @param path File to create.
+ * @param count Grid points per axis; each must be at least 2.
+ * @param first First grid point per axis; the altitude must be above the Karman Line.
+ * @param last Last grid point per axis; the altitude must be below DECAY_ATMOSPHERE_EXPONENTIAL_CEILING.
+ * @param engine Engine used to fill the grid. DECAY_ENGINE_FIXED is the physics of decay_calculate_suppressed(...), but a single point near 1000 km takes it minutes; DECAY_ENGINE_QUADRATURE fills the default grid in seconds and agrees with it to better than 1e-4 relative over 300-1000 km, well inside the interpolation error, so tablegen uses it unless told otherwise.
+ * @return int 0 on success, -1 on failure, including a grid point whose lifetime cannot be calculated.
+ */
+int decay_table_generate(const char *path, const uint32_t count[DECAY_TABLE_AXES], const double first[DECAY_TABLE_AXES], const double last[DECAY_TABLE_AXES], decay_engine_t engine);
+
+/**
+ * @brief Maps a table file into memory.
+ *
+ * @param path File created by decay_table_generate(...).
+ * @return decay_table_t* The table, or NULL if the file is missing, truncated, or of another version or byte order, or if an axis has fewer than 2 points.
+ */
+decay_table_t *decay_table_open(const char *path);
+
+/**
+ * @brief Unmaps a table and frees its handle.
+ *
+ * @param table Table returned by decay_table_open(...); may be NULL.
+ */
+void decay_table_close(decay_table_t *table);
+
+/**
+ * @brief Returns the table's header, including its measured interpolation error.
+ *
+ * @param table An open table.
+ * @return const decay_table_header_t* Header within the mapping.
+ */
+const decay_table_header_t *decay_table_header(const decay_table_t *table);
+
+/**
+ * @brief Interpolates the time to re-entry from a table.
+ *
+ * @param table An open table.
+ * @param satellite_mass Mass of the satellite in kilograms.
+ * @param satellite_area Effective windward area of the satellite in square meters.
+ * @param altitude The initial altitude of the satellite above the Earth's surface in kilometers.
+ * @param solar_radio_flux The average Solar Radio Flux during the satellite's lifetime.
+ * @param geomagnetic_a_index The average Geomagnetic A Index during the satellite's lifetime.
+ * @param lifetime Set to the elapsed time in seconds before falling below the Karman Line, or -1 if the lifetime exceeds 50 years.
+ * @return int 0 on success, -1 if the inputs fall outside the grid.
+ */
+int decay_table_lookup(const decay_table_t *table, double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, double *lifetime);
+
+#endif // DECAY_TABLE_H
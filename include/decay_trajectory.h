@@ -0,0 +1,128 @@
+/**
+ * @file decay_trajectory.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Buffered, decimated trajectory output.
+ *
+ * A writer records one row of time, altitude, and period per call, usually as the sample callback of decay_run(...) so that the cadence is the run's sample interval. Rows are collected in large blocks and written in a few big writes rather than one formatted, flushed line per step.
+ *
+ * Two formats are written:
+ * - CSV, one "TIME (s), HEIGHT (km), PERIOD (s)" line per row.
+ * - A binary columnar format: a decay_trajectory_header_t followed by the count times, then the count altitudes, then the count periods, each a packed array of native doubles. A file can be memory-mapped and its columns used in place with decay_trajectory_open(...).
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef DECAY_TRAJECTORY_H
+#define DECAY_TRAJECTORY_H
+
+#include <stdint.h>
+
+#define DECAY_TRAJECTORY_MAGIC "DCYTRAJC"
+#define DECAY_TRAJECTORY_VERSION 1
+#define DECAY_TRAJECTORY_BYTE_ORDER 0x01020304 // Read back as another value on hosts of the other byte order.
+#define DECAY_TRAJECTORY_BLOCK 65536 // Rows collected before they are written out.
+
+/**
+ * @brief Output formats.
+ *
+ */
+typedef enum
+{
+    DECAY_TRAJECTORY_CSV = 0,
+    DECAY_TRAJECTORY_BINARY,
+} decay_trajectory_format_t;
+
+/**
+ * @brief On-disk header of the binary format.
+ *
+ * The header is followed by three arrays of count native doubles: the times in seconds, the altitudes in kilometers, and the periods in seconds.
+ *
+ */
+typedef struct
+{
+    char magic[8];        // DECAY_TRAJECTORY_MAGIC, without a terminator.
+    uint32_t version;     // DECAY_TRAJECTORY_VERSION.
+    uint32_t header_size; // sizeof(decay_trajectory_header_t).
+    uint32_t byte_order;  // DECAY_TRAJECTORY_BYTE_ORDER.
+    uint32_t reserved;
+    uint64_t count;       // Number of rows.
+    double interval;      // Seconds between rows as requested; the last row is the re-entry and may be closer.
+} decay_trajectory_header_t;
+
+typedef struct decay_trajectory_writer decay_trajectory_writer_t;
+typedef struct decay_trajectory decay_trajectory_t;
+
+/**
+ * @brief Creates a trajectory file.
+ *
+ * @param path File to create.
+ * @param format Output format.
+ * @param interval Seconds between rows, recorded in the binary header.
+ * @return decay_trajectory_writer_t* The writer, or NULL on failure.
+ */
+decay_trajectory_writer_t *decay_trajectory_create(const char *path, decay_trajectory_format_t format, double interval);
+
+/**
+ * @brief Records one row.
+ *
+ * @param writer An open writer.
+ * @param elapsed_time Seconds.
+ * @param altitude Kilometers.
+ * @param orbital_period Seconds.
+ * @return int 0 on success, -1 if this or an earlier write failed, after which no further rows are recorded.
+ */
+int decay_trajectory_write(decay_trajectory_writer_t *writer, double elapsed_time, double altitude, double orbital_period);
+
+/**
+ * @brief decay_trajectory_write(...) as a decay_sample_callback_t, with the writer as its context.
+ *
+ * @return int 0 to continue the propagation, or 1 to stop it after a failed write.
+ */
+int decay_trajectory_sample(double elapsed_time, double altitude, double orbital_period, void *writer);
+
+/**
+ * @brief Writes the remaining rows and closes the file.
+ *
+ * @param writer Writer returned by decay_trajectory_create(...); may be NULL.
+ * @return int 0 if every row was written, -1 otherwise.
+ */
+int decay_trajectory_finish(decay_trajectory_writer_t *writer);
+
+/**
+ * @brief Maps a binary trajectory file for reading in place.
+ *
+ * @param path File written in the binary format.
+ * @return decay_trajectory_t* The trajectory, or NULL if the file is missing or not a binary trajectory for this host.
+ */
+decay_trajectory_t *decay_trajectory_open(const char *path);
+
+/**
+ * @brief Releases a trajectory.
+ *
+ * @param trajectory Trajectory returned by decay_trajectory_open(...); may be NULL.
+ */
+void decay_trajectory_close(decay_trajectory_t *trajectory);
+
+/**
+ * @brief Returns a trajectory's header.
+ *
+ * @param trajectory An open trajectory.
+ * @return const decay_trajectory_header_t* The header.
+ */
+const decay_trajectory_header_t *decay_trajectory_header(const decay_trajectory_t *trajectory);
+
+/**
+ * @brief Returns the columns of a trajectory, each holding header->count values.
+ *
+ * @param trajectory An open trajectory.
+ * @param elapsed_time Set to the times in seconds; may be NULL.
+ * @param altitude Set to the altitudes in kilometers; may be NULL.
+ * @param orbital_period Set to the periods in seconds; may be NULL.
+ */
+void decay_trajectory_columns(const decay_trajectory_t *trajectory, const double **elapsed_time, const double **altitude, const double **orbital_period);
+
+#endif // DECAY_TRAJECTORY_H
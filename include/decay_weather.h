@@ -0,0 +1,108 @@
+/**
+ * @file decay_weather.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Time-varying space weather from an F10.7 and Ap history.
+ *
+ * A history is a series of Solar Radio Flux and Geomagnetic A Index values at a constant interval, e.g. daily or 3-hourly, each holding until the next. It is read either from a CSV file or from a compact binary file that is memory-mapped and used in place. Both hold the numerator of the scale height term for every sample, precomputed, so that the propagation loops only need an index computation per step.
+ *
+ * CSV files have one sample per line as TIME, F10.7, AP. TIME is either a number of days since the start of the propagation, or an ISO 8601 date (YYYY-MM-DD, optionally followed by Thh:mm) in which case the first sample is the start. Lines that do not start with a digit or a sign, such as headers and comments, are skipped.
+ *
+ * Before its first sample a history holds the first sample's values, and after its last sample it holds the last sample's values.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef DECAY_WEATHER_H
+#define DECAY_WEATHER_H
+
+#include <stdint.h>
+
+#define DECAY_WEATHER_MAGIC "DCYWTHER"
+#define DECAY_WEATHER_VERSION 1
+#define DECAY_WEATHER_BYTE_ORDER 0x01020304 // Read back as another value on hosts of the other byte order.
+
+/**
+ * @brief On-disk header of the binary format.
+ *
+ * The header is followed by three arrays of count native doubles: the scale height numerators, the Solar Radio Flux values, and the Geomagnetic A Index values.
+ *
+ */
+typedef struct
+{
+    char magic[8];        // DECAY_WEATHER_MAGIC, without a terminator.
+    uint32_t version;     // DECAY_WEATHER_VERSION.
+    uint32_t header_size; // sizeof(decay_weather_header_t).
+    uint32_t byte_order;  // DECAY_WEATHER_BYTE_ORDER.
+    uint32_t count;       // Number of samples.
+    double start;         // Time of the first sample in seconds since the start of the propagation.
+    double interval;      // Seconds between samples.
+} decay_weather_header_t;
+
+typedef struct decay_weather decay_weather_t;
+
+/**
+ * @brief Loads a history from a binary file (memory-mapped) or a CSV file (parsed once).
+ *
+ * @param path File to load; the format is detected from its first bytes.
+ * @return decay_weather_t* The history, or NULL if the file is missing, malformed, or its samples are not evenly spaced.
+ */
+decay_weather_t *decay_weather_open(const char *path);
+
+/**
+ * @brief Writes a history in the binary format.
+ *
+ * @param weather An open history.
+ * @param path File to create.
+ * @return int 0 on success, -1 on failure.
+ */
+int decay_weather_save(const decay_weather_t *weather, const char *path);
+
+/**
+ * @brief Releases a history.
+ *
+ * @param weather History returned by decay_weather_open(...); may be NULL.
+ */
+void decay_weather_close(decay_weather_t *weather);
+
+/**
+ * @brief Returns a history's header.
+ *
+ * @param weather An open history.
+ * @return const decay_weather_header_t* The header.
+ */
+const decay_weather_header_t *decay_weather_header(const decay_weather_t *weather);
+
+/**
+ * @brief Numerator of the scale height term in effect at a time.
+ *
+ * @param weather An open history.
+ * @param time Seconds since the start of the propagation.
+ * @return double 900 + 2.5 (F10.7 - 70) + 1.5 Ap of the sample in effect.
+ */
+double decay_weather_sh_numerator(const decay_weather_t *weather, double time);
+
+/**
+ * @brief Time at which the sample in effect at a time is replaced by the next one.
+ *
+ * @param weather An open history.
+ * @param time Seconds since the start of the propagation.
+ * @return double Seconds since the start of the propagation, or INFINITY after the last sample.
+ */
+double decay_weather_next_change(const decay_weather_t *weather, double time);
+
+/**
+ * @brief Digest of the space weather up to a time, with which decay_run(...) checks that a checkpoint can be resumed under another history.
+ *
+ * The digest covers the start and interval of the sample grid and the scale height numerators of every sample up to the one in effect at the time, which together decide a propagation up to then. Histories that agree on these give equal digests, whatever their later samples.
+ *
+ * @param weather An open history.
+ * @param time Seconds since the start of the propagation.
+ * @return uint64_t FNV-1a digest, computed when the history was loaded.
+ */
+uint64_t decay_weather_digest(const decay_weather_t *weather, double time);
+
+#endif // DECAY_WEATHER_H
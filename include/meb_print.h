@@ -81,55 +81,101 @@
 #endif // MEB_CODES
 #endif // defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
 
+/**
+ * @brief Output backend of the print macros.
+ *
+ * By default every macro formats straight into stdio and flushes. Defining MEB_ASYNC routes them instead through per-thread ring buffers drained by a background thread (see src/meb_print.c), and lets the levels enabled by MEB_DBGLVL be narrowed at runtime with meb_log_set_levels(...). Messages from one thread keep their order; messages from different threads may interleave at message granularity.
+ *
+ */
+#ifdef MEB_ASYNC
+#define MEB_ENABLED(level) ((MEB_DBGLVL & (level)) && (meb_log_levels() & (level)))
+#define MEB_FPRINTF(stream, format, ...) meb_log_printf(stream, format, ##__VA_ARGS__)
+#define MEB_FFLUSH(stream)
+#else
+#define MEB_ENABLED(level) (MEB_DBGLVL & (level))
+#define MEB_FPRINTF(stream, format, ...) fprintf(stream, format, ##__VA_ARGS__)
+#define MEB_FFLUSH(stream) fflush(stream)
+#endif // MEB_ASYNC
+
+#ifdef MEB_ASYNC
+/**
+ * @brief Queues a formatted message for the background writer, starting it on first use.
+ *
+ * @param stream stdout or stderr.
+ * @param format printf format.
+ * @return int Number of characters queued, or a negative value on error.
+ */
+int meb_log_printf(FILE *stream, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Writes every queued message and flushes stdout and stderr, e.g. before reading input.
+ *
+ */
+void meb_log_flush(void);
+
+/**
+ * @brief Levels currently enabled, a mask of MEB_DBG_* values; MEB_DBG_ALL until changed.
+ *
+ */
+int meb_log_levels(void);
+
+/**
+ * @brief Changes the levels enabled at runtime. Levels compiled out by MEB_DBGLVL stay off.
+ *
+ * @param levels Mask of MEB_DBG_* values.
+ */
+void meb_log_set_levels(int levels);
+#endif // MEB_ASYNC
+
 #ifndef dbprintlf
-#define dbprintlf(format, ...)                                                                                    \
-    {                                                                                                             \
-        if (MEB_DBGLVL & MEB_DBG_DBPRINT)                                                                         \
-        {                                                                                                         \
-            fprintf(stderr, "[%s:%d | %s] " format TERMINATOR "\n", __FILE__, __LINE__, __func__, ##__VA_ARGS__); \
-            fflush(stderr);                                                                                       \
-        }                                                                                                         \
+#define dbprintlf(format, ...)                                                                                        \
+    {                                                                                                                 \
+        if (MEB_ENABLED(MEB_DBG_DBPRINT))                                                                             \
+        {                                                                                                             \
+            MEB_FPRINTF(stderr, "[%s:%d | %s] " format TERMINATOR "\n", __FILE__, __LINE__, __func__, ##__VA_ARGS__); \
+            MEB_FFLUSH(stderr);                                                                                       \
+        }                                                                                                             \
     }
 #endif // dbprintlf
 
 #ifndef dbprintf
-#define dbprintf(format, ...)                                                                                \
-    {                                                                                                        \
-        if (MEB_DBGLVL & MEB_DBG_DBPRINT)                                                                    \
-        {                                                                                                    \
-            fprintf(stderr, "[%s:%d | %s] " format TERMINATOR, __FILE__, __LINE__, __func__, ##__VA_ARGS__); \
-            fflush(stderr);                                                                                  \
-        }                                                                                                    \
+#define dbprintf(format, ...)                                                                                    \
+    {                                                                                                            \
+        if (MEB_ENABLED(MEB_DBG_DBPRINT))                                                                        \
+        {                                                                                                        \
+            MEB_FPRINTF(stderr, "[%s:%d | %s] " format TERMINATOR, __FILE__, __LINE__, __func__, ##__VA_ARGS__); \
+            MEB_FFLUSH(stderr);                                                                                  \
+        }                                                                                                        \
     }
 #endif // dbprintf
 
 #if !defined(_MSC_VER)
 
 #ifndef bprintf
-#define bprintf(str, ...)                                        \
-    (                                                            \
-        {                                                        \
-            int _meb_rc = 0;                                     \
-            if (MEB_DBGLVL & MEB_DBG_BPRINT)                     \
-            {                                                    \
-                _meb_rc = printf(str TERMINATOR, ##__VA_ARGS__); \
-                fflush(stdout);                                  \
-            }                                                    \
-            _meb_rc;                                             \
+#define bprintf(str, ...)                                                     \
+    (                                                                         \
+        {                                                                     \
+            int _meb_rc = 0;                                                  \
+            if (MEB_ENABLED(MEB_DBG_BPRINT))                                  \
+            {                                                                 \
+                _meb_rc = MEB_FPRINTF(stdout, str TERMINATOR, ##__VA_ARGS__); \
+                MEB_FFLUSH(stdout);                                           \
+            }                                                                 \
+            _meb_rc;                                                          \
         })
 #endif // bprintf
 
 #ifndef bprintlf
-#define bprintlf(str, ...)                                             \
-    (                                                                  \
-        {                                                              \
-            int _meb_rc = 0;                                           \
-            if (MEB_DBGLVL & MEB_DBG_BPRINT)                           \
-            {                                                          \
-                _meb_rc = printf(str TERMINATOR " \n", ##__VA_ARGS__); \
-                fflush(stdout);                                        \
-            }                                                          \
-            _meb_rc;                                                   \
+#define bprintlf(str, ...)                                                          \
+    (                                                                               \
+        {                                                                           \
+            int _meb_rc = 0;                                                        \
+            if (MEB_ENABLED(MEB_DBG_BPRINT))                                        \
+            {                                                                       \
+                _meb_rc = MEB_FPRINTF(stdout, str TERMINATOR " \n", ##__VA_ARGS__); \
+                MEB_FFLUSH(stdout);                                                 \
+            }                                                                       \
+            _meb_rc;                                                                \
         })
 #endif // bprintlf
 
@@ -164,37 +210,48 @@
 #endif // _MSC_VER
 
 #ifndef erprintlf
-#define erprintlf(error)                                                                            \
-    {                                                                                               \
-        if (MEB_DBGLVL & MEB_DBG_ERPRINT)                                                           \
-        {                                                                                           \
-            fprintf(stderr, "[%s:%d | %s] " RED_FG "ERRNO >>> %d:" RESET_ALL " %s" TERMINATOR "\n", \
-                    __FILE__, __LINE__, __func__, error, strerror(error));                          \
-            fflush(stderr);                                                                         \
-        }                                                                                           \
+#define erprintlf(error)                                                                                \
+    {                                                                                                   \
+        if (MEB_ENABLED(MEB_DBG_ERPRINT))                                                               \
+        {                                                                                               \
+            MEB_FPRINTF(stderr, "[%s:%d | %s] " RED_FG "ERRNO >>> %d:" RESET_ALL " %s" TERMINATOR "\n", \
+                        __FILE__, __LINE__, __func__, error, strerror(error));                          \
+            MEB_FFLUSH(stderr);                                                                         \
+        }                                                                                               \
     }
 #endif // erprintlf
 
+// Formats the time only when the second changes; the buffer is per thread.
 static inline char *get_time_now()
 {
     static __thread char buf[128];
+    static __thread time_t last = -1;
     time_t t = time(NULL);
-    struct tm tm = *localtime(&t);
-    snprintf(buf, sizeof(buf), YELLOW_FG "[" YELLOW_FG "%02d:%02d:%02d" YELLOW_FG "] " TERMINATOR,
-             tm.tm_hour, tm.tm_min, tm.tm_sec);
+    if (t != last)
+    {
+        struct tm tm;
+#ifdef OS_Windows
+        tm = *localtime(&t);
+#else
+        localtime_r(&t, &tm);
+#endif
+        snprintf(buf, sizeof(buf), YELLOW_FG "[" YELLOW_FG "%02d:%02d:%02d" YELLOW_FG "] " TERMINATOR,
+                 tm.tm_hour, tm.tm_min, tm.tm_sec);
+        last = t;
+    }
     return buf;
 }
 
 #ifndef tprintf
-#define tprintf(str, ...)                                               \
-    {                                                                   \
-        if (MEB_DBGLVL & MEB_DBG_TPRINT)                                \
-        {                                                               \
-            printf("%s" str TERMINATOR, get_time_now(), ##__VA_ARGS__); \
-            fflush(stdout);                                             \
-        }                                                               \
+#define tprintf(str, ...)                                                            \
+    {                                                                                \
+        if (MEB_ENABLED(MEB_DBG_TPRINT))                                             \
+        {                                                                            \
+            MEB_FPRINTF(stdout, "%s" str TERMINATOR, get_time_now(), ##__VA_ARGS__); \
+            MEB_FFLUSH(stdout);                                                      \
+        }                                                                            \
     }
-#endif
+#endif // tprintf
 
 #ifndef tprintlf
 #define tprintlf(str, ...) \
@@ -0,0 +1,61 @@
+/**
+ * @file pool.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Minimal worker pool for independent jobs.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+/**
+ * @brief A job run by the pool; index is in [0, count).
+ *
+ */
+typedef void (*pool_job_t)(int index, void *context);
+
+/**
+ * @brief Runs job(index, context) for every index in [0, count) across a number of threads and waits for all of them.
+ *
+ * Workers claim the next unstarted index with an atomic counter, so long jobs never leave other workers idle while work remains. Indices are started in increasing order.
+ *
+ * @param count Number of jobs.
+ * @param threads Number of threads to use, including the caller; values < 1 use pool_default_threads().
+ * @param job Function run once per index.
+ * @param context Passed to every job.
+ * @return int 0 on success, -1 if no worker threads could be started (all jobs then run on the caller).
+ */
+int pool_run(int count, int threads, pool_job_t job, void *context);
+
+/**
+ * @brief Estimated cost of one job, for pool_order(...).
+ *
+ */
+typedef struct
+{
+    double cost; // Relative run time.
+    int index;   // The caller's index of the job.
+} pool_order_t;
+
+/**
+ * @brief Sorts jobs by decreasing cost, then by increasing index.
+ *
+ * pool_run(...) starts indices in increasing order, so running order[i].index as job i starts the most expensive jobs first, and one long job started last does not hold up the end of the run.
+ *
+ * @param order Jobs to sort.
+ * @param count Number of jobs.
+ */
+void pool_order(pool_order_t *order, int count);
+
+/**
+ * @brief Number of online processors, or 1 if it cannot be determined.
+ *
+ * @return int Default thread count.
+ */
+int pool_default_threads(void);
+
+#endif // POOL_H
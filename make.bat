@@ -1,8 +1,17 @@
 @ECHO OFF
 SET CC=gcc
-SET COBJS=src/decay.c src/ui.c
-SET EDCFLAGS=-I ./include/ -Wall %CFLAGS%
+SET COBJS=src/buffer.c src/decay.c src/decay_atmosphere.c src/decay_checkpoint.c src/decay_batch.c src/decay_catalog.c src/decay_file.c src/decay_monte_carlo.c src/decay_report.c src/decay_scenario.c src/decay_server.c src/decay_shard.c src/decay_stats.c src/decay_table.c src/decay_trajectory.c src/decay_weather.c src/meb_print.c src/pool.c src/ui.c
+SET EDCFLAGS=-I ./include/ -Wall -pthread %CFLAGS%
 SET EDLDFLAGS=%LDFLAGS%
 SET TARGET=decay.exe
+SET TABLEOBJS=src/decay.c src/decay_atmosphere.c src/decay_checkpoint.c src/decay_file.c src/decay_stats.c src/decay_table.c src/decay_weather.c src/meb_print.c src/pool.c src/tablegen.c
+SET TABLEGEN=tablegen.exe
+SET TABLE=lifetime.dlt
 
-CMD /c "%CC% %EDCFLAGS% %COBJS% -o %TARGET% %EDLDFLAGS%"
\ No newline at end of file
+CMD /c "%CC% %EDCFLAGS% %COBJS% -o %TARGET% %EDLDFLAGS%"
+
+REM make.bat table: builds the table generator and writes the lifetime table, as make table does.
+IF "%1"=="table" (
+    CMD /c "%CC% %EDCFLAGS% %TABLEOBJS% -o %TABLEGEN% %EDLDFLAGS%"
+    %TABLEGEN% %TABLE%
+)
\ No newline at end of file
@@ -0,0 +1,71 @@
+#!/bin/sh
+# Splits a batch, a sweep, and a Monte Carlo job into shards run as separate processes, merges their partial
+# files, and checks that each merged output matches a single-process run byte for byte.
+#
+# Usage: ./shard_check.sh [DECAY] [SHARDS]; DECAY defaults to ./decay.out and SHARDS to 3.
+
+DECAY=${1:-./decay.out}
+SHARDS=${2:-3}
+DIR=$(mktemp -d) || exit 1
+trap 'rm -rf "$DIR"' EXIT
+
+# A mix of modes, space weather, and lifetimes, including one beyond 50 years and one malformed line.
+cat > "$DIR/scenarios.txt" << EOF
+# MASS AREA ALTITUDE F10.7 AP [MISSION_DAYS] [MODE]
+10 0.1 400 150 15
+4 0.05 300 70 5
+10 0.1 350 250 30
+2000 1 800 70 5
+10 0.1 400 150 15 180 srf
+10 0.1 400 150 15 180 geo
+1 0.01 250 120 10
+not a scenario
+20 0.2 450 180 20
+10 0.1 380 100 8
+EOF
+
+BATCH="--batch $DIR/scenarios.txt --engine 2"
+SWEEP="--sweep 11 --mass 10 --area 0.1 --altitude 300 --increment 15 --srf 150 --geo 15 --engine 2"
+MONTE_CARLO="--monte-carlo 500 --mass 10:1 --area 0.08..0.12 --altitude 350 --srf 150:30 --geo 15:5 --seed 7 --engine 2"
+
+failures=0
+
+# check NAME OPTIONS: runs the job whole and in $SHARDS concurrent shards, then compares the outputs.
+check()
+{
+    name=$1
+    shift
+
+    $DECAY "$@" --output "$DIR/$name.whole.csv" > /dev/null || { echo "FAIL: $name: the single-process run failed."; failures=$((failures + 1)); return; }
+
+    i=0
+    pids=""
+    while [ $i -lt "$SHARDS" ]; do
+        $DECAY "$@" --threads 1 --shard $i/"$SHARDS" --partial "$DIR/$name.$i.part" > /dev/null &
+        pids="$pids $!"
+        i=$((i + 1))
+    done
+
+    status=0
+    for pid in $pids; do
+        wait "$pid" || status=1
+    done
+
+    if [ $status -ne 0 ] || ! $DECAY --merge "$DIR/$name".*.part --output "$DIR/$name.merged.csv" > /dev/null; then
+        echo "FAIL: $name: a shard or the merge failed."
+        failures=$((failures + 1))
+    elif ! cmp -s "$DIR/$name.whole.csv" "$DIR/$name.merged.csv"; then
+        echo "FAIL: $name: the merged output differs from the single-process run."
+        diff "$DIR/$name.whole.csv" "$DIR/$name.merged.csv" | head -n 10
+        failures=$((failures + 1))
+    else
+        echo "PASS: $name in $SHARDS shards matches the single-process run ($(wc -l < "$DIR/$name.whole.csv") lines)."
+    fi
+}
+
+check batch $BATCH
+check sweep $SWEEP
+check monte-carlo $MONTE_CARLO
+
+echo "$failures of 3 sharded jobs differ."
+[ $failures -eq 0 ]
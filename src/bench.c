@@ -0,0 +1,290 @@
+/**
+ * @file bench.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Benchmarks the re-entry calculations and prints the results as JSON.
+ *
+ * Every case is run a number of times after untimed warm-up runs, and the mean, variance, and extremes of the wall time per run are reported together with the derived ns/step and lifetimes/s. Cases cover low, mid, and high orbits at solar minimum and maximum, a mid orbit in the tabulated standard atmosphere, lifetimes close to the 50 year limit, the inverse solvers, and multi-run sweeps, each with every engine.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "meb_print.h"
+#include "decay.h"
+#include "decay_batch.h"
+
+#define BENCH_WARMUP 1
+#define BENCH_REPETITIONS 5
+#define BENCH_SWEEP_RUNS 10
+#define BENCH_BATCH 256
+
+/**
+ * @brief Kinds of benchmarked calculations.
+ *
+ */
+typedef enum
+{
+    BENCH_LIFETIME = 0, // One decay_run(...), as decay_calculate_suppressed(...) with the fixed engine.
+    BENCH_SOLVER_SRF,   // decay_max_avg_srf_suppressed(...).
+    BENCH_SOLVER_GEO,   // decay_max_avg_geo_suppressed(...).
+    BENCH_SWEEP,        // BENCH_SWEEP_RUNS separate runs of a sweep.
+    BENCH_SWEEP_SINGLE, // The same sweep with decay_calculate_sweep(...).
+    BENCH_BATCH_FIXED,  // BENCH_BATCH lifetimes with decay_calculate_batch(...).
+} bench_kind_t;
+
+/**
+ * @brief One benchmark case.
+ *
+ */
+typedef struct
+{
+    const char *name;
+    bench_kind_t kind;
+    double altitude; // Kilometers; the first run of sweeps.
+    double solar_radio_flux;
+    double geomagnetic_a_index;
+    double mission_time; // Days (solvers only).
+    decay_atmosphere_t atmosphere; // Density model (lifetimes only).
+    double apogee; // Kilometers, for an elliptical orbit with altitude as its perigee (lifetimes only).
+} bench_case_t;
+
+/**
+ * @brief Work done by one run of a case, identical on every repetition.
+ *
+ */
+typedef struct
+{
+    long steps;      // Integration steps, 0 where they are not counted.
+    int lifetimes;   // Lifetimes calculated.
+    double result;   // Lifetime in days, or the solver's answer; -1 beyond 50 years or without an answer.
+} bench_work_t;
+
+static const char *bench_engines[] = {"fixed", "adaptive", "quadrature"};
+static const char *bench_atmospheres[] = {"exponential", "standard"};
+
+#define BENCH_MASS 10   // Kilograms.
+#define BENCH_AREA 0.1  // Square meters.
+#define BENCH_SWEEP_INCREMENT 25 // Kilometers.
+
+static const bench_case_t bench_cases[] = {
+    {.name = "low_solar_min", .kind = BENCH_LIFETIME, .altitude = 250, .solar_radio_flux = 70, .geomagnetic_a_index = 5},
+    {.name = "low_solar_max", .kind = BENCH_LIFETIME, .altitude = 250, .solar_radio_flux = 250, .geomagnetic_a_index = 30},
+    {.name = "mid_solar_min", .kind = BENCH_LIFETIME, .altitude = 400, .solar_radio_flux = 70, .geomagnetic_a_index = 5},
+    {.name = "mid_solar_max", .kind = BENCH_LIFETIME, .altitude = 400, .solar_radio_flux = 250, .geomagnetic_a_index = 30},
+    {.name = "high_solar_max", .kind = BENCH_LIFETIME, .altitude = 600, .solar_radio_flux = 250, .geomagnetic_a_index = 30},
+    {.name = "long_solar_min", .kind = BENCH_LIFETIME, .altitude = 540, .solar_radio_flux = 70, .geomagnetic_a_index = 5},
+    {.name = "long_solar_max", .kind = BENCH_LIFETIME, .altitude = 760, .solar_radio_flux = 250, .geomagnetic_a_index = 30},
+    {.name = "mid_standard", .kind = BENCH_LIFETIME, .altitude = 400, .solar_radio_flux = 0, .geomagnetic_a_index = 0, .atmosphere = DECAY_ATMOSPHERE_STANDARD},
+    {.name = "elliptical_leo", .kind = BENCH_LIFETIME, .altitude = 250, .solar_radio_flux = 150, .geomagnetic_a_index = 15, .atmosphere = DECAY_ATMOSPHERE_EXPONENTIAL, .apogee = 900},
+    {.name = "elliptical_gto", .kind = BENCH_LIFETIME, .altitude = 200, .solar_radio_flux = 0, .geomagnetic_a_index = 0, .atmosphere = DECAY_ATMOSPHERE_STANDARD, .apogee = 35786},
+    {.name = "solver_srf", .kind = BENCH_SOLVER_SRF, .altitude = 350, .solar_radio_flux = 0, .geomagnetic_a_index = 15, .mission_time = 60},
+    {.name = "solver_geo", .kind = BENCH_SOLVER_GEO, .altitude = 350, .solar_radio_flux = 150, .geomagnetic_a_index = 0, .mission_time = 60},
+    {.name = "sweep_runs", .kind = BENCH_SWEEP, .altitude = 300, .solar_radio_flux = 150, .geomagnetic_a_index = 15},
+    {.name = "sweep_single_pass", .kind = BENCH_SWEEP_SINGLE, .altitude = 300, .solar_radio_flux = 150, .geomagnetic_a_index = 15},
+    {.name = "batch", .kind = BENCH_BATCH_FIXED, .altitude = 300, .solar_radio_flux = 150, .geomagnetic_a_index = 15},
+};
+
+static double bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bench_work_t bench_run(const bench_case_t *bench, decay_engine_t engine)
+{
+    bench_work_t work = {0, 1, -1};
+    double lifetimes[BENCH_BATCH > BENCH_SWEEP_RUNS ? BENCH_BATCH : BENCH_SWEEP_RUNS];
+
+    switch (bench->kind)
+    {
+    case BENCH_LIFETIME:
+    {
+        decay_config_t config = {
+            .engine = engine,
+            .satellite_mass = BENCH_MASS,
+            .satellite_area = BENCH_AREA,
+            .altitude = bench->altitude,
+            .solar_radio_flux = bench->solar_radio_flux,
+            .geomagnetic_a_index = bench->geomagnetic_a_index,
+            .atmosphere = bench->atmosphere,
+            .apogee = bench->apogee,
+        };
+        decay_result_t result;
+        decay_run(&config, &result);
+        work.steps = result.steps;
+        work.result = result.lifetime < 0 ? -1 : result.lifetime / 86400;
+        break;
+    }
+    case BENCH_SOLVER_SRF:
+        work.result = decay_max_avg_srf_suppressed(BENCH_MASS, BENCH_AREA, bench->altitude, bench->geomagnetic_a_index, bench->mission_time, engine, 0, SOLVER_TOLERANCE);
+        break;
+    case BENCH_SOLVER_GEO:
+        work.result = decay_max_avg_geo_suppressed(BENCH_MASS, BENCH_AREA, bench->altitude, bench->solar_radio_flux, bench->mission_time, engine, 0, SOLVER_TOLERANCE);
+        break;
+    case BENCH_SWEEP:
+        for (int run = 0; run < BENCH_SWEEP_RUNS; run++)
+        {
+            decay_config_t config = {
+                .engine = engine,
+                .satellite_mass = BENCH_MASS,
+                .satellite_area = BENCH_AREA,
+                .altitude = decay_sweep_altitude(bench->altitude, BENCH_SWEEP_INCREMENT, run + 1),
+                .solar_radio_flux = bench->solar_radio_flux,
+                .geomagnetic_a_index = bench->geomagnetic_a_index,
+            };
+            decay_result_t result;
+            decay_run(&config, &result);
+            work.steps += result.steps;
+            lifetimes[run] = result.lifetime;
+        }
+        work.lifetimes = BENCH_SWEEP_RUNS;
+        work.result = lifetimes[BENCH_SWEEP_RUNS - 1] < 0 ? -1 : lifetimes[BENCH_SWEEP_RUNS - 1] / 86400;
+        break;
+    case BENCH_SWEEP_SINGLE:
+        decay_calculate_sweep(engine, BENCH_MASS, BENCH_AREA, bench->altitude, bench->solar_radio_flux, bench->geomagnetic_a_index, BENCH_SWEEP_RUNS, BENCH_SWEEP_INCREMENT, 0, lifetimes);
+        work.lifetimes = BENCH_SWEEP_RUNS;
+        work.result = lifetimes[BENCH_SWEEP_RUNS - 1] < 0 ? -1 : lifetimes[BENCH_SWEEP_RUNS - 1] / 86400;
+        break;
+    case BENCH_BATCH_FIXED:
+    {
+        double mass[BENCH_BATCH], area[BENCH_BATCH], altitude[BENCH_BATCH], srf[BENCH_BATCH], geo[BENCH_BATCH];
+        for (int i = 0; i < BENCH_BATCH; i++)
+        {
+            mass[i] = BENCH_MASS * (1 + 0.002 * i);
+            area[i] = BENCH_AREA;
+            altitude[i] = bench->altitude;
+            srf[i] = bench->solar_radio_flux;
+            geo[i] = bench->geomagnetic_a_index;
+        }
+        decay_calculate_batch(BENCH_BATCH, mass, area, altitude, srf, geo, lifetimes, DECAY_BATCH_AUTO);
+        work.lifetimes = BENCH_BATCH;
+        work.result = lifetimes[0] < 0 ? -1 : lifetimes[0] / 86400;
+        break;
+    }
+    }
+
+    return work;
+}
+
+static int bench_compare(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char *argv[])
+{
+    int warmup = BENCH_WARMUP;
+    int repetitions = BENCH_REPETITIONS;
+    const char *filter = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--warmup") && i + 1 < argc)
+        {
+            warmup = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--repetitions") && i + 1 < argc)
+        {
+            repetitions = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--filter") && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else
+        {
+            bprintlf("Usage: %s [--warmup N] [--repetitions N] [--filter SUBSTRING]", argv[0]);
+            return 1;
+        }
+    }
+
+    if (warmup < 0 || repetitions < 1)
+    {
+        bprintlf(RED_FG "ERROR: At least one repetition is required.");
+        return 1;
+    }
+
+    double *times = malloc(repetitions * sizeof(double));
+    if (times == NULL)
+    {
+        return 1;
+    }
+
+    // Plain printf: the output is JSON, without the terminal escape codes of bprintf.
+    printf("{\n  \"benchmark\": \"orbital_decay\",\n  \"warmup\": %d,\n  \"repetitions\": %d,\n  \"batch_isa\": %d,\n  \"results\": [", warmup, repetitions, decay_batch_isa());
+
+    bool first = true;
+    for (size_t c = 0; c < sizeof(bench_cases) / sizeof(bench_cases[0]); c++)
+    {
+        const bench_case_t *bench = &bench_cases[c];
+        for (decay_engine_t engine = DECAY_ENGINE_FIXED; engine <= DECAY_ENGINE_QUADRATURE; engine++)
+        {
+            // The batch kernels only implement the fixed engine.
+            if ((bench->kind == BENCH_BATCH_FIXED && engine != DECAY_ENGINE_FIXED) || (filter != NULL && strstr(bench->name, filter) == NULL))
+            {
+                continue;
+            }
+
+            bench_work_t work = {0};
+            for (int i = 0; i < warmup; i++)
+            {
+                work = bench_run(bench, engine);
+            }
+
+            double mean = 0;
+            for (int i = 0; i < repetitions; i++)
+            {
+                double start = bench_now();
+                work = bench_run(bench, engine);
+                times[i] = bench_now() - start;
+                mean += times[i];
+            }
+            mean /= repetitions;
+
+            double variance = 0;
+            for (int i = 0; i < repetitions; i++)
+            {
+                variance += (times[i] - mean) * (times[i] - mean);
+            }
+            variance = repetitions > 1 ? variance / (repetitions - 1) : 0;
+
+            qsort(times, repetitions, sizeof(double), bench_compare);
+            double median = repetitions % 2 ? times[repetitions / 2] : 0.5 * (times[repetitions / 2 - 1] + times[repetitions / 2]);
+
+            printf("%s\n    {\"name\": \"%s\", \"engine\": \"%s\", \"atmosphere\": \"%s\", \"altitude_km\": %g, \"f107\": %g, \"ap\": %g, "
+                   "\"result\": %.6f, \"lifetimes\": %d, \"steps\": %ld, "
+                   "\"mean_s\": %.9g, \"median_s\": %.9g, \"min_s\": %.9g, \"max_s\": %.9g, \"variance_s2\": %.9g, \"stddev_s\": %.9g, "
+                   "\"ns_per_step\": ",
+                   first ? "" : ",", bench->name, bench_engines[engine], bench_atmospheres[bench->atmosphere], bench->altitude, bench->solar_radio_flux, bench->geomagnetic_a_index,
+                   work.result, work.lifetimes, work.steps,
+                   mean, median, times[0], times[repetitions - 1], variance, sqrt(variance));
+            if (work.steps > 0)
+            {
+                printf("%.3f", mean * 1e9 / work.steps);
+            }
+            else
+            {
+                printf("null");
+            }
+            printf(", \"lifetimes_per_s\": %.6g}", work.lifetimes / mean);
+            fflush(stdout);
+            first = false;
+        }
+    }
+
+    printf("\n  ]\n}\n");
+
+    free(times);
+    return 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file buffer.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Growable in-memory text and byte buffers.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "buffer.h"
+
+// Ensures room for size more bytes plus a terminator.
+static int buffer_reserve(buffer_t *buffer, size_t size)
+{
+    if (buffer->length + size + 1 <= buffer->capacity)
+    {
+        return 0;
+    }
+
+    size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+    while (capacity < buffer->length + size + 1)
+    {
+        capacity *= 2;
+    }
+
+    char *data = realloc(buffer->data, capacity);
+    if (data == NULL)
+    {
+        return -1;
+    }
+
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return 0;
+}
+
+int buffer_printf(buffer_t *buffer, const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    int size = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+
+    if (size < 0 || buffer_reserve(buffer, size) < 0)
+    {
+        return -1;
+    }
+
+    va_start(args, format);
+    vsnprintf(buffer->data + buffer->length, size + 1, format, args);
+    va_end(args);
+
+    buffer->length += size;
+    return size;
+}
+
+int buffer_write(buffer_t *buffer, const void *data, size_t size)
+{
+    if (buffer_reserve(buffer, size) < 0)
+    {
+        return -1;
+    }
+
+    memcpy(buffer->data + buffer->length, data, size);
+    buffer->length += size;
+    buffer->data[buffer->length] = '\0';
+    return 0;
+}
+
+void buffer_clear(buffer_t *buffer)
+{
+    buffer->length = 0;
+    if (buffer->data != NULL)
+    {
+        buffer->data[0] = '\0';
+    }
+}
+
+void buffer_free(buffer_t *buffer)
+{
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->length = 0;
+    buffer->capacity = 0;
+}
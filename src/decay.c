@@ -13,232 +13,1868 @@
 #include <math.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "decay.h"
+#include "decay_stats.h"
 
-double decay_max_avg_srf(double satellite_mass, double satellite_area, double altitude, double geomagnetic_a_index, int mission_time)
+#define ADAPTIVE_INITIAL_STEP 600 // Seconds.
+#define ADAPTIVE_MIN_STEP 1e-3    // Seconds; steps this small are accepted regardless of their error estimate.
+#define SOLVER_CUTOFF 1.5         // Solver runs are abandoned once they pass this multiple of the mission time.
+#define SOLVER_MAX_ATTEMPTS 100
+#define SOLVER_MAX_INDEX 1e5      // Largest index the solvers will bracket up to.
+#define NORMALIZED_REFINEMENT 16  // Tolerance ratio between the two runs of decay_normalize(...).
+#define ELLIPTICAL_NODES 28       // Most trapezoidal nodes around the orbit before the orbit averages switch to Gauss-Kronrod panels.
+#define ELLIPTICAL_ACCURACY 1e-12 // Relative error targeted by the trapezoidal orbit averages.
+#define ELLIPTICAL_WINDOW 8       // Decline (a e / H)(1 - cos E) of the density from perigee at which the Gauss-Kronrod orbit averages start their second panel.
+#define ELLIPTICAL_PANELS 32      // Most Gauss-Kronrod panels of the orbit averages.
+#define ELLIPTICAL_MAX_STEP (365 * 86400) // Largest step in seconds of the orbit-averaged propagation, whose elements vary smoothly over many orbits.
+
+#ifdef DECAY_NO_STATS
+#define DECAY_COUNT(state, counter, n) ((void)0)
+#else
+#define DECAY_COUNT(state, counter, n) ((state)->stats->counter += (n))
+#endif
+
+/**
+ * @brief Propagation state shared by the integration engines.
+ *
+ * The model state is the orbital period; radius and altitude are derived from it after every step. The previous step's end point is kept so that print-outs and the Karman Line crossing can be interpolated within a step.
+ *
+ */
+typedef struct
+{
+    decay_engine_t engine;
+    double satellite_mass;
+    double satellite_area;
+    double sh_numerator; // Numerator of the SH term, fixed by the space weather or taken from the history for the current step.
+    const decay_weather_t *weather; // Space weather history, or NULL for constant averages.
+    decay_atmosphere_t atmosphere;  // Density model.
+    double tolerance;    // Relative tolerance on the re-entry time (adaptive only).
+
+    double elapsed_time;      // Elapsed time measured in seconds.
+    double orbital_period;    // Orbital period measured in fractional seconds.
+    double orbital_radius;    // Orbital radius measured in meters.
+    double altitude;          // Altitude measured in meters.
+    double period_derivative; // Rate of change of the orbital period at the current state (adaptive only).
+    double step;              // Step size in seconds of the fixed engine, or the next trial step size of the adaptive engine.
+
+    double last_time;              // elapsed_time at the beginning of the last step.
+    double last_period;            // orbital_period at the beginning of the last step.
+    double last_period_derivative; // period_derivative at the beginning of the last step.
+
+    decay_stats_t *stats; // Counts of the propagation, merged into the totals when it ends.
+
+    // Integrals q of the variational solutions dP/dx = f(P) q (see decay_sensitivity_t), kept when sensitive.
+    bool sensitive;
+    double tangent_numerator;    // q for sh_numerator: the integral of d ln(density) / d sh_numerator.
+    double tangent_area_mass;    // q for the area-to-mass ratio: the integral of mass / area, rescaled at changes of the space weather.
+    double tangent_sh_numerator; // sh_numerator in effect when tangent_area_mass was last advanced.
+
+    // Orbit-averaged propagation of an elliptical orbit, which replaces the period as the state until the orbit is nearly circular.
+    bool elliptical;
+    double semi_major_axis;       // Meters.
+    double eccentricity;
+    double axis_rate;             // Rate of change of the semi-major axis at the current state.
+    double eccentricity_rate;     // Rate of change of the eccentricity at the current state.
+    double last_axis;             // semi_major_axis at the beginning of the last step.
+    double last_eccentricity;     // eccentricity at the beginning of the last step.
+    double last_axis_rate;        // axis_rate at the beginning of the last step.
+    double last_eccentricity_rate; // eccentricity_rate at the beginning of the last step.
+    int anomaly_nodes;            // Trapezoidal nodes around the orbit of the current step's averages, or 0 for Gauss-Kronrod panels.
+    int anomaly_panels;           // Gauss-Kronrod panels of the current step's averages.
+    double anomaly_bounds[ELLIPTICAL_PANELS + 1]; // Eccentric anomalies bounding the panels, from 0 to PI.
+    double elliptical_step;       // Next trial step size in seconds.
+} decay_state_t;
+
+static inline double decay_sh_numerator(double solar_radio_flux, double geomagnetic_a_index)
+{
+    return 900 + 2.5 * (solar_radio_flux - 70) + 1.5 * geomagnetic_a_index;
+}
+
+// Atmospheric density in kg/m^3 at an altitude in meters, with the default model inlined.
+static inline double decay_density(const decay_state_t *state, double altitude)
+{
+    DECAY_COUNT(state, density_evaluations, 1);
+    if (state->atmosphere == DECAY_ATMOSPHERE_EXPONENTIAL)
+    {
+        DECAY_COUNT(state, exp_calls, 1);
+        return decay_atmosphere_exponential(altitude, state->sh_numerator);
+    }
+    return decay_atmosphere_density(state->atmosphere, altitude, state->sh_numerator);
+}
+
+// d ln(density) / d sh_numerator at an altitude in meters; zero for the standard atmosphere, which ignores the space weather.
+static inline double decay_density_numerator_slope(const decay_state_t *state, double altitude)
+{
+    if (state->atmosphere != DECAY_ATMOSPHERE_EXPONENTIAL)
+    {
+        return 0;
+    }
+
+    double km = altitude / 1000;
+    return (km - 175) * (27 - 0.012 * (km - 200)) / (state->sh_numerator * state->sh_numerator);
+}
+
+// Keplerian period of a circular orbit, used for the initial conditions.
+static inline double decay_initial_period(double orbital_radius)
+{
+    return 2.0 * PI * sqrt(pow(orbital_radius, 3.0) / EARTH_MASS / GRAVITATIONAL_CONSTANT);
+}
+
+// Radius update of the reference model. Note the exponent of 0.33333 rather than 1/3.
+static inline double decay_radius_from_period(double orbital_period)
+{
+    return pow((pow(orbital_period, 2.0) * GRAVITATIONAL_CONSTANT * EARTH_MASS / 4 / pow(PI, 2.0)), 0.33333);
+}
+
+// Exact inverse of decay_radius_from_period(...), so that every engine follows the same trajectory.
+static inline double decay_period_from_radius(double orbital_radius)
+{
+    return sqrt(pow(orbital_radius, 1 / 0.33333) / (GRAVITATIONAL_CONSTANT * EARTH_MASS / 4 / pow(PI, 2.0)));
+}
+
+// Rate at which drag shortens the orbital period, in seconds per second.
+static inline double decay_period_rate(const decay_state_t *state, double orbital_radius, double altitude)
+{
+    return 3 * PI * state->satellite_area / state->satellite_mass * orbital_radius * decay_density(state, altitude);
+}
+
+static inline double decay_period_derivative(const decay_state_t *state, double orbital_period)
+{
+    DECAY_COUNT(state, pow_calls, 1);
+    double orbital_radius = decay_radius_from_period(orbital_period);
+    return -decay_period_rate(state, orbital_radius, orbital_radius - EARTH_RADIUS);
+}
+
+/**
+ * @brief Initializes a circular orbit at the given altitude in meters.
+ *
+ * The caller sets the state's stats and atmosphere beforehand.
+ *
+ * With a space weather history the model is no longer autonomous, so the quadrature engine, which integrates over radius, is replaced by the adaptive engine.
+ *
+ */
+static void decay_state_init(decay_state_t *state, decay_engine_t engine, double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, const decay_weather_t *weather, double tolerance)
+{
+    state->engine = weather != NULL && engine == DECAY_ENGINE_QUADRATURE ? DECAY_ENGINE_ADAPTIVE : engine;
+    state->satellite_mass = satellite_mass;
+    state->satellite_area = satellite_area;
+    state->weather = weather;
+    state->sh_numerator = weather != NULL ? decay_weather_sh_numerator(weather, 0) : decay_sh_numerator(solar_radio_flux, geomagnetic_a_index);
+    state->tolerance = tolerance > 0 ? tolerance : ADAPTIVE_TOLERANCE;
+
+    state->elapsed_time = 0;
+    state->altitude = altitude;
+    state->orbital_radius = EARTH_RADIUS + state->altitude;
+    state->orbital_period = decay_initial_period(state->orbital_radius);
+    state->period_derivative = state->engine == DECAY_ENGINE_ADAPTIVE ? decay_period_derivative(state, state->orbital_period) : 0;
+    state->step = state->engine == DECAY_ENGINE_FIXED ? TEMPORAL_RESOLUTION : ADAPTIVE_INITIAL_STEP;
+
+    state->last_time = state->elapsed_time;
+    state->last_period = state->orbital_period;
+    state->last_period_derivative = state->period_derivative;
+
+    state->sensitive = false;
+    state->tangent_numerator = 0;
+    state->tangent_area_mass = 0;
+    state->tangent_sh_numerator = state->sh_numerator;
+
+    state->elliptical = false;
+}
+
+static void decay_step_fixed(decay_state_t *state)
+{
+    if (state->weather != NULL)
+    {
+        state->sh_numerator = decay_weather_sh_numerator(state->weather, state->elapsed_time);
+    }
+
+    double delta_period = decay_period_rate(state, state->orbital_radius, state->altitude) * state->step; // Change in orbital period from previous iteration.
+
+    state->last_time = state->elapsed_time;
+    state->last_period = state->orbital_period;
+
+    state->orbital_period -= delta_period;
+    state->elapsed_time += state->step;
+    state->orbital_radius = decay_radius_from_period(state->orbital_period);
+    state->altitude = state->orbital_radius - EARTH_RADIUS;
+    DECAY_COUNT(state, pow_calls, 1);
+}
+
+/**
+ * @brief Takes one accepted Dormand-Prince 5(4) step, retrying with smaller steps as needed.
+ *
+ * Because the model is autonomous, an error dP in the period is equivalent to a shift of dP / |dP/dt| along the trajectory. Each step keeps that shift below tolerance * step, which bounds the accumulated re-entry time error by roughly tolerance * lifetime.
+ *
+ * With a space weather history, steps end at the history's sample boundaries so that the model is autonomous within every step.
+ *
+ */
+static void decay_step_adaptive(decay_state_t *state)
+{
+    double next_change = INFINITY;
+    if (state->weather != NULL)
+    {
+        double sh_numerator = decay_weather_sh_numerator(state->weather, state->elapsed_time);
+        if (sh_numerator != state->sh_numerator)
+        {
+            state->sh_numerator = sh_numerator;
+            state->period_derivative = decay_period_derivative(state, state->orbital_period);
+        }
+        next_change = decay_weather_next_change(state->weather, state->elapsed_time);
+    }
+
+    const double P = state->orbital_period;
+    const double k1 = state->period_derivative;
+
+    for (;;)
+    {
+        bool truncated = state->step > next_change - state->elapsed_time;
+        double h = truncated ? next_change - state->elapsed_time : state->step;
+
+        double k2 = decay_period_derivative(state, P + h * (k1 / 5));
+        double k3 = decay_period_derivative(state, P + h * (k1 * 3 / 40 + k2 * 9 / 40));
+        double k4 = decay_period_derivative(state, P + h * (k1 * 44 / 45 - k2 * 56 / 15 + k3 * 32 / 9));
+        double k5 = decay_period_derivative(state, P + h * (k1 * 19372 / 6561 - k2 * 25360 / 2187 + k3 * 64448 / 6561 - k4 * 212 / 729));
+        double k6 = decay_period_derivative(state, P + h * (k1 * 9017 / 3168 - k2 * 355 / 33 + k3 * 46732 / 5247 + k4 * 49 / 176 - k5 * 5103 / 18656));
+        double next_period = P + h * (k1 * 35 / 384 + k3 * 500 / 1113 + k4 * 125 / 192 - k5 * 2187 / 6784 + k6 * 11 / 84);
+        double k7 = decay_period_derivative(state, next_period);
+
+        double period_error = fabs(h * (k1 * 71 / 57600 - k3 * 71 / 16695 + k4 * 71 / 1920 - k5 * 17253 / 339200 + k6 * 22 / 525 - k7 / 40));
+        double time_error = period_error / fabs(k1);
+        double allowed_error = state->tolerance * h;
+
+        double factor = time_error > 0 ? 0.9 * pow(allowed_error / time_error, 0.25) : 5;
+        factor = factor < 0.2 ? 0.2 : factor > 5 ? 5 : factor;
+        DECAY_COUNT(state, pow_calls, time_error > 0);
+
+        if (time_error <= allowed_error || h <= ADAPTIVE_MIN_STEP || isnan(next_period))
+        {
+            state->last_time = state->elapsed_time;
+            state->last_period = P;
+            state->last_period_derivative = k1;
+
+            state->elapsed_time = truncated ? next_change : state->elapsed_time + h;
+            state->orbital_period = next_period;
+            state->period_derivative = k7;
+            state->orbital_radius = decay_radius_from_period(next_period);
+            state->altitude = state->orbital_radius - EARTH_RADIUS;
+            DECAY_COUNT(state, pow_calls, 1);
+
+            // A step cut short at a sample boundary only limits the next step if it had to shrink.
+            double step = truncated && factor >= 1 ? state->step : h * factor;
+            state->step = step > ADAPTIVE_MAX_STEP ? ADAPTIVE_MAX_STEP : step;
+            return;
+        }
+
+        state->step = h * factor < ADAPTIVE_MIN_STEP ? ADAPTIVE_MIN_STEP : h * factor;
+        DECAY_COUNT(state, rejected_steps, 1);
+    }
+}
+
+static inline void decay_step(decay_state_t *state)
+{
+    if (state->engine == DECAY_ENGINE_FIXED)
+    {
+        decay_step_fixed(state);
+    }
+    else
+    {
+        decay_step_adaptive(state);
+    }
+}
+
+/**
+ * @brief Orbital period at a time within the last step.
+ *
+ * The adaptive engine interpolates with a cubic Hermite polynomial through the end points of the last step; the fixed engine reports the state at the end of the step, as the reference print-out always has.
+ *
+ */
+static double decay_interpolate_period(const decay_state_t *state, double time)
+{
+    double h = state->elapsed_time - state->last_time;
+    if (state->engine == DECAY_ENGINE_FIXED || h <= 0 || time >= state->elapsed_time)
+    {
+        return state->orbital_period;
+    }
+
+    double s = (time - state->last_time) / h;
+    double s2 = s * s, s3 = s2 * s;
+
+    return (2 * s3 - 3 * s2 + 1) * state->last_period + (s3 - 2 * s2 + s) * h * state->last_period_derivative + (-2 * s3 + 3 * s2) * state->orbital_period + (s3 - s2) * h * state->period_derivative;
+}
+
+// Time at which the last step passed the target period, which must lie within the step.
+static double decay_crossing_time(const decay_state_t *state, double target_period)
+{
+    if (state->engine == DECAY_ENGINE_FIXED || state->elapsed_time == state->last_time)
+    {
+        return state->elapsed_time;
+    }
+
+    // The period decreases monotonically within a step, so bisect the interpolant.
+    double lo = state->last_time, hi = state->elapsed_time;
+    for (int i = 0; i < 64 && hi - lo > 1e-6; i++)
+    {
+        double mid = 0.5 * (lo + hi);
+        if (decay_interpolate_period(state, mid) > target_period)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return 0.5 * (lo + hi);
+}
+
+// Time at which the last step crossed the Karman Line.
+static inline double decay_reentry_time(const decay_state_t *state)
+{
+    DECAY_COUNT(state, pow_calls, 1);
+    return decay_crossing_time(state, decay_period_from_radius(EARTH_RADIUS + KARMAN_LINE));
+}
+
+// Altitude in meters at a time within the last step.
+static inline double decay_interpolate_altitude(const decay_state_t *state, double time)
+{
+    DECAY_COUNT(state, pow_calls, 1);
+    return decay_radius_from_period(decay_interpolate_period(state, time)) - EARTH_RADIUS;
+}
+
+/**
+ * @brief Advances the sensitivity integrals from the start of the last step to a time within it.
+ *
+ * The fixed engine takes the slope at the start of the step, as its Euler step takes the density; the adaptive engine integrates it with Simpson's rule on the interpolant.
+ *
+ */
+static void decay_tangent_advance(decay_state_t *state, double end)
+{
+    double start = state->last_time;
+    DECAY_COUNT(state, pow_calls, 1);
+    double start_altitude = decay_radius_from_period(state->last_period) - EARTH_RADIUS;
+
+    // dP/dx = f q is continuous, so q scales with the inverse of f where the space weather changes it.
+    if (state->sh_numerator != state->tangent_sh_numerator)
+    {
+        state->tangent_area_mass *= decay_atmosphere_density(state->atmosphere, start_altitude, state->tangent_sh_numerator) / decay_atmosphere_density(state->atmosphere, start_altitude, state->sh_numerator);
+        state->tangent_sh_numerator = state->sh_numerator;
+    }
+
+    state->tangent_area_mass += (end - start) * state->satellite_mass / state->satellite_area;
+
+    // F10.7 and Ap are unused with a history.
+    if (state->weather != NULL || end <= start)
+    {
+        return;
+    }
+
+    if (state->engine == DECAY_ENGINE_FIXED)
+    {
+        state->tangent_numerator += (end - start) * decay_density_numerator_slope(state, start_altitude);
+        return;
+    }
+
+    double end_altitude = end == state->elapsed_time ? state->altitude : decay_interpolate_altitude(state, end);
+    double middle_altitude = decay_interpolate_altitude(state, 0.5 * (start + end));
+    state->tangent_numerator += (end - start) / 6 * (decay_density_numerator_slope(state, start_altitude) + 4 * decay_density_numerator_slope(state, middle_altitude) + decay_density_numerator_slope(state, end_altitude));
+}
+
+// Derivatives of the lifetime from the integrals at re-entry; dN/dF10.7 = 2.5 and dN/dAp = 1.5.
+static void decay_tangent_finish(const decay_state_t *state, decay_sensitivity_t *sensitivity)
+{
+    sensitivity->solar_radio_flux = -2.5 * state->tangent_numerator;
+    sensitivity->geomagnetic_a_index = -1.5 * state->tangent_numerator;
+    sensitivity->area_mass = -state->tangent_area_mass;
+}
+
+/**
+ * @brief Integrand of the lifetime over orbital radius, dt/dr in seconds per meter.
+ *
+ * Follows from P(r) being the inverse of the radius update, so dP/dr = P / (0.33333 * 2 * r).
+ *
+ */
+static inline double decay_time_per_radius(const decay_state_t *state, double orbital_radius)
+{
+    DECAY_COUNT(state, pow_calls, 1);
+    double orbital_period = decay_period_from_radius(orbital_radius);
+    return orbital_period / (2 * 0.33333 * orbital_radius * decay_period_rate(state, orbital_radius, orbital_radius - EARTH_RADIUS));
+}
+
+// Nodes on [-1, 1] of the Gauss-Kronrod (7, 15) rule, mirrored about the last, and their weights.
+static const double decay_kronrod_nodes[8] = {0.991455371120812639, 0.949107912342758525, 0.864864423359769073, 0.741531185599394440,
+                                              0.586087235467691130, 0.405845151377397167, 0.207784955007898468, 0.000000000000000000};
+static const double decay_kronrod_weights[8] = {0.022935322010529225, 0.063092092629978553, 0.104790010322250184, 0.140653259715525919,
+                                                0.169004726639267903, 0.190350578064785410, 0.204432940075298892, 0.209482141084727828};
+
+// Integrand over orbital radius of the quadratures: the lifetime or one of its sensitivity integrals.
+typedef double (*decay_integrand_t)(const decay_state_t *state, double orbital_radius);
+
+// Integrand of the sensitivity integral for sh_numerator over radius.
+static double decay_numerator_slope_per_radius(const decay_state_t *state, double orbital_radius)
+{
+    return decay_density_numerator_slope(state, orbital_radius - EARTH_RADIUS) * decay_time_per_radius(state, orbital_radius);
+}
+
+// Gauss-Kronrod (7, 15) estimate of an integral between two radii, with the Gauss-Kronrod difference as its error.
+static inline double decay_gauss_kronrod(const decay_state_t *state, decay_integrand_t integrand, double lower, double upper, double *error)
+{
+    static const double gauss_weights[4] = {0.129484966168869693, 0.279705391489276668, 0.381830050505118945, 0.417959183673469388};
+    const double *nodes = decay_kronrod_nodes, *kronrod_weights = decay_kronrod_weights;
+
+    double center = 0.5 * (lower + upper);
+    double half_width = 0.5 * (upper - lower);
+
+    double center_value = integrand(state, center);
+    double kronrod = center_value * kronrod_weights[7];
+    double gauss = center_value * gauss_weights[3];
+
+    for (int i = 0; i < 7; i++)
+    {
+        double values = integrand(state, center - half_width * nodes[i]) + integrand(state, center + half_width * nodes[i]);
+        kronrod += kronrod_weights[i] * values;
+        if (i % 2 == 1)
+        {
+            gauss += gauss_weights[i / 2] * values;
+        }
+    }
+
+    *error = fabs((kronrod - gauss) * half_width);
+    return kronrod * half_width;
+}
+
+// Bisects panels until each meets its share of the absolute tolerance.
+static double decay_quadrature_panel(const decay_state_t *state, decay_integrand_t integrand, double lower, double upper, double estimate, double error, double tolerance, int depth)
+{
+    if (error <= tolerance || depth >= 32)
+    {
+        return estimate;
+    }
+
+    double middle = 0.5 * (lower + upper);
+    double lower_error = 0, upper_error = 0;
+    double lower_estimate = decay_gauss_kronrod(state, integrand, lower, middle, &lower_error);
+    double upper_estimate = decay_gauss_kronrod(state, integrand, middle, upper, &upper_error);
+
+    return decay_quadrature_panel(state, integrand, lower, middle, lower_estimate, lower_error, 0.5 * tolerance, depth + 1) +
+           decay_quadrature_panel(state, integrand, middle, upper, upper_estimate, upper_error, 0.5 * tolerance, depth + 1);
+}
+
+// Integral between two radii; with decay_time_per_radius(...), the time to descend between them.
+static double decay_quadrature(const decay_state_t *state, decay_integrand_t integrand, double lower, double upper)
+{
+    if (upper <= lower)
+    {
+        return 0;
+    }
+
+    double error = 0;
+    double estimate = decay_gauss_kronrod(state, integrand, lower, upper, &error);
+    return decay_quadrature_panel(state, integrand, lower, upper, estimate, error, QUADRATURE_TOLERANCE * fabs(estimate), 0);
+}
+
+// Lifetime from the state's current period down to the Karman Line, without the 50 year limit.
+static inline double decay_quadrature_lifetime(const decay_state_t *state)
+{
+    return decay_quadrature(state, decay_time_per_radius, EARTH_RADIUS + KARMAN_LINE, decay_radius_from_period(state->orbital_period));
+}
+
+// Half the log ratio of the densities at perigee and apogee, which is a e / H in an exponential atmosphere of scale height H.
+static inline double decay_orbit_variation(const decay_state_t *state)
+{
+    double perigee = decay_density(state, state->semi_major_axis * (1 - state->eccentricity) - EARTH_RADIUS);
+    double apogee = decay_density(state, state->semi_major_axis * (1 + state->eccentricity) - EARTH_RADIUS);
+    return 0.5 * fabs(log(perigee / apogee));
+}
+
+/**
+ * @brief Chooses the quadrature of the orbit averages of the next step from the scale height H at perigee, measured over one kilometer.
+ *
+ * With z = a e / H, the density around the orbit is close to exp(z cos E) times that at the mean radius. The trapezoidal rule with N nodes around the orbit integrates the terms of the averages' Fourier series (of modified Bessel functions of z) exactly below order N, and those terms fall off as (z / 2)^N / N!, and as (e / (1 + sqrt(1 - e^2)))^N for the eccentricity factors. The smallest N that brings both below ELLIPTICAL_ACCURACY is used; for low Earth orbits it is 6 to 12, with half of the nodes plus one distinct.
+ *
+ * Steeper perigee peaks, and orbits that cross a break of the atmosphere, where the density is not smooth enough for the trapezoidal rule, use Gauss-Kronrod panels instead. They end where the density has fallen by about exp(-ELLIPTICAL_WINDOW) and exp(-5 ELLIPTICAL_WINDOW) from perigee, so that the peak is resolved, and at every break.
+ *
+ */
+static inline void decay_orbit_nodes(decay_state_t *state)
+{
+    double semi_major_axis = state->semi_major_axis, eccentricity = state->eccentricity;
+    double perigee = semi_major_axis * (1 - eccentricity) - EARTH_RADIUS, apogee = semi_major_axis * (1 + eccentricity) - EARTH_RADIUS;
+    double decline = log(decay_density(state, perigee) / decay_density(state, perigee + 1000)) / 1000;
+    double peak = semi_major_axis * eccentricity * decline;
+
+    double breaks[ELLIPTICAL_PANELS];
+    int break_count = decay_atmosphere_breaks(state->atmosphere, perigee, apogee, breaks, ELLIPTICAL_PANELS - 3);
+
+    double bessel = 1, power = 1, ratio = eccentricity / (1 + sqrt(1 - eccentricity * eccentricity));
+    state->anomaly_nodes = 0;
+    for (int nodes = 1; nodes <= ELLIPTICAL_NODES && break_count == 0 && isfinite(peak); nodes++)
+    {
+        bessel *= fabs(peak) / 2 / nodes;
+        power *= ratio;
+        if (nodes % 2 == 0 && bessel + power < ELLIPTICAL_ACCURACY)
+        {
+            state->anomaly_nodes = nodes;
+            return;
+        }
+    }
+
+    double declines[2];
+    int decline_count = 0;
+    for (int i = 0; i < 2; i++)
+    {
+        double fall = i == 0 ? ELLIPTICAL_WINDOW : 5 * ELLIPTICAL_WINDOW;
+        if (isfinite(peak) && fall < 2 * peak)
+        {
+            declines[decline_count++] = acos(1 - fall / peak);
+        }
+    }
+
+    // Both kinds of bounds increase, so they are merged in order.
+    int panels = 0;
+    state->anomaly_bounds[0] = 0;
+    for (int i = 0, j = 0; i < decline_count || j < break_count; panels++)
+    {
+        double break_anomaly = j < break_count ? acos((1 - (EARTH_RADIUS + breaks[j]) / semi_major_axis) / eccentricity) : INFINITY;
+        double bound = i < decline_count && declines[i] < break_anomaly ? declines[i++] : (j++, break_anomaly);
+        state->anomaly_bounds[panels + 1] = bound < PI ? bound : PI;
+    }
+    state->anomaly_bounds[++panels] = PI;
+    state->anomaly_panels = panels;
+}
+
+// Adds the integrands of the orbit averages at one eccentric anomaly.
+static inline void decay_orbit_node(const decay_state_t *state, double semi_major_axis, double eccentricity, double anomaly, double weight, double *axis_integral, double *eccentricity_integral)
+{
+    double cosine = cos(anomaly);
+    double ratio = sqrt((1 + eccentricity * cosine) / (1 - eccentricity * cosine));
+    double density = decay_density(state, semi_major_axis * (1 - eccentricity * cosine) - EARTH_RADIUS);
+
+    *axis_integral += weight * density * (1 + eccentricity * cosine) * ratio;
+    *eccentricity_integral += weight * density * ratio * cosine;
+}
+
+/**
+ * @brief Orbit-averaged rates of change of the semi-major axis and eccentricity under drag.
+ *
+ * The averages over the eccentric anomaly E of King-Hele for a non-rotating atmosphere, with r = a (1 - e cos E) and mu = G M:
+ *
+ *     da/dt = -(A / m) sqrt(mu a) / PI * integral over [0, PI] of rho(r) (1 + e cos E)^(3/2) / (1 - e cos E)^(1/2) dE
+ *     de/dt = -(A / m) sqrt(mu / a) (1 - e^2) / PI * integral over [0, PI] of rho(r) ((1 + e cos E) / (1 - e cos E))^(1/2) cos E dE
+ *
+ * As e goes to zero, da/dt becomes the circular model's rate. Both integrals share their densities, at the nodes chosen by decay_orbit_nodes(...). The classical Bessel-function series of the averages would need a constant scale height, which the model's atmospheres do not have, but the trapezoidal rule converges as fast as the series does.
+ *
+ */
+static void decay_orbit_rates(const decay_state_t *state, double semi_major_axis, double eccentricity, double *axis_rate, double *eccentricity_rate)
+{
+    eccentricity = eccentricity > 0 ? eccentricity : 0;
+
+    double axis_integral = 0, eccentricity_integral = 0;
+    if (state->anomaly_nodes > 0)
+    {
+        // The integrands are even, so the nodes past PI repeat those before it.
+        int nodes = state->anomaly_nodes;
+        for (int i = 0; 2 * i <= nodes; i++)
+        {
+            double weight = (i == 0 || 2 * i == nodes ? 1 : 2) * PI / nodes;
+            decay_orbit_node(state, semi_major_axis, eccentricity, 2 * PI * i / nodes, weight, &axis_integral, &eccentricity_integral);
+        }
+    }
+    else
+    {
+        const double *bounds = state->anomaly_bounds;
+        for (int panel = 0; panel < state->anomaly_panels; panel++)
+        {
+            double center = 0.5 * (bounds[panel] + bounds[panel + 1]);
+            double half_width = 0.5 * (bounds[panel + 1] - bounds[panel]);
+            for (int i = 0; i < 15 && half_width > 0; i++)
+            {
+                double anomaly = i < 8 ? center - half_width * decay_kronrod_nodes[i] : center + half_width * decay_kronrod_nodes[14 - i];
+                decay_orbit_node(state, semi_major_axis, eccentricity, anomaly, half_width * decay_kronrod_weights[i < 8 ? i : 14 - i], &axis_integral, &eccentricity_integral);
+            }
+        }
+    }
+
+    double mu = GRAVITATIONAL_CONSTANT * EARTH_MASS;
+    double area_mass = state->satellite_area / state->satellite_mass;
+    *axis_rate = -area_mass * sqrt(mu * semi_major_axis) / PI * axis_integral;
+    *eccentricity_rate = -area_mass * sqrt(mu / semi_major_axis) * (1 - eccentricity * eccentricity) / PI * eccentricity_integral;
+}
+
+// Hands a nearly circular orbit over to the circular model at its semi-major axis.
+static void decay_orbit_circularize(decay_state_t *state)
+{
+    state->elliptical = false;
+    state->orbital_radius = state->semi_major_axis;
+    state->altitude = state->orbital_radius - EARTH_RADIUS;
+    state->orbital_period = decay_period_from_radius(state->orbital_radius);
+    state->period_derivative = state->engine == DECAY_ENGINE_ADAPTIVE ? decay_period_derivative(state, state->orbital_period) : 0;
+    DECAY_COUNT(state, pow_calls, 1);
+
+    state->last_time = state->elapsed_time;
+    state->last_period = state->orbital_period;
+    state->last_period_derivative = state->period_derivative;
+}
+
+/**
+ * @brief Starts an orbit between two altitudes in meters on a state initialized by decay_state_init(...).
+ *
+ * An orbit that is already nearly circular starts on the circular model at its mean altitude; otherwise the semi-major axis and eccentricity become the state until decay_orbit_circularize(...). Meanwhile, the altitude and period of the state are those the circular model gives the semi-major axis.
+ *
+ */
+static void decay_state_init_elliptical(decay_state_t *state, double perigee, double apogee)
+{
+    // The circular model's first step moves the radius to that of its initial period; starting from the same radius keeps the two in agreement as the eccentricity goes to zero.
+    double orbital_radius = EARTH_RADIUS + 0.5 * (perigee + apogee);
+    state->semi_major_axis = decay_radius_from_period(decay_initial_period(orbital_radius));
+    state->eccentricity = 0.5 * (apogee - perigee) / state->semi_major_axis;
+    DECAY_COUNT(state, pow_calls, 2);
+    state->elliptical_step = ADAPTIVE_INITIAL_STEP;
+
+    if (decay_orbit_variation(state) < ELLIPTICAL_CIRCULAR)
+    {
+        // Start as decay_state_init(...) starts any circular orbit.
+        state->orbital_radius = orbital_radius;
+        state->altitude = orbital_radius - EARTH_RADIUS;
+        state->orbital_period = decay_initial_period(orbital_radius);
+        state->period_derivative = state->engine == DECAY_ENGINE_ADAPTIVE ? decay_period_derivative(state, state->orbital_period) : 0;
+        state->last_period = state->orbital_period;
+        state->last_period_derivative = state->period_derivative;
+        return;
+    }
+
+    decay_orbit_circularize(state);
+
+    state->elliptical = true;
+    decay_orbit_nodes(state);
+    decay_orbit_rates(state, state->semi_major_axis, state->eccentricity, &state->axis_rate, &state->eccentricity_rate);
+
+    state->last_axis = state->semi_major_axis;
+    state->last_eccentricity = state->eccentricity;
+    state->last_axis_rate = state->axis_rate;
+    state->last_eccentricity_rate = state->eccentricity_rate;
+}
+
+/**
+ * @brief Takes one accepted Dormand-Prince 5(4) step of the orbit-averaged semi-major axis and eccentricity.
+ *
+ * The error of the step is measured as a radius, the larger of the errors in the semi-major axis and in a e, and converted into a time shift along the decay of the semi-major axis, as the adaptive engine converts its error in the period. The panels of the orbit averages are placed once per step, and the space weather is taken from the start of the step, with steps ending at the history's sample boundaries.
+ *
+ * @return int 0 on success, -1 if the orbit averages are not finite, leaving the state unchanged.
+ */
+static int decay_step_elliptical(decay_state_t *state)
+{
+    double next_change = INFINITY;
+    if (state->weather != NULL)
+    {
+        state->sh_numerator = decay_weather_sh_numerator(state->weather, state->elapsed_time);
+        next_change = decay_weather_next_change(state->weather, state->elapsed_time);
+    }
+
+    decay_orbit_nodes(state);
+
+    const double a = state->semi_major_axis, e = state->eccentricity;
+    double ka[7], ke[7];
+    decay_orbit_rates(state, a, e, &ka[0], &ke[0]);
+
+    for (;;)
+    {
+        bool truncated = state->elliptical_step > next_change - state->elapsed_time;
+        double h = truncated ? next_change - state->elapsed_time : state->elliptical_step;
+
+        decay_orbit_rates(state, a + h * (ka[0] / 5), e + h * (ke[0] / 5), &ka[1], &ke[1]);
+        decay_orbit_rates(state, a + h * (ka[0] * 3 / 40 + ka[1] * 9 / 40), e + h * (ke[0] * 3 / 40 + ke[1] * 9 / 40), &ka[2], &ke[2]);
+        decay_orbit_rates(state, a + h * (ka[0] * 44 / 45 - ka[1] * 56 / 15 + ka[2] * 32 / 9), e + h * (ke[0] * 44 / 45 - ke[1] * 56 / 15 + ke[2] * 32 / 9), &ka[3], &ke[3]);
+        decay_orbit_rates(state, a + h * (ka[0] * 19372 / 6561 - ka[1] * 25360 / 2187 + ka[2] * 64448 / 6561 - ka[3] * 212 / 729),
+                          e + h * (ke[0] * 19372 / 6561 - ke[1] * 25360 / 2187 + ke[2] * 64448 / 6561 - ke[3] * 212 / 729), &ka[4], &ke[4]);
+        decay_orbit_rates(state, a + h * (ka[0] * 9017 / 3168 - ka[1] * 355 / 33 + ka[2] * 46732 / 5247 + ka[3] * 49 / 176 - ka[4] * 5103 / 18656),
+                          e + h * (ke[0] * 9017 / 3168 - ke[1] * 355 / 33 + ke[2] * 46732 / 5247 + ke[3] * 49 / 176 - ke[4] * 5103 / 18656), &ka[5], &ke[5]);
+        double next_axis = a + h * (ka[0] * 35 / 384 + ka[2] * 500 / 1113 + ka[3] * 125 / 192 - ka[4] * 2187 / 6784 + ka[5] * 11 / 84);
+        double next_eccentricity = e + h * (ke[0] * 35 / 384 + ke[2] * 500 / 1113 + ke[3] * 125 / 192 - ke[4] * 2187 / 6784 + ke[5] * 11 / 84);
+        decay_orbit_rates(state, next_axis, next_eccentricity, &ka[6], &ke[6]);
+
+        double axis_error = fabs(h * (ka[0] * 71 / 57600 - ka[2] * 71 / 16695 + ka[3] * 71 / 1920 - ka[4] * 17253 / 339200 + ka[5] * 22 / 525 - ka[6] / 40));
+        double eccentricity_error = fabs(h * (ke[0] * 71 / 57600 - ke[2] * 71 / 16695 + ke[3] * 71 / 1920 - ke[4] * 17253 / 339200 + ke[5] * 22 / 525 - ke[6] / 40));
+        double radius_error = axis_error > a * eccentricity_error ? axis_error : a * eccentricity_error;
+        double time_error = radius_error / fabs(ka[0]);
+        double allowed_error = state->tolerance * h;
+
+        double factor = time_error > 0 ? 0.9 * pow(allowed_error / time_error, 0.25) : 5;
+        factor = factor < 0.2 ? 0.2 : factor > 5 ? 5 : factor;
+        DECAY_COUNT(state, pow_calls, time_error > 0);
+
+        if (!isfinite(next_axis) || !isfinite(next_eccentricity))
+        {
+            return -1;
+        }
+
+        if (time_error <= allowed_error || h <= ADAPTIVE_MIN_STEP)
+        {
+            state->last_time = state->elapsed_time;
+            state->last_axis = a;
+            state->last_eccentricity = e;
+            state->last_axis_rate = ka[0];
+            state->last_eccentricity_rate = ke[0];
+
+            state->elapsed_time = truncated ? next_change : state->elapsed_time + h;
+            state->semi_major_axis = next_axis;
+            state->eccentricity = next_eccentricity > 0 ? next_eccentricity : 0;
+            state->axis_rate = ka[6];
+            state->eccentricity_rate = ke[6];
+            state->orbital_radius = next_axis;
+            state->altitude = next_axis - EARTH_RADIUS;
+            state->orbital_period = decay_period_from_radius(next_axis);
+            DECAY_COUNT(state, pow_calls, 1);
+
+            double step = truncated && factor >= 1 ? state->elliptical_step : h * factor;
+            state->elliptical_step = step > ELLIPTICAL_MAX_STEP ? ELLIPTICAL_MAX_STEP : step;
+            return 0;
+        }
+
+        state->elliptical_step = h * factor < ADAPTIVE_MIN_STEP ? ADAPTIVE_MIN_STEP : h * factor;
+        DECAY_COUNT(state, rejected_steps, 1);
+    }
+}
+
+// Semi-major axis and eccentricity at a time within the last elliptical step, by cubic Hermite interpolation of each.
+static void decay_orbit_interpolate(const decay_state_t *state, double time, double *semi_major_axis, double *eccentricity)
+{
+    double h = state->elapsed_time - state->last_time;
+    if (h <= 0 || time >= state->elapsed_time)
+    {
+        *semi_major_axis = state->semi_major_axis;
+        *eccentricity = state->eccentricity;
+        return;
+    }
+
+    double s = (time - state->last_time) / h;
+    double s2 = s * s, s3 = s2 * s;
+    double h00 = 2 * s3 - 3 * s2 + 1, h10 = s3 - 2 * s2 + s, h01 = -2 * s3 + 3 * s2, h11 = s3 - s2;
+
+    *semi_major_axis = h00 * state->last_axis + h10 * h * state->last_axis_rate + h01 * state->semi_major_axis + h11 * h * state->axis_rate;
+    *eccentricity = h00 * state->last_eccentricity + h10 * h * state->last_eccentricity_rate + h01 * state->eccentricity + h11 * h * state->eccentricity_rate;
+}
+
+// Time at which the perigee of the last elliptical step crossed the Karman Line, and the model period of the semi-major axis then.
+static double decay_orbit_reentry_time(const decay_state_t *state, double *orbital_period)
+{
+    double lo = state->last_time, hi = state->elapsed_time;
+    double semi_major_axis = state->semi_major_axis, eccentricity = state->eccentricity;
+    for (int i = 0; i < 64 && hi - lo > 1e-6; i++)
+    {
+        double mid = 0.5 * (lo + hi);
+        decay_orbit_interpolate(state, mid, &semi_major_axis, &eccentricity);
+        if (semi_major_axis * (1 - eccentricity) > EARTH_RADIUS + KARMAN_LINE)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    double time = 0.5 * (lo + hi);
+    decay_orbit_interpolate(state, time, &semi_major_axis, &eccentricity);
+    *orbital_period = decay_period_from_radius(semi_major_axis);
+    DECAY_COUNT(state, pow_calls, 1);
+    return time;
+}
+
+// Calls the sample callback with an altitude in meters, counting the time spent in it as I/O.
+static inline int decay_sample(const decay_config_t *config, decay_stats_t *stats, double time, double altitude, double orbital_period)
+{
+    double io_start = decay_stats_clock();
+    int stop = config->on_sample(time, altitude / 1000, orbital_period, config->context);
+    stats->io_time += decay_stats_clock() - io_start;
+    return stop;
+}
+
+/**
+ * @brief Model period at a time within the last step, from the dense output of the step.
+ *
+ * The adaptive engine and the elliptical phase interpolate with their cubic Hermite polynomials. The fixed engine's Euler step changes the period at a constant rate, so its dense output is the straight line between the step's end points, unlike the reference print-out, which reports the state at the end of the step.
+ *
+ */
+static double decay_dense_period(const decay_state_t *state, double time)
+{
+    if (state->elliptical)
+    {
+        double semi_major_axis = state->semi_major_axis, eccentricity = state->eccentricity;
+        decay_orbit_interpolate(state, time, &semi_major_axis, &eccentricity);
+        DECAY_COUNT(state, pow_calls, 1);
+        return decay_period_from_radius(semi_major_axis);
+    }
+
+    double h = state->elapsed_time - state->last_time;
+    if (state->engine == DECAY_ENGINE_FIXED && h > 0 && time < state->elapsed_time)
+    {
+        return state->last_period + (state->orbital_period - state->last_period) * (time - state->last_time) / h;
+    }
+
+    return decay_interpolate_period(state, time);
+}
+
+// First time within the last step, up to end, at which the dense output falls below a period.
+static double decay_dense_crossing(const decay_state_t *state, double target_period, double end)
+{
+    double lo = state->last_time < end ? state->last_time : end, hi = end;
+    if (decay_dense_period(state, lo) < target_period)
+    {
+        return lo;
+    }
+
+    for (int i = 0; i < 64 && hi - lo > 1e-6; i++)
+    {
+        double mid = 0.5 * (lo + hi);
+        if (decay_dense_period(state, mid) >= target_period)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return 0.5 * (lo + hi);
+}
+
+// Pending events of a run. Altitude crossings are located as the periods of their altitudes, since the period only decreases.
+typedef struct
+{
+    decay_events_t *events; // NULL when no events are located.
+    double target_period;   // Highest period of the pending crossings and period threshold, or -INFINITY.
+    double epoch;           // Earliest pending epoch, or INFINITY.
+} decay_event_queue_t;
+
+// Model period at which the altitude of a crossing event in kilometers is passed.
+static inline double decay_event_period(const decay_state_t *state, double altitude)
+{
+    DECAY_COUNT(state, pow_calls, 1);
+    return decay_period_from_radius(EARTH_RADIUS + altitude * 1000);
+}
+
+// Finds the next pending events.
+static void decay_events_rescan(decay_event_queue_t *queue, const decay_state_t *state)
+{
+    const decay_events_t *events = queue->events;
+
+    queue->target_period = events->period > 0 && events->period_time < 0 ? events->period : -INFINITY;
+    for (int i = 0; i < events->altitude_count; i++)
+    {
+        double target_period = events->crossing_times[i] < 0 ? decay_event_period(state, events->altitudes[i]) : -INFINITY;
+        queue->target_period = target_period > queue->target_period ? target_period : queue->target_period;
+    }
+
+    queue->epoch = INFINITY;
+    for (int i = 0; i < events->epoch_count; i++)
+    {
+        if (events->epoch_altitudes[i] < 0 && events->epochs[i] >= 0 && events->epochs[i] < queue->epoch)
+        {
+            queue->epoch = events->epochs[i];
+        }
+    }
+}
+
+// Clears the results of the events, if any, and queues them all.
+static void decay_events_start(decay_event_queue_t *queue, decay_events_t *events, const decay_state_t *state)
+{
+    queue->events = events;
+    queue->target_period = -INFINITY;
+    queue->epoch = INFINITY;
+    if (events == NULL)
+    {
+        return;
+    }
+
+    for (int i = 0; i < events->altitude_count; i++)
+    {
+        events->crossing_times[i] = -1;
+    }
+    for (int i = 0; i < events->epoch_count; i++)
+    {
+        events->epoch_altitudes[i] = -1;
+    }
+    events->period_time = -1;
+
+    decay_events_rescan(queue, state);
+}
+
+// Locates the pending events that the last step passed up to end.
+static void decay_events_locate(decay_event_queue_t *queue, const decay_state_t *state, double end)
+{
+    decay_events_t *events = queue->events;
+    double end_period = decay_dense_period(state, end);
+
+    if (events->period > 0 && events->period_time < 0 && end_period < events->period)
+    {
+        events->period_time = decay_dense_crossing(state, events->period, end);
+    }
+
+    for (int i = 0; i < events->altitude_count; i++)
+    {
+        double target_period = events->crossing_times[i] < 0 ? decay_event_period(state, events->altitudes[i]) : -INFINITY;
+        if (end_period < target_period)
+        {
+            events->crossing_times[i] = decay_dense_crossing(state, target_period, end);
+        }
+    }
+
+    for (int i = 0; i < events->epoch_count; i++)
+    {
+        // As with the samples, an epoch at the end of the step reports the state itself.
+        if (events->epoch_altitudes[i] < 0 && events->epochs[i] >= 0 && events->epochs[i] <= end)
+        {
+            double altitude = events->epochs[i] == state->elapsed_time ? state->altitude : decay_radius_from_period(decay_dense_period(state, events->epochs[i])) - EARTH_RADIUS;
+            DECAY_COUNT(state, pow_calls, events->epochs[i] != state->elapsed_time);
+            events->epoch_altitudes[i] = altitude / 1000;
+        }
+    }
+
+    decay_events_rescan(queue, state);
+}
+
+// Checks whether the last step, up to end, passed a pending event; only the state at the end is needed otherwise.
+static inline void decay_events_advance(decay_event_queue_t *queue, const decay_state_t *state, double end)
+{
+    if (queue->events != NULL && (end >= queue->epoch || (end == state->elapsed_time ? state->orbital_period : decay_dense_period(state, end)) < queue->target_period))
+    {
+        decay_events_locate(queue, state, end);
+    }
+}
+
+/**
+ * @brief Radius that the quadrature engine's trajectory reaches some time after the state.
+ *
+ * The time to descend from the state's radius is the lifetime integral down to the radius, so the radius is found by Newton's method on that integral, whose derivative is the integrand, with bisection as a safeguard.
+ *
+ */
+static double decay_quadrature_radius(const decay_state_t *state, double upper, double time)
+{
+    double lo = EARTH_RADIUS + KARMAN_LINE, hi = upper;
+    double radius = upper, descent = 0;
+
+    for (int i = 0; i < 64 && fabs(descent - time) > QUADRATURE_TOLERANCE * time && hi - lo > 1e-6; i++)
+    {
+        if (descent > time)
+        {
+            lo = radius;
+        }
+        else
+        {
+            hi = radius;
+        }
+
+        radius += (descent - time) / decay_time_per_radius(state, radius);
+        radius = radius > lo && radius < hi ? radius : 0.5 * (lo + hi);
+        descent = decay_quadrature(state, decay_time_per_radius, radius, upper);
+    }
+
+    return radius;
+}
+
+// Locates the pending events of a quadrature run, which descends from the state without steps, up to its re-entry or time limit at end.
+static void decay_events_quadrature(decay_event_queue_t *queue, const decay_state_t *state, double end)
+{
+    decay_events_t *events = queue->events;
+    if (events == NULL)
+    {
+        return;
+    }
+
+    double lower = EARTH_RADIUS + KARMAN_LINE;
+    double upper = decay_radius_from_period(state->orbital_period);
+    DECAY_COUNT(state, pow_calls, 2);
+
+    if (events->period > 0 && events->period_time < 0 && decay_radius_from_period(events->period) >= lower)
+    {
+        double time = state->elapsed_time + decay_quadrature(state, decay_time_per_radius, decay_radius_from_period(events->period), upper);
+        events->period_time = time <= end ? time : -1;
+    }
+
+    for (int i = 0; i < events->altitude_count; i++)
+    {
+        if (events->crossing_times[i] < 0 && events->altitudes[i] * 1000 >= KARMAN_LINE)
+        {
+            double time = state->elapsed_time + decay_quadrature(state, decay_time_per_radius, EARTH_RADIUS + events->altitudes[i] * 1000, upper);
+            events->crossing_times[i] = time <= end ? time : -1;
+        }
+    }
+
+    for (int i = 0; i < events->epoch_count; i++)
+    {
+        if (events->epoch_altitudes[i] < 0 && events->epochs[i] >= state->elapsed_time && events->epochs[i] <= end)
+        {
+            events->epoch_altitudes[i] = (decay_quadrature_radius(state, upper, events->epochs[i] - state->elapsed_time) - EARTH_RADIUS) / 1000;
+        }
+    }
+}
+
+// Digest of the space weather a propagation follows up to a time. Constant averages are their scale height numerator, which the standard atmosphere ignores.
+static uint64_t decay_checkpoint_weather(const decay_state_t *state, double time)
+{
+    if (state->weather != NULL)
+    {
+        return decay_weather_digest(state->weather, time);
+    }
+    if (state->atmosphere != DECAY_ATMOSPHERE_EXPONENTIAL)
+    {
+        return 0;
+    }
+
+    uint64_t digest;
+    memcpy(&digest, &state->sh_numerator, sizeof(digest));
+    return digest;
+}
+
+// Records the state at the end of a step, which the caller has checked is still in orbit, and returns the time at which the next checkpoint is due.
+static double decay_checkpoint_record(const decay_state_t *state, decay_checkpoints_t *checkpoints)
+{
+    decay_checkpoint_t checkpoint = {
+        .elapsed_time = state->elapsed_time,
+        .orbital_period = state->orbital_period,
+        .orbital_radius = state->orbital_radius,
+        .eccentricity = state->elliptical ? state->eccentricity : 0,
+        .step = state->elliptical ? state->elliptical_step : state->step,
+        .weather = decay_checkpoint_weather(state, state->elapsed_time),
+    };
+    return decay_checkpoints_record(checkpoints, &checkpoint);
+}
+
+/**
+ * @brief Sets an initialized state to a checkpoint.
+ *
+ * Everything else a step starts from is recomputed from the checkpoint as the step itself would: the space weather in effect, the adaptive engine's derivative, and the orbit averages of an elliptical orbit.
+ *
+ */
+static void decay_checkpoint_restore(decay_state_t *state, const decay_checkpoint_t *checkpoint)
+{
+    state->elapsed_time = checkpoint->elapsed_time;
+    state->orbital_period = checkpoint->orbital_period;
+    state->orbital_radius = checkpoint->orbital_radius;
+    state->altitude = checkpoint->orbital_radius - EARTH_RADIUS;
+    if (state->weather != NULL)
+    {
+        state->sh_numerator = decay_weather_sh_numerator(state->weather, state->elapsed_time);
+    }
+
+    state->last_time = state->elapsed_time;
+    state->elliptical = checkpoint->eccentricity > 0;
+    if (state->elliptical)
+    {
+        state->semi_major_axis = checkpoint->orbital_radius;
+        state->eccentricity = checkpoint->eccentricity;
+        state->elliptical_step = checkpoint->step;
+        decay_orbit_nodes(state);
+        decay_orbit_rates(state, state->semi_major_axis, state->eccentricity, &state->axis_rate, &state->eccentricity_rate);
+
+        state->last_axis = state->semi_major_axis;
+        state->last_eccentricity = state->eccentricity;
+        state->last_axis_rate = state->axis_rate;
+        state->last_eccentricity_rate = state->eccentricity_rate;
+        return;
+    }
+
+    if (state->engine == DECAY_ENGINE_ADAPTIVE)
+    {
+        state->step = checkpoint->step;
+        state->period_derivative = decay_period_derivative(state, state->orbital_period);
+    }
+    state->last_period = state->orbital_period;
+    state->last_period_derivative = state->period_derivative;
+}
+
+/**
+ * @brief Resumes a state from the latest usable checkpoint of config->checkpoints and drops the later ones, or clears a set recorded with other inputs.
+ *
+ * @return double Time at which the run's next checkpoint is due.
+ */
+static double decay_checkpoint_resume(decay_state_t *state, const decay_config_t *config, double time_limit)
 {
-    mission_time *= 86400; // Convert mission time (days) to mission time (seconds).
-
-    int time_of_flight = 0;
-    double solar_radio_flux = 70;
+    decay_checkpoints_t *checkpoints = config->checkpoints;
+    const decay_checkpoint_header_t *header = decay_checkpoints_header(checkpoints);
 
-    // While time_of_flight is not within a day of the desired mission time...
-    double increment = 1;
-    bool was_less_than_desired = true;
+    decay_checkpoint_header_t inputs = {
+        .engine = config->engine,
+        .atmosphere = config->atmosphere,
+        .satellite_mass = config->satellite_mass,
+        .satellite_area = config->satellite_area,
+        .altitude = config->altitude,
+        .apogee = config->apogee > config->altitude ? config->apogee : 0,
+        .tolerance = state->tolerance,
+        .step = state->engine == DECAY_ENGINE_FIXED ? state->step : 0,
+    };
 
-    bprintlf("Working...");
+    if (header->engine != inputs.engine || header->atmosphere != inputs.atmosphere || header->satellite_mass != inputs.satellite_mass || header->satellite_area != inputs.satellite_area ||
+        header->altitude != inputs.altitude || header->apogee != inputs.apogee || header->tolerance != inputs.tolerance || header->step != inputs.step)
+    {
+        decay_checkpoints_reset(checkpoints, &inputs);
+        return decay_checkpoints_truncate(checkpoints, 0);
+    }
 
-    for (int attempt = 0; attempt < 100; attempt++)
+    uint32_t count = state->sensitive || config->events != NULL ? 0 : header->count;
+    for (; count > 0; count--)
     {
-        time_of_flight = decay_calculate_suppressed(satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index);
+        const decay_checkpoint_t *checkpoint = decay_checkpoints_get(checkpoints, count - 1);
+        if (checkpoint->elapsed_time <= time_limit && checkpoint->weather == decay_checkpoint_weather(state, checkpoint->elapsed_time))
+        {
+            decay_checkpoint_restore(state, checkpoint);
+            break;
+        }
+    }
+
+    return decay_checkpoints_truncate(checkpoints, count);
+}
 
-        bprintlf("Attempt %d: Descrepancy of %d seconds with SRF of %f.", attempt, time_of_flight - mission_time, solar_radio_flux);
+/**
+ * @brief Propagates the elliptical phase of decay_run_counted(...) until the orbit is nearly circular or its perigee falls below the Karman Line.
+ *
+ * Samples report the semi-major axis as the altitude, with the model period of a circular orbit at that altitude.
+ *
+ * @return int 1 if the run stopped or reached its time limit, with the result set, -1 if a step failed, with the result set to DECAY_STATUS_INVALID, otherwise 0.
+ */
+static int decay_run_elliptical(decay_state_t *state, const decay_config_t *config, decay_result_t *result, double time_limit, double *next_sample, double *next_checkpoint, decay_event_queue_t *queue)
+{
+    bool sampling = config->on_sample != NULL && config->sample_interval > 0;
 
-        if (time_of_flight < mission_time)
+    while (state->semi_major_axis * (1 - state->eccentricity) >= EARTH_RADIUS + KARMAN_LINE)
+    {
+        while (sampling && *next_sample <= state->elapsed_time)
         {
-            if (!was_less_than_desired)
+            double semi_major_axis = state->semi_major_axis, eccentricity = state->eccentricity;
+            decay_orbit_interpolate(state, *next_sample, &semi_major_axis, &eccentricity);
+            DECAY_COUNT(state, pow_calls, 1);
+
+            if (decay_sample(config, state->stats, *next_sample, semi_major_axis - EARTH_RADIUS, decay_period_from_radius(semi_major_axis)) != 0)
             {
-                increment *= 0.5;
-                was_less_than_desired = true;
+                result->status = DECAY_STATUS_STOPPED;
+                result->elapsed_time = state->elapsed_time;
+                result->altitude = state->altitude / 1000;
+                result->orbital_period = state->orbital_period;
+                return 1;
             }
+            *next_sample += config->sample_interval;
+        }
 
-            solar_radio_flux -= increment;
+        if (decay_orbit_variation(state) < ELLIPTICAL_CIRCULAR)
+        {
+            decay_orbit_circularize(state);
+            return 0;
         }
-        else if (time_of_flight > mission_time)
+
+        if (state->elapsed_time >= time_limit)
         {
-            if (was_less_than_desired)
-            {
-                increment *= 0.5;
-                was_less_than_desired = false;
-            }
+            result->status = DECAY_STATUS_LIMIT;
+            result->elapsed_time = state->elapsed_time;
+            result->altitude = state->altitude / 1000;
+            result->orbital_period = state->orbital_period;
+            return 1;
+        }
 
-            solar_radio_flux += increment;
+        if (decay_step_elliptical(state) < 0)
+        {
+            result->status = DECAY_STATUS_INVALID;
+            result->elapsed_time = state->elapsed_time;
+            result->altitude = state->altitude / 1000;
+            result->orbital_period = state->orbital_period;
+            return -1;
         }
-        else
+        result->steps++;
+
+        if (state->semi_major_axis * (1 - state->eccentricity) >= EARTH_RADIUS + KARMAN_LINE)
         {
-            break;
+            decay_events_advance(queue, state, state->elapsed_time);
+            if (state->elapsed_time >= *next_checkpoint)
+            {
+                *next_checkpoint = decay_checkpoint_record(state, config->checkpoints);
+            }
         }
     }
 
-    bprintlf("Desired mission time: %d seconds, %d days.", mission_time, mission_time / 86400);
-    bprintlf("Time of flight found to be %d with a F10.7 index Solar Radio Flux of %f and a Geomagnetic A Index of %f (%d second descrepancy).", time_of_flight, solar_radio_flux, geomagnetic_a_index, time_of_flight - mission_time);
-
-    return solar_radio_flux;
+    return 0;
 }
 
-double decay_max_avg_geo(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, int mission_time)
+/**
+ * @brief decay_run(...) with the propagation's counts and I/O time collected in stats.
+ *
+ */
+static int decay_run_counted(const decay_config_t *config, decay_result_t *result, decay_stats_t *stats)
 {
-    mission_time *= 86400; // Convert mission time (days) to mission time (seconds).
+    result->status = DECAY_STATUS_INVALID;
+    result->lifetime = -1;
+    result->elapsed_time = 0;
+    result->altitude = config->altitude;
+    result->orbital_period = 0;
+    result->steps = 0;
+
+    if (config->sensitivity != NULL)
+    {
+        config->sensitivity->solar_radio_flux = NAN;
+        config->sensitivity->geomagnetic_a_index = NAN;
+        config->sensitivity->area_mass = NAN;
+    }
+
+    if (config->engine < DECAY_ENGINE_FIXED || config->engine > DECAY_ENGINE_QUADRATURE || config->atmosphere < DECAY_ATMOSPHERE_EXPONENTIAL || config->atmosphere > DECAY_ATMOSPHERE_STANDARD ||
+        !(config->satellite_mass > 0) || !(config->satellite_area > 0))
+    {
+        return -1;
+    }
 
-    int time_of_flight = 0;
-    double geomagnetic_a_index = 10;
+    // The exponential model's scale height turns negative above its ceiling, so no orbit reaching it, circular or not, has a defined density.
+    if (config->atmosphere == DECAY_ATMOSPHERE_EXPONENTIAL && !(fmax(config->apogee, config->altitude) < DECAY_ATMOSPHERE_EXPONENTIAL_CEILING))
+    {
+        return -1;
+    }
 
-    // While time_of_flight is not within a day of the desired mission time...
-    double increment = 1;
-    bool was_less_than_desired = true;
+    double time_limit = config->time_limit > 0 ? config->time_limit : LIFETIME_LIMIT;
+    bool sampling = config->on_sample != NULL && config->sample_interval > 0;
 
-    bprintlf("Working...");
+    decay_state_t state;
+    state.stats = stats;
+    state.atmosphere = config->atmosphere;
+    decay_state_init(&state, config->engine, config->satellite_mass, config->satellite_area, config->altitude * 1000, config->solar_radio_flux, config->geomagnetic_a_index, config->weather, config->tolerance);
+    if (state.engine == DECAY_ENGINE_FIXED && config->step > 0)
+    {
+        state.step = config->step;
+    }
+    if (config->apogee > config->altitude)
+    {
+        decay_state_init_elliptical(&state, config->altitude * 1000, config->apogee * 1000);
+    }
+    state.sensitive = config->sensitivity != NULL && !state.elliptical;
+
+    double elapsed_time = 0;
+    double final_altitude = KARMAN_LINE;
+    double final_period = decay_period_from_radius(EARTH_RADIUS + KARMAN_LINE);
+    double next_sample = 0;
+    double next_checkpoint = INFINITY;
 
-    for (int attempt = 0; attempt < 100; attempt++)
+    if (config->checkpoints != NULL && state.engine != DECAY_ENGINE_QUADRATURE)
     {
-        time_of_flight = decay_calculate_suppressed(satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index);
+        next_checkpoint = decay_checkpoint_resume(&state, config, time_limit);
+        if (state.elapsed_time > 0)
+        {
+            next_sample = sampling ? ceil(state.elapsed_time / config->sample_interval) * config->sample_interval : 0;
+            result->elapsed_time = state.elapsed_time;
+            result->altitude = state.altitude / 1000;
+        }
+    }
+    result->orbital_period = state.orbital_period;
+
+    decay_event_queue_t queue;
+    decay_events_start(&queue, config->events, &state);
+    decay_events_advance(&queue, &state, state.elapsed_time);
 
-        bprintlf("Attempt %d: Descrepancy of %d seconds with GEO of %f", attempt, time_of_flight - mission_time, geomagnetic_a_index);
+    int elliptical = state.elliptical ? decay_run_elliptical(&state, config, result, time_limit, &next_sample, &next_checkpoint, &queue) : 0;
+    if (elliptical != 0)
+    {
+        return elliptical < 0 ? -1 : 0;
+    }
 
-        if (time_of_flight < mission_time)
+    if (state.elliptical)
+    {
+        // The perigee fell below the Karman Line before the orbit became circular.
+        elapsed_time = decay_orbit_reentry_time(&state, &final_period);
+        decay_events_advance(&queue, &state, elapsed_time);
+    }
+    else if (state.engine == DECAY_ENGINE_QUADRATURE)
+    {
+        // The quadrature engine has no trajectory, so only the initial state is sampled.
+        if (sampling && next_sample == 0 && decay_sample(config, stats, 0, state.altitude, state.orbital_period) != 0)
         {
-            if (!was_less_than_desired)
-            {
-                increment *= 0.5;
-                was_less_than_desired = true;
-            }
+            result->status = DECAY_STATUS_STOPPED;
+            return 0;
+        }
 
-            geomagnetic_a_index -= increment;
+        elapsed_time = state.elapsed_time + decay_quadrature_lifetime(&state);
+        decay_events_quadrature(&queue, &state, elapsed_time < time_limit ? elapsed_time : time_limit);
+
+        if (state.sensitive)
+        {
+            state.tangent_numerator = decay_quadrature(&state, decay_numerator_slope_per_radius, EARTH_RADIUS + KARMAN_LINE, decay_radius_from_period(state.orbital_period));
+            state.tangent_area_mass = elapsed_time * state.satellite_mass / state.satellite_area;
         }
-        else if (time_of_flight > mission_time)
+    }
+    else
+    {
+        while (state.altitude >= KARMAN_LINE)
         {
-            if (was_less_than_desired)
+            // Samples fall on step boundaries for the fixed engine and are interpolated within the step for the adaptive engine.
+            while (sampling && next_sample <= state.elapsed_time)
+            {
+                double orbital_period = decay_interpolate_period(&state, next_sample);
+                double altitude = next_sample == state.elapsed_time ? state.altitude : decay_radius_from_period(orbital_period) - EARTH_RADIUS;
+                DECAY_COUNT(&state, pow_calls, next_sample != state.elapsed_time);
+
+                if (decay_sample(config, stats, next_sample, altitude, orbital_period) != 0)
+                {
+                    result->status = DECAY_STATUS_STOPPED;
+                    result->elapsed_time = state.elapsed_time;
+                    result->altitude = state.altitude / 1000;
+                    result->orbital_period = state.orbital_period;
+                    return 0;
+                }
+                next_sample += config->sample_interval;
+            }
+
+            if (state.elapsed_time >= time_limit)
             {
-                increment *= 0.5;
-                was_less_than_desired = false;
+                result->status = DECAY_STATUS_LIMIT;
+                result->elapsed_time = state.elapsed_time;
+                result->altitude = state.altitude / 1000;
+                result->orbital_period = state.orbital_period;
+                return 0;
             }
 
-            geomagnetic_a_index += increment;
+            decay_step(&state);
+            result->steps++;
+
+            if (state.sensitive && state.altitude >= KARMAN_LINE)
+            {
+                decay_tangent_advance(&state, state.elapsed_time);
+            }
+            if (state.altitude >= KARMAN_LINE)
+            {
+                decay_events_advance(&queue, &state, state.elapsed_time);
+                if (state.elapsed_time >= next_checkpoint)
+                {
+                    next_checkpoint = decay_checkpoint_record(&state, config->checkpoints);
+                }
+            }
         }
-        else
+
+        elapsed_time = decay_reentry_time(&state);
+        decay_events_advance(&queue, &state, elapsed_time);
+        if (state.sensitive)
         {
-            break;
+            decay_tangent_advance(&state, elapsed_time);
+        }
+        if (state.engine == DECAY_ENGINE_FIXED)
+        {
+            final_altitude = state.altitude;
         }
+        final_period = decay_interpolate_period(&state, elapsed_time);
     }
 
-    bprintlf("Desired mission time: %d seconds, %d days.", mission_time, mission_time / 86400);
-    bprintlf("Time of flight found to be %d with a F10.7 index Solar Radio Flux of %f and a Geomagnetic A Index of %f (%d second descrepancy).", time_of_flight, solar_radio_flux, geomagnetic_a_index, time_of_flight - mission_time);
+    result->status = elapsed_time > time_limit ? DECAY_STATUS_LIMIT : DECAY_STATUS_REENTERED;
+    result->lifetime = elapsed_time > time_limit ? -1 : elapsed_time;
+    result->elapsed_time = elapsed_time;
+    result->altitude = final_altitude / 1000;
+    result->orbital_period = final_period;
 
-    return solar_radio_flux;
+    if (state.sensitive && result->status == DECAY_STATUS_REENTERED)
+    {
+        decay_tangent_finish(&state, config->sensitivity);
+    }
+
+    return 0;
 }
 
-int decay_calculate_suppressed(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index)
+int decay_run(const decay_config_t *config, decay_result_t *result)
 {
-    altitude *= 1000;                                                                                        // Convert altitude (km) to altitude (m).
-    int delta_time = TEMPORAL_RESOLUTION;                                                                    // Change in time per iteration measured in whole seconds.
-    int elapsed_time = 0;                                                                                    // Elapsed time measured in whole seconds.
-    double orbital_radius = EARTH_RADIUS + altitude;                                                         // Orbital radius measured in meters.
-    double orbital_period = 2.0 * PI * sqrt(pow(orbital_radius, 3.0) / EARTH_MASS / GRAVITATIONAL_CONSTANT); // Orbital period measured in fractional seconds.
+    decay_stats_t stats = {0};
+    double start = decay_stats_clock();
 
-    double SH = 0.0;                  // A placeholder calculation for atmospheric_density.
-    double atmospheric_density = 0.0; // Atmospheric density at the satellite's current altitude.
-    double delta_period = 0.0;        // Change in orbital period from previous iteration.
+    int retval = decay_run_counted(config, result, &stats);
 
-    while (altitude >= KARMAN_LINE)
+    if (decay_stats_enabled())
     {
-        SH = (900 + 2.5 * (solar_radio_flux - 70) + 1.5 * geomagnetic_a_index) / (27 - 0.012 * ((altitude / 1000) - 200));
-        atmospheric_density = 6e-10 * exp(-((altitude / 1000) - 175) / SH);
+        stats.runs = result->status != DECAY_STATUS_INVALID;
+        stats.steps = result->steps;
+        stats.physics_time = decay_stats_clock() - start - stats.io_time;
+        decay_stats_add(&stats);
+    }
 
-        delta_period = 3 * PI * satellite_area / satellite_mass * orbital_radius * atmospheric_density * (double)delta_time;
+    return retval;
+}
 
-        if (elapsed_time >= 1.577e9)
-        {
-            bprintlf("Satellite lifetime exceeds 50 years.");
-            return -1;
-        }
+// Lifetime from an altitude in kilometers under either constant space weather or a history.
+static double decay_lifetime(decay_engine_t engine, double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, const decay_weather_t *weather, double tolerance, double time_limit)
+{
+    decay_config_t config = {
+        .engine = engine,
+        .satellite_mass = satellite_mass,
+        .satellite_area = satellite_area,
+        .altitude = altitude,
+        .solar_radio_flux = solar_radio_flux,
+        .geomagnetic_a_index = geomagnetic_a_index,
+        .weather = weather,
+        .tolerance = tolerance,
+        .time_limit = time_limit,
+    };
+    decay_result_t result;
+
+    decay_run(&config, &result);
+    return result.lifetime;
+}
 
-        orbital_period -= delta_period;
-        elapsed_time += delta_time;
-        orbital_radius = pow((pow(orbital_period, 2.0) * GRAVITATIONAL_CONSTANT * EARTH_MASS / 4 / pow(PI, 2.0)), 0.33333);
-        altitude = orbital_radius - EARTH_RADIUS;
+double decay_circular_period(double altitude)
+{
+    return decay_initial_period(EARTH_RADIUS + altitude * 1000);
+}
+
+double decay_model_period(double altitude)
+{
+    return decay_period_from_radius(EARTH_RADIUS + altitude * 1000);
+}
+
+double decay_calculate_lifetime(decay_engine_t engine, double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, double tolerance, double time_limit)
+{
+    return decay_lifetime(engine, satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index, NULL, tolerance, time_limit);
+}
+
+double decay_calculate_lifetime_weather(decay_engine_t engine, double satellite_mass, double satellite_area, double altitude, const decay_weather_t *weather, double tolerance, double time_limit)
+{
+    return decay_lifetime(engine, satellite_mass, satellite_area, altitude, 0, 0, weather, tolerance, time_limit);
+}
+
+double decay_estimate_lifetime(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index)
+{
+    decay_config_t config = {
+        .engine = DECAY_ENGINE_QUADRATURE,
+        .satellite_mass = satellite_mass,
+        .satellite_area = satellite_area,
+        .altitude = altitude,
+        .solar_radio_flux = solar_radio_flux,
+        .geomagnetic_a_index = geomagnetic_a_index,
+        .time_limit = INFINITY,
+    };
+    decay_result_t result;
+    decay_stats_t stats = {0}; // Discarded.
+
+    decay_run_counted(&config, &result, &stats);
+    return result.lifetime;
+}
+
+double decay_estimate_cost(decay_engine_t engine, double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index)
+{
+    if (engine != DECAY_ENGINE_FIXED)
+    {
+        return 1;
     }
 
-    return elapsed_time;
+    double lifetime = decay_estimate_lifetime(satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index);
+    return lifetime < 0 ? 1 : lifetime < LIFETIME_LIMIT ? lifetime : LIFETIME_LIMIT;
+}
+
+double decay_calculate_adaptive(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, double tolerance)
+{
+    return decay_calculate_lifetime(DECAY_ENGINE_ADAPTIVE, satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index, tolerance, LIFETIME_LIMIT);
+}
+
+double decay_calculate_quadrature(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index)
+{
+    return decay_calculate_lifetime(DECAY_ENGINE_QUADRATURE, satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index, 0, LIFETIME_LIMIT);
 }
 
-int decay_calculate(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, bool save_to_csv, int runs, float run_increment)
+// Initial altitude in meters of a sweep's run (1-based), computed exactly as the runs of decay_calculate(...) are.
+static inline double decay_run_altitude(double altitude, float run_increment, int i)
 {
-    altitude *= 1000;     
     int orig_altitude = altitude;
-    run_increment *= 1000;          
-                                                                             // Convert altitude (km) to altitude (m).
-    int elapsed_time = 0;                                                                                    // Elapsed time measured in whole seconds.
-    double orbital_radius = EARTH_RADIUS + altitude;                                                         // Orbital radius measured in meters.
-    double orbital_period = 2.0 * PI * sqrt(pow(orbital_radius, 3.0) / EARTH_MASS / GRAVITATIONAL_CONSTANT); // Orbital period measured in fractional seconds.
+    return i == 1 ? altitude : orig_altitude + ((i - 1) * run_increment);
+}
+
+double decay_sweep_altitude(double altitude, float run_increment, int run)
+{
+    return decay_run_altitude(altitude * 1000, run_increment * 1000, run) / 1000;
+}
+
+int decay_calculate_sweep(decay_engine_t engine, double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, int runs, float run_increment, double tolerance, double *lifetimes)
+{
+    altitude *= 1000;       // Convert altitude (km) to altitude (m).
+    run_increment *= 1000;
+
+    decay_stats_t stats = {0};
+    stats.runs = 1;
+    double start = decay_stats_clock();
+
+    decay_state_t state;
+    state.stats = &stats;
+    state.atmosphere = DECAY_ATMOSPHERE_EXPONENTIAL;
+    decay_state_init(&state, engine, satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index, NULL, tolerance);
 
-    double SH = 0.0;                  // A placeholder calculation for atmospheric_density.
-    double atmospheric_density = 0.0; // Atmospheric density at the satellite's current altitude.
-    double delta_period = 0.0;        // Change in orbital period from previous iteration.
+    // Accumulate the lifetime of each level over the band below it. This is the whole calculation for the quadrature engine and picks the highest level worth integrating for the others.
+    int top = -1;
+    double lower = EARTH_RADIUS + KARMAN_LINE;
+    double lifetime = 0;
+    for (int run = 0; run < runs; run++)
+    {
+        double upper = decay_radius_from_period(decay_initial_period(EARTH_RADIUS + decay_run_altitude(altitude, run_increment, run + 1)));
+        lifetime += decay_quadrature(&state, decay_time_per_radius, lower, upper);
+        lower = upper;
+
+        lifetimes[run] = lifetime >= LIFETIME_LIMIT ? -1 : lifetime;
+
+        // Leave a margin so that levels just past the limit by this estimate are still checked by the engine itself.
+        if (lifetime < 1.01 * LIFETIME_LIMIT)
+        {
+            top = run;
+        }
+    }
+
+    if (engine == DECAY_ENGINE_QUADRATURE || top < 0)
+    {
+        stats.physics_time = decay_stats_clock() - start;
+        decay_stats_add(&stats);
+        return 0;
+    }
+
+    // Integrate once from the highest level, recording the time at which each lower level's initial period is passed.
+    decay_state_init(&state, engine, satellite_mass, satellite_area, decay_run_altitude(altitude, run_increment, top + 1), solar_radio_flux, geomagnetic_a_index, NULL, tolerance);
 
-    FILE* fp = NULL;
-    if (save_to_csv)
+    lifetimes[top] = 0;
+    int next = top - 1;
+    double next_period = next >= 0 ? decay_initial_period(EARTH_RADIUS + decay_run_altitude(altitude, run_increment, next + 1)) : 0;
+
+    while (state.altitude >= KARMAN_LINE)
     {
-        fp = fopen("data.csv", "a");
-        if (fp == NULL)
+        if (state.elapsed_time >= 2 * LIFETIME_LIMIT)
+        {
+            break;
+        }
+
+        decay_step(&state);
+        stats.steps++;
+
+        while (next >= 0 && state.orbital_period <= next_period)
         {
-            save_to_csv = false;
+            lifetimes[next] = decay_crossing_time(&state, next_period);
+            next--;
+            next_period = next >= 0 ? decay_initial_period(EARTH_RADIUS + decay_run_altitude(altitude, run_increment, next + 1)) : 0;
         }
     }
 
-    bprintlf("\nBEGIN CALCULATION");
-    if (save_to_csv) {fprintf(fp, "BEGIN CALCULATION\n");}
-    for (int i = 1; i <= runs; i++)
+    // Lifetime of each level is the re-entry time less the time taken to descend to it.
+    double reentry_time = state.altitude < KARMAN_LINE ? decay_reentry_time(&state) : INFINITY;
+    for (int run = 0; run <= top; run++)
+    {
+        lifetime = run > next ? reentry_time - lifetimes[run] : INFINITY;
+        lifetimes[run] = lifetime >= LIFETIME_LIMIT ? -1 : lifetime;
+    }
+    for (int run = top + 1; run < runs; run++)
+    {
+        lifetimes[run] = -1;
+    }
+
+    stats.physics_time = decay_stats_clock() - start;
+    decay_stats_add(&stats);
+
+    return 0;
+}
+
+int decay_normalize(double altitude, double solar_radio_flux, double geomagnetic_a_index, double tolerance, decay_normalized_t *normalized)
+{
+    tolerance = tolerance > 0 ? tolerance : ADAPTIVE_TOLERANCE;
+
+    // With an area-to-mass ratio of 1 m^2/kg, elapsed time is normalized time.
+    double coarse = decay_calculate_lifetime(DECAY_ENGINE_ADAPTIVE, 1, 1, altitude, solar_radio_flux, geomagnetic_a_index, tolerance, INFINITY);
+    double fine = decay_calculate_lifetime(DECAY_ENGINE_ADAPTIVE, 1, 1, altitude, solar_radio_flux, geomagnetic_a_index, tolerance / NORMALIZED_REFINEMENT, INFINITY);
+    if (coarse < 0 || fine < 0)
+    {
+        return -1;
+    }
+
+    normalized->altitude = altitude;
+    normalized->solar_radio_flux = solar_radio_flux;
+    normalized->geomagnetic_a_index = geomagnetic_a_index;
+    normalized->normalized_lifetime = fine;
+
+    // The refined run's own error is bounded by its tolerance; the difference between the runs checks that the controller actually met it.
+    normalized->error_bound = fabs(coarse - fine) / (NORMALIZED_REFINEMENT - 1) + fine * tolerance / NORMALIZED_REFINEMENT;
+
+    return 0;
+}
+
+double decay_normalized_lifetime(const decay_normalized_t *normalized, double satellite_mass, double satellite_area, double *error_bound)
+{
+    double area_mass = satellite_area / satellite_mass;
+    double lifetime = normalized->normalized_lifetime / area_mass;
+
+    if (error_bound != NULL)
+    {
+        *error_bound = normalized->error_bound / area_mass;
+    }
+
+    return lifetime >= LIFETIME_LIMIT ? -1 : lifetime;
+}
+
+int decay_reentry_before(decay_engine_t engine, double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, double target_time)
+{
+    return decay_calculate_lifetime(engine, satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index, ADAPTIVE_TOLERANCE, target_time) >= 0;
+}
+
+/**
+ * @brief Inputs to the maximum average activity solvers.
+ *
+ * Exactly one of solar_radio_flux and geomagnetic_a_index is the unknown; index points at it.
+ *
+ */
+typedef struct
+{
+    decay_engine_t engine;
+    double satellite_mass;
+    double satellite_area;
+    double altitude;
+    double solar_radio_flux;
+    double geomagnetic_a_index;
+    double *index;
+    double mission_time; // Seconds.
+    const char *name;    // Name of the unknown for print-outs.
+    int attempts;
+    bool verbose;        // Print every attempt and the outcome.
+} decay_solver_t;
+
+/**
+ * @brief Log of the time of flight over the mission time at the given index, and its slope.
+ *
+ * Runs are abandoned at SOLVER_CUTOFF times the mission time, so the result is clipped to log(SOLVER_CUTOFF). The clipped function is still continuous and decreasing in the index, which is all the root finder needs.
+ *
+ * @param slope Set to the derivative with respect to the index from the lifetime's sensitivity, or to NAN where the result is clipped.
+ */
+static double decay_solver_evaluate(decay_solver_t *solver, double index, double *slope)
+{
+    *solver->index = index;
+    double time_limit = SOLVER_CUTOFF * solver->mission_time;
+
+    decay_sensitivity_t sensitivity;
+    decay_config_t config = {
+        .engine = solver->engine,
+        .satellite_mass = solver->satellite_mass,
+        .satellite_area = solver->satellite_area,
+        .altitude = solver->altitude,
+        .solar_radio_flux = solver->solar_radio_flux,
+        .geomagnetic_a_index = solver->geomagnetic_a_index,
+        .tolerance = ADAPTIVE_TOLERANCE,
+        .time_limit = time_limit,
+        .sensitivity = &sensitivity,
+    };
+
+    decay_result_t result;
+    decay_run(&config, &result);
+    double time_of_flight = result.lifetime;
+
+    if (time_of_flight < 0)
+    {
+        if (solver->verbose) {bprintlf("Attempt %d: Descrepancy of more than %.0f seconds with %s of %f.", solver->attempts, time_limit - solver->mission_time, solver->name, index);}
+        solver->attempts++;
+        *slope = NAN;
+        return log(SOLVER_CUTOFF);
+    }
+
+    if (solver->verbose) {bprintlf("Attempt %d: Descrepancy of %.0f seconds with %s of %f.", solver->attempts, time_of_flight - solver->mission_time, solver->name, index);}
+    solver->attempts++;
+    *slope = (solver->index == &solver->solar_radio_flux ? sensitivity.solar_radio_flux : sensitivity.geomagnetic_a_index) / time_of_flight;
+    return log(time_of_flight / solver->mission_time);
+}
+
+/**
+ * @brief Finds the largest index that still meets the mission time.
+ *
+ * Takes Newton steps on the log of the time of flight, using the slope carried by the propagation, and keeps the bracket of indices that do and do not meet the mission time. Each Newton step is overshot by a third of the tolerance, so that once it is accurate the next evaluation lands on the other side and closes the bracket below tolerance; a solve typically takes three to five runs. Where the slope is unavailable (clipped runs) or a step leaves the bracket, it falls back to doubling steps away from the guess until the root is bracketed, then to the Illinois variant of regula falsi. The end of the bracket that still meets the mission time is returned.
+ *
+ */
+static double decay_solve_bracket(decay_solver_t *solver, double guess, double tolerance)
+{
+    double index = guess < 0 ? 0 : guess;
+    double slope = NAN;
+    double value = decay_solver_evaluate(solver, index, &slope);
+    double step = index > 40 ? index / 4 : 10;
+
+    double lower = 0, lower_value = 0, upper = 0, upper_value = 0;
+    bool have_lower = false, have_upper = false;
+    int stale_side = 0; // -1 if the lower end was kept on the last bracketed iteration, 1 if the upper end was.
+
+    while (true)
     {
-        bprintlf("RUN %d/%d", i, runs);
-        bprintlf("TIME (days)\tHEIGHT (km)\t\tPERIOD (minutes)");
-        if (save_to_csv) {fprintf(fp, "\nRUN %d/%d\n", i, runs);}
-        if (save_to_csv) {fprintf(fp, "TIME (days), HEIGHT (km), PERIOD (minutes)\n");}
+        // The time of flight decreases with activity, so a longer flight than desired means the root lies above.
+        if (value >= 0)
+        {
+            if (have_lower && have_upper && stale_side == 1)
+            {
+                upper_value *= 0.5;
+            }
+            stale_side = 1;
+            lower = index;
+            lower_value = value;
+            have_lower = true;
+        }
+        else
+        {
+            if (have_lower && have_upper && stale_side == -1)
+            {
+                lower_value *= 0.5;
+            }
+            stale_side = -1;
+            upper = index;
+            upper_value = value;
+            have_upper = true;
+        }
 
-        while (altitude >= KARMAN_LINE)
+        if (value == 0 || (have_lower && have_upper && upper - lower <= tolerance) || solver->attempts >= SOLVER_MAX_ATTEMPTS)
         {
-            SH = (900 + 2.5 * (solar_radio_flux - 70) + 1.5 * geomagnetic_a_index) / (27 - 0.012 * ((altitude / 1000) - 200));
-            atmospheric_density = 6e-10 * exp(-((altitude / 1000) - 175) / SH);
+            break;
+        }
 
-            delta_period = 3 * PI * satellite_area / satellite_mass * orbital_radius * atmospheric_density * (double)TEMPORAL_RESOLUTION;
+        double newton = NAN;
+        if (slope < 0)
+        {
+            newton = index - value / slope + (value > 0 ? tolerance : -tolerance) / 3;
+        }
 
-            // TODO: Devise a more advanced print-out method.
-            if (elapsed_time % (7 * 86400) == 0) // 86400 sec = 1 day
+        if (have_lower && have_upper)
+        {
+            index = newton > lower && newton < upper ? newton : (lower * upper_value - upper * lower_value) / (upper_value - lower_value);
+            if (!(index > lower && index < upper))
             {
-                bprintlf("%d\t\t%f\t\t%f", elapsed_time / 86400, altitude / 1000, orbital_period);
-                if (save_to_csv) {fprintf(fp, "%d, %f, %f\n", elapsed_time / 86400, altitude / 1000, orbital_period);}
+                index = 0.5 * (lower + upper);
+            }
+        }
+        else if (!have_upper)
+        {
+            index = newton > index && newton < index + 4 * step ? newton : index + step;
+            step *= 2;
 
-                if (elapsed_time >= 1.577e9)
-                {
-                    bprintlf("Satellite lifetime exceeds 50 years.");
-                    if (save_to_csv) {fprintf(fp, "Satellite lifetime exceeds 50 years.\n");}
-                    return -1;
-                }
+            if (index > SOLVER_MAX_INDEX)
+            {
+                if (solver->verbose) {bprintlf("The mission time is met up to the largest %s searched (%.0f).", solver->name, SOLVER_MAX_INDEX);}
+                return -1;
+            }
+        }
+        else
+        {
+            if (index == 0)
+            {
+                if (solver->verbose) {bprintlf("The mission time cannot be met even with a %s of zero.", solver->name);}
+                return -1;
             }
 
-            orbital_period -= delta_period;
-            elapsed_time += TEMPORAL_RESOLUTION;
-            orbital_radius = pow((pow(orbital_period, 2.0) * GRAVITATIONAL_CONSTANT * EARTH_MASS / 4 / pow(PI, 2.0)), 0.33333);
-            altitude = orbital_radius - EARTH_RADIUS;
+            index = newton < index && newton > index - 4 * step ? newton : index - step;
+            index = index < 0 ? 0 : index;
+            step *= 2;
         }
 
-        // Final print-out.
-        bprintlf("%d\t\t%f\t\t%f\n", elapsed_time / 86400, altitude / 1000, orbital_period);
-        if (save_to_csv) {fprintf(fp, "%d, %f, %f\n", elapsed_time / 86400, altitude / 1000, orbital_period);}
+        value = decay_solver_evaluate(solver, index, &slope);
+    }
+
+    if (value != 0 && !have_upper)
+    {
+        if (solver->verbose) {bprintlf("The mission time is met up to the largest %s searched (%.0f).", solver->name, index);}
+        return -1;
+    }
+
+    if (!have_lower)
+    {
+        if (solver->verbose) {bprintlf("The mission time cannot be met even with a %s of %f.", solver->name, index);}
+        return -1;
+    }
+
+    return lower;
+}
+
+// decay_solve_bracket(...), recording the solve's iterations and whether it found an answer.
+static double decay_solve_max_avg(decay_solver_t *solver, double guess, double tolerance)
+{
+    double index = decay_solve_bracket(solver, guess, tolerance);
+
+    decay_stats_t stats = {0};
+    stats.solves = 1;
+    stats.solver_iterations = solver->attempts;
+    stats.solver_failures = index < 0 || solver->attempts >= SOLVER_MAX_ATTEMPTS;
+    decay_stats_add(&stats);
+
+    return index;
+}
 
-        bprintlf("Re-entry after %f days (%f years).\n", (double)elapsed_time / (3600 * 24), (double)elapsed_time / (3600 * 24 * 365));
-        if (save_to_csv) {fprintf(fp, "\nRe-entry after %f days (%f years).\n\n", (double)elapsed_time / (3600 * 24), (double)elapsed_time / (3600 * 24 * 365));}
+double decay_max_avg_srf(double satellite_mass, double satellite_area, double altitude, double geomagnetic_a_index, int mission_time, decay_engine_t engine, double guess, double tolerance)
+{
+    decay_solver_t solver = {
+        .engine = engine,
+        .satellite_mass = satellite_mass,
+        .satellite_area = satellite_area,
+        .altitude = altitude,
+        .geomagnetic_a_index = geomagnetic_a_index,
+        .mission_time = mission_time * 86400.0, // Convert mission time (days) to mission time (seconds).
+        .name = "SRF",
+        .verbose = true,
+    };
+    solver.index = &solver.solar_radio_flux;
+
+    bprintlf("Working...");
 
-        // Reset everything for next run.
-        altitude = orig_altitude + (i * run_increment);
-        elapsed_time = 0;                                                                                  
-        orbital_radius = EARTH_RADIUS + altitude;                                                        
-        orbital_period = 2.0 * PI * sqrt(pow(orbital_radius, 3.0) / EARTH_MASS / GRAVITATIONAL_CONSTANT);
-        SH = 0.0;
-        atmospheric_density = 0.0;
-        delta_period = 0.0;
+    double solar_radio_flux = decay_solve_max_avg(&solver, guess > 0 ? guess : SOLVER_GUESS_SRF, tolerance > 0 ? tolerance : SOLVER_TOLERANCE);
+    if (solar_radio_flux < 0)
+    {
+        return -1;
     }
 
-    bprintlf("END CALCULATION");
-    if (save_to_csv) {fprintf(fp, "END CALCULATION\n");}
-    bprintlf("------------------------------------------");
-    if (save_to_csv) {fprintf(fp, "------------------------------------------\n\n");}
+    bprintlf("Desired mission time: %.0f seconds, %d days.", solver.mission_time, mission_time);
+    bprintlf("Time of flight meets the mission time with a F10.7 index Solar Radio Flux of up to %f and a Geomagnetic A Index of %f (%d runs).", solar_radio_flux, geomagnetic_a_index, solver.attempts);
 
-    if (fp != NULL)
+    return solar_radio_flux;
+}
+
+double decay_max_avg_geo(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, int mission_time, decay_engine_t engine, double guess, double tolerance)
+{
+    decay_solver_t solver = {
+        .engine = engine,
+        .satellite_mass = satellite_mass,
+        .satellite_area = satellite_area,
+        .altitude = altitude,
+        .solar_radio_flux = solar_radio_flux,
+        .mission_time = mission_time * 86400.0, // Convert mission time (days) to mission time (seconds).
+        .name = "GEO",
+        .verbose = true,
+    };
+    solver.index = &solver.geomagnetic_a_index;
+
+    bprintlf("Working...");
+
+    double geomagnetic_a_index = decay_solve_max_avg(&solver, guess > 0 ? guess : SOLVER_GUESS_GEO, tolerance > 0 ? tolerance : SOLVER_TOLERANCE);
+    if (geomagnetic_a_index < 0)
     {
-        fclose(fp);
+        return -1;
     }
 
-    return elapsed_time;
+    bprintlf("Desired mission time: %.0f seconds, %d days.", solver.mission_time, mission_time);
+    bprintlf("Time of flight meets the mission time with a F10.7 index Solar Radio Flux of %f and a Geomagnetic A Index of up to %f (%d runs).", solar_radio_flux, geomagnetic_a_index, solver.attempts);
+
+    return geomagnetic_a_index;
+}
+
+double decay_max_avg_srf_suppressed(double satellite_mass, double satellite_area, double altitude, double geomagnetic_a_index, double mission_time, decay_engine_t engine, double guess, double tolerance)
+{
+    decay_solver_t solver = {
+        .engine = engine,
+        .satellite_mass = satellite_mass,
+        .satellite_area = satellite_area,
+        .altitude = altitude,
+        .geomagnetic_a_index = geomagnetic_a_index,
+        .mission_time = mission_time * 86400.0,
+        .name = "SRF",
+        .verbose = false,
+    };
+    solver.index = &solver.solar_radio_flux;
+
+    return decay_solve_max_avg(&solver, guess > 0 ? guess : SOLVER_GUESS_SRF, tolerance > 0 ? tolerance : SOLVER_TOLERANCE);
+}
+
+double decay_max_avg_geo_suppressed(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double mission_time, decay_engine_t engine, double guess, double tolerance)
+{
+    decay_solver_t solver = {
+        .engine = engine,
+        .satellite_mass = satellite_mass,
+        .satellite_area = satellite_area,
+        .altitude = altitude,
+        .solar_radio_flux = solar_radio_flux,
+        .mission_time = mission_time * 86400.0,
+        .name = "GEO",
+        .verbose = false,
+    };
+    solver.index = &solver.geomagnetic_a_index;
+
+    return decay_solve_max_avg(&solver, guess > 0 ? guess : SOLVER_GUESS_GEO, tolerance > 0 ? tolerance : SOLVER_TOLERANCE);
 }
 
 // TODO: Stop the UI from backing out to calculation selection after performing a calculation.
@@ -0,0 +1,123 @@
+/**
+ * @file decay_atmosphere.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Atmospheric density models.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include "decay.h"
+#include "decay_atmosphere.h"
+
+#define ATMOSPHERE_NODES ((int)MAX_ALTITUDE + 2) // 1 km nodes from the surface past MAX_ALTITUDE.
+
+/**
+ * @brief One band of the piecewise-exponential standard atmosphere.
+ *
+ */
+typedef struct
+{
+    double base;         // Base altitude in kilometers.
+    double density;      // Density at the base in kg/m^3.
+    double scale_height; // Kilometers.
+} decay_atmosphere_band_t;
+
+// Bands of the standard model; the last band continues above 1000 km.
+static const decay_atmosphere_band_t decay_atmosphere_bands[] = {
+    {0, 1.225, 7.249}, {25, 3.899e-2, 6.349}, {30, 1.774e-2, 6.682}, {40, 3.972e-3, 7.554},
+    {50, 1.057e-3, 8.382}, {60, 3.206e-4, 7.714}, {70, 8.770e-5, 6.549}, {80, 1.905e-5, 5.799},
+    {90, 3.396e-6, 5.382}, {100, 5.297e-7, 5.877}, {110, 9.661e-8, 7.263}, {120, 2.438e-8, 9.473},
+    {130, 8.484e-9, 12.636}, {140, 3.845e-9, 16.149}, {150, 2.070e-9, 22.523}, {180, 5.464e-10, 29.740},
+    {200, 2.789e-10, 37.105}, {250, 7.248e-11, 45.546}, {300, 2.418e-11, 53.628}, {350, 9.518e-12, 53.298},
+    {400, 3.725e-12, 58.515}, {450, 1.585e-12, 60.828}, {500, 6.967e-13, 63.822}, {600, 1.454e-13, 71.835},
+    {700, 3.614e-14, 88.667}, {800, 1.170e-14, 124.64}, {900, 5.245e-15, 181.05}, {1000, 3.019e-15, 268.00},
+};
+
+static double decay_atmosphere_node_density[ATMOSPHERE_NODES];       // kg/m^3 at each whole kilometer.
+static double decay_atmosphere_node_inverse_height[ATMOSPHERE_NODES]; // 1 / scale height in 1/km of the bin above each node.
+static double decay_atmosphere_node_correction[ATMOSPHERE_NODES];     // Linear term that closes the polynomial's error at the end of the bin.
+static pthread_once_t decay_atmosphere_once = PTHREAD_ONCE_INIT;
+
+// exp(-x) for x below 1 / 5.382, the steepest band, with a relative error under x^5 / 120.
+static inline double decay_atmosphere_decay(double x)
+{
+    return 1 - x * (1 - x * (0.5 - x * (1.0 / 6 - x * (1.0 / 24))));
+}
+
+// Band boundaries fall on whole kilometers, so every bin lies within one band.
+static void decay_atmosphere_build(void)
+{
+    int band = 0;
+    int bands = sizeof(decay_atmosphere_bands) / sizeof(decay_atmosphere_bands[0]);
+
+    for (int i = 0; i < ATMOSPHERE_NODES; i++)
+    {
+        while (band + 1 < bands && decay_atmosphere_bands[band + 1].base <= i)
+        {
+            band++;
+        }
+
+        const decay_atmosphere_band_t *b = &decay_atmosphere_bands[band];
+        decay_atmosphere_node_density[i] = b->density * exp(-(i - b->base) / b->scale_height);
+        decay_atmosphere_node_inverse_height[i] = 1 / b->scale_height;
+    }
+
+    // Without the correction the density would jump by the polynomial's error at every node, which the error control of the adaptive engines would chase.
+    for (int i = 0; i + 1 < ATMOSPHERE_NODES; i++)
+    {
+        decay_atmosphere_node_correction[i] = decay_atmosphere_node_density[i + 1] - decay_atmosphere_node_density[i] * decay_atmosphere_decay(decay_atmosphere_node_inverse_height[i]);
+    }
+}
+
+double decay_atmosphere_standard(double altitude)
+{
+    pthread_once(&decay_atmosphere_once, decay_atmosphere_build);
+
+    double km = altitude / 1000;
+    km = km < 0 ? 0 : km > ATMOSPHERE_NODES - 1 ? ATMOSPHERE_NODES - 1 : km;
+
+    int node = (int)km;
+    node = node > ATMOSPHERE_NODES - 2 ? ATMOSPHERE_NODES - 2 : node;
+
+    double fraction = km - node;
+    return decay_atmosphere_node_density[node] * decay_atmosphere_decay(fraction * decay_atmosphere_node_inverse_height[node]) + decay_atmosphere_node_correction[node] * fraction;
+}
+
+int decay_atmosphere_breaks(decay_atmosphere_t model, double lower, double upper, double *breaks, int size)
+{
+    if (model != DECAY_ATMOSPHERE_STANDARD)
+    {
+        return 0;
+    }
+
+    int count = 0;
+    int bands = sizeof(decay_atmosphere_bands) / sizeof(decay_atmosphere_bands[0]);
+    for (int band = 1; band < bands && count < size; band++)
+    {
+        double base = decay_atmosphere_bands[band].base * 1000;
+        if (base > lower && base < upper)
+        {
+            breaks[count++] = base;
+        }
+    }
+
+    return count;
+}
+
+double decay_atmosphere_density(decay_atmosphere_t model, double altitude, double sh_numerator)
+{
+    switch (model)
+    {
+    case DECAY_ATMOSPHERE_EXPONENTIAL:
+        return decay_atmosphere_exponential(altitude, sh_numerator);
+    case DECAY_ATMOSPHERE_STANDARD:
+        return decay_atmosphere_standard(altitude);
+    default:
+        return NAN;
+    }
+}
@@ -0,0 +1,137 @@
+/**
+ * @file decay_batch.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Batched fixed-step decay calculations for many satellites in lockstep.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <meb_print.h>
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+#include "decay_batch.h"
+#include "decay_stats.h"
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define DECAY_BATCH_X86
+#endif
+
+/**
+ * @brief Loads the next unstarted satellite into a lane, or parks the lane if none are left.
+ *
+ * Parked lanes are given a drag-free orbit at 400 km so that the vector kernels can keep stepping them without producing infinities or NaNs.
+ *
+ * @return true A satellite was loaded.
+ * @return false The lane was parked.
+ */
+static inline bool decay_batch_load(int lane, int next, int count, const double *satellite_mass, const double *satellite_area, const double *altitude, const double *solar_radio_flux, const double *geomagnetic_a_index,
+                                    double *lane_period, double *lane_radius, double *lane_altitude, double *lane_time, double *lane_drag, double *lane_numerator, long long *lane_active, int *lane_index)
+{
+    bool loaded = next < count;
+    double initial_altitude = loaded ? altitude[next] * 1000 : 400000;
+
+    lane_radius[lane] = EARTH_RADIUS + initial_altitude;
+    lane_period[lane] = 2.0 * PI * sqrt(pow(lane_radius[lane], 3.0) / EARTH_MASS / GRAVITATIONAL_CONSTANT);
+    lane_altitude[lane] = initial_altitude;
+    lane_time[lane] = 0;
+    lane_drag[lane] = loaded ? 3 * PI * satellite_area[next] / satellite_mass[next] : 0;
+    lane_numerator[lane] = loaded ? 900 + 2.5 * (solar_radio_flux[next] - 70) + 1.5 * geomagnetic_a_index[next] : 900;
+    lane_active[lane] = loaded ? -1 : 0;
+    lane_index[lane] = loaded ? next : -1;
+
+    return loaded;
+}
+
+static void decay_batch_scalar(int count, const double *satellite_mass, const double *satellite_area, const double *altitude, const double *solar_radio_flux, const double *geomagnetic_a_index, double *lifetimes)
+{
+    for (int i = 0; i < count; i++)
+    {
+        lifetimes[i] = decay_calculate_lifetime(DECAY_ENGINE_FIXED, satellite_mass[i], satellite_area[i], altitude[i], solar_radio_flux[i], geomagnetic_a_index[i], 0, LIFETIME_LIMIT);
+    }
+}
+
+#ifdef DECAY_BATCH_X86
+
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#define DECAY_BATCH_LANES 4
+#define DECAY_BATCH_NAME(x) decay_batch_avx2_##x
+#include "decay_batch_kernel.h"
+#undef DECAY_BATCH_NAME
+#undef DECAY_BATCH_LANES
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#define DECAY_BATCH_LANES 8
+#define DECAY_BATCH_NAME(x) decay_batch_avx512_##x
+#include "decay_batch_kernel.h"
+#undef DECAY_BATCH_NAME
+#undef DECAY_BATCH_LANES
+#pragma GCC pop_options
+
+#endif // DECAY_BATCH_X86
+
+decay_batch_isa_t decay_batch_isa(void)
+{
+#ifdef DECAY_BATCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return DECAY_BATCH_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        return DECAY_BATCH_AVX2;
+    }
+#endif
+    return DECAY_BATCH_SCALAR;
+}
+
+int decay_calculate_batch(int count, const double *satellite_mass, const double *satellite_area, const double *altitude, const double *solar_radio_flux, const double *geomagnetic_a_index, double *lifetimes, decay_batch_isa_t isa)
+{
+    decay_batch_isa_t supported = decay_batch_isa();
+
+    if (isa == DECAY_BATCH_AUTO)
+    {
+        isa = supported;
+    }
+    else if (isa > supported)
+    {
+        dbprintlf(RED_FG "Instruction set %d is not supported by this CPU.", isa);
+        return -1;
+    }
+
+    decay_stats_t stats = {0};
+    double start = decay_stats_clock();
+
+    switch (isa)
+    {
+#ifdef DECAY_BATCH_X86
+    case DECAY_BATCH_AVX512:
+        decay_batch_avx512_run(count, satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index, lifetimes);
+        break;
+    case DECAY_BATCH_AVX2:
+        decay_batch_avx2_run(count, satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index, lifetimes);
+        break;
+#endif
+    default:
+        isa = DECAY_BATCH_SCALAR;
+        decay_batch_scalar(count, satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index, lifetimes);
+        break;
+    }
+
+    // The scalar path counts its runs through decay_run(...).
+    if (isa != DECAY_BATCH_SCALAR)
+    {
+        stats.runs = count;
+        stats.physics_time = decay_stats_clock() - start;
+        decay_stats_add(&stats);
+    }
+
+    return isa;
+}
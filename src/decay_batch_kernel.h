@@ -0,0 +1,174 @@
+/**
+ * @file decay_batch_kernel.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Vector kernel template for decay_batch.c.
+ *
+ * Included once per instruction set with DECAY_BATCH_LANES and DECAY_BATCH_NAME(x) defined, inside a matching GCC target region. Uses GCC vector extensions so that the same source compiles to AVX2 or AVX-512.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+typedef double DECAY_BATCH_NAME(vd) __attribute__((vector_size(DECAY_BATCH_LANES * sizeof(double))));
+typedef long long DECAY_BATCH_NAME(vi) __attribute__((vector_size(DECAY_BATCH_LANES * sizeof(long long))));
+
+#define VD DECAY_BATCH_NAME(vd)
+#define VI DECAY_BATCH_NAME(vi)
+
+// exp(x) for |x| < 700: x = n ln2 + r with |r| <= ln2 / 2, then a degree 13 Taylor polynomial for exp(r).
+static inline VD DECAY_BATCH_NAME(exp)(VD x)
+{
+    const double shifter = 6755399441055744.0; // 1.5 * 2^52; adding it rounds to an integer held in the low mantissa bits.
+
+    VD t = x * 1.4426950408889634 + shifter;
+    VD n = t - shifter;
+    VD r = x - n * 6.93147180369123816490e-01 - n * 1.90821492927058770002e-10;
+
+    VD p = r * (1.0 / 6227020800.0) + (1.0 / 479001600.0);
+    p = p * r + (1.0 / 39916800.0);
+    p = p * r + (1.0 / 3628800.0);
+    p = p * r + (1.0 / 362880.0);
+    p = p * r + (1.0 / 40320.0);
+    p = p * r + (1.0 / 5040.0);
+    p = p * r + (1.0 / 720.0);
+    p = p * r + (1.0 / 120.0);
+    p = p * r + (1.0 / 24.0);
+    p = p * r + (1.0 / 6.0);
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+
+    // 2^n, built directly in the exponent field.
+    VD shifter_vector = (VD){0} + shifter;
+    VI scale = (((VI)t - (VI)shifter_vector) + 1023) << 52;
+    return p * (VD)scale;
+}
+
+// log(x) for positive normal x: x = m 2^e with sqrt(1/2) <= m < sqrt(2), then log(m) = 2 atanh(s) with s = (m - 1) / (m + 1).
+static inline VD DECAY_BATCH_NAME(log)(VD x)
+{
+    const double magic = 4503599627370496.0; // 2^52; OR-ing a small integer into its mantissa converts it to double.
+
+    VI bits = (VI)x;
+    VI biased_exponent = (bits >> 52) & 0x7FF;
+    VD m = (VD)((bits & 0x000FFFFFFFFFFFFFLL) | 0x3FF0000000000000LL);
+
+    VD magic_vector = (VD){0} + magic;
+    VD e = (VD)(biased_exponent | (VI)magic_vector) - (magic + 1023);
+
+    VI large = m > 1.4142135623730951; // All bits set where m must be halved.
+    m = (VD)(((VI)(m * 0.5) & large) | ((VI)m & ~large));
+    e = e + (VD)((VI)((VD){0} + 1.0) & large);
+
+    VD s = (m - 1.0) / (m + 1.0);
+    VD s2 = s * s;
+
+    VD p = s2 * (1.0 / 23) + (1.0 / 21);
+    p = p * s2 + (1.0 / 19);
+    p = p * s2 + (1.0 / 17);
+    p = p * s2 + (1.0 / 15);
+    p = p * s2 + (1.0 / 13);
+    p = p * s2 + (1.0 / 11);
+    p = p * s2 + (1.0 / 9);
+    p = p * s2 + (1.0 / 7);
+    p = p * s2 + (1.0 / 5);
+    p = p * s2 + (1.0 / 3);
+    p = p * s2 + 1.0;
+
+    return e * 6.93147180559945286227e-01 + 2 * s * p;
+}
+
+/**
+ * @brief Runs every satellite through DECAY_BATCH_LANES lanes, refilling lanes as satellites finish.
+ *
+ * Lane state is kept in arrays between bursts of vector steps; a burst ends as soon as any active lane is done, so the bookkeeping is scalar and rare.
+ *
+ */
+static void DECAY_BATCH_NAME(run)(int count, const double *satellite_mass, const double *satellite_area, const double *altitude, const double *solar_radio_flux, const double *geomagnetic_a_index, double *lifetimes)
+{
+    double lane_period[DECAY_BATCH_LANES], lane_radius[DECAY_BATCH_LANES], lane_altitude[DECAY_BATCH_LANES], lane_time[DECAY_BATCH_LANES];
+    double lane_drag[DECAY_BATCH_LANES], lane_numerator[DECAY_BATCH_LANES];
+    long long lane_active[DECAY_BATCH_LANES];
+    int lane_index[DECAY_BATCH_LANES];
+
+    int next = 0;
+    int active = 0;
+
+    for (int lane = 0; lane < DECAY_BATCH_LANES; lane++)
+    {
+        if (decay_batch_load(lane, next, count, satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index, lane_period, lane_radius, lane_altitude, lane_time, lane_drag, lane_numerator, lane_active, lane_index))
+        {
+            next++;
+            active++;
+        }
+    }
+
+    while (active > 0)
+    {
+        VD P, r, h, t, drag, numerator;
+        VI mask;
+        memcpy(&P, lane_period, sizeof(P));
+        memcpy(&r, lane_radius, sizeof(r));
+        memcpy(&h, lane_altitude, sizeof(h));
+        memcpy(&t, lane_time, sizeof(t));
+        memcpy(&drag, lane_drag, sizeof(drag));
+        memcpy(&numerator, lane_numerator, sizeof(numerator));
+        memcpy(&mask, lane_active, sizeof(mask));
+
+        for (;;)
+        {
+            VI done = mask & ((h < (double)KARMAN_LINE) | (t >= LIFETIME_LIMIT));
+
+            long long any = 0;
+            for (int lane = 0; lane < DECAY_BATCH_LANES; lane++)
+            {
+                any |= done[lane];
+            }
+            if (any)
+            {
+                break;
+            }
+
+            // Same expressions, in the same order, as decay_step_fixed(...) in decay.c.
+            VD altitude_km = h / 1000.0;
+            VD SH = numerator / (27.0 - 0.012 * (altitude_km - 200.0));
+            VD density = 6e-10 * DECAY_BATCH_NAME(exp)(-(altitude_km - 175.0) / SH);
+
+            P = P - drag * r * density * (double)TEMPORAL_RESOLUTION;
+            t = t + (double)TEMPORAL_RESOLUTION;
+            r = DECAY_BATCH_NAME(exp)(0.33333 * DECAY_BATCH_NAME(log)(P * P * GRAVITATIONAL_CONSTANT * EARTH_MASS / 4.0 / (PI * PI)));
+            h = r - (double)EARTH_RADIUS;
+        }
+
+        memcpy(lane_period, &P, sizeof(P));
+        memcpy(lane_radius, &r, sizeof(r));
+        memcpy(lane_altitude, &h, sizeof(h));
+        memcpy(lane_time, &t, sizeof(t));
+
+        for (int lane = 0; lane < DECAY_BATCH_LANES; lane++)
+        {
+            if (!lane_active[lane] || !(lane_altitude[lane] < KARMAN_LINE || lane_time[lane] >= LIFETIME_LIMIT))
+            {
+                continue;
+            }
+
+            // As in decay_calculate_lifetime(...), a re-entry during the step that passes 50 years also counts as exceeding it.
+            lifetimes[lane_index[lane]] = lane_altitude[lane] < KARMAN_LINE && lane_time[lane] <= LIFETIME_LIMIT ? lane_time[lane] : -1;
+
+            if (decay_batch_load(lane, next, count, satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index, lane_period, lane_radius, lane_altitude, lane_time, lane_drag, lane_numerator, lane_active, lane_index))
+            {
+                next++;
+            }
+            else
+            {
+                active--;
+            }
+        }
+    }
+}
+
+#undef VD
+#undef VI
@@ -0,0 +1,614 @@
+/**
+ * @file decay_catalog.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Re-entry screening of a catalog of two-line element sets.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <meb_print.h>
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pool.h"
+#include "decay_catalog.h"
+#include "decay_file.h"
+#include "decay_stats.h"
+
+#define CATALOG_LINE 69            // Characters in a full element set line.
+#define CATALOG_LINE1_USED 61      // Characters of the first line that are read, through B*.
+#define CATALOG_LINE2_USED 63      // Characters of the second line that are read, through the mean motion.
+#define CATALOG_BYTES_PER_OBJECT 140 // Two lines and their line breaks; sizes the first allocation.
+#define CATALOG_MAX_LINE 512
+
+/**
+ * @brief Area-to-mass ratio of one object of the mass and area map.
+ *
+ */
+typedef struct
+{
+    int catalog;
+    double area_mass;
+} decay_catalog_entry_t;
+
+static const char *decay_catalog_sources[] = {"none", "bstar", "map"};
+
+// Length of a line up to its line break or terminator, reading no more than max characters.
+static int decay_catalog_line_length(const char *line, int max)
+{
+    int length = 0;
+    while (length < max && line[length] != '\n' && line[length] != '\r' && line[length] != '\0')
+    {
+        length++;
+    }
+    return length;
+}
+
+// Parses a fixed-width decimal field such as " 15.72125391", which may be padded with blanks on either side.
+static int decay_catalog_decimal(const char *text, int width, double *value)
+{
+    int i = 0;
+    while (i < width && text[i] == ' ')
+    {
+        i++;
+    }
+
+    double sign = 1;
+    if (i < width && (text[i] == '-' || text[i] == '+'))
+    {
+        sign = text[i++] == '-' ? -1 : 1;
+    }
+
+    double whole = 0, fraction = 0, scale = 1;
+    int digits = 0;
+    while (i < width && isdigit((unsigned char)text[i]))
+    {
+        whole = whole * 10 + (text[i++] - '0');
+        digits++;
+    }
+    if (i < width && text[i] == '.')
+    {
+        i++;
+        while (i < width && isdigit((unsigned char)text[i]))
+        {
+            fraction = fraction * 10 + (text[i++] - '0');
+            scale *= 10;
+            digits++;
+        }
+    }
+    while (i < width && text[i] == ' ')
+    {
+        i++;
+    }
+
+    if (digits == 0 || i != width)
+    {
+        return -1;
+    }
+
+    *value = sign * (whole + fraction / scale);
+    return 0;
+}
+
+// Parses an exponential field with an implied leading decimal point, such as " 34123-4" for 0.34123e-4.
+static int decay_catalog_exponential(const char *text, double *value)
+{
+    if (text[0] != ' ' && text[0] != '-' && text[0] != '+')
+    {
+        return -1;
+    }
+
+    double mantissa = 0;
+    for (int i = 1; i < 6; i++)
+    {
+        if (text[i] != ' ' && !isdigit((unsigned char)text[i]))
+        {
+            return -1;
+        }
+        mantissa = mantissa * 10 + (text[i] == ' ' ? 0 : text[i] - '0');
+    }
+
+    if ((text[6] != '-' && text[6] != '+' && text[6] != ' ') || !isdigit((unsigned char)text[7]))
+    {
+        return -1;
+    }
+
+    int exponent = (text[6] == '-' ? -1 : 1) * (text[7] - '0');
+    *value = (text[0] == '-' ? -1 : 1) * mantissa * 1e-5 * pow(10, exponent);
+    return 0;
+}
+
+// Parses a catalog number of up to five characters, numeric or Alpha-5 (a letter other than I or O for the ten-thousands, from A = 10).
+static int decay_catalog_number(const char *text, int width, int *number)
+{
+    while (width > 0 && *text == ' ')
+    {
+        text++;
+        width--;
+    }
+    while (width > 0 && text[width - 1] == ' ')
+    {
+        width--;
+    }
+
+    if (width < 1 || width > 5)
+    {
+        return -1;
+    }
+
+    int value = 0;
+    int i = 0;
+    char letter = toupper((unsigned char)text[0]);
+    if (width == 5 && letter >= 'A' && letter <= 'Z' && letter != 'I' && letter != 'O')
+    {
+        value = 10 + (letter - 'A') - (letter > 'I') - (letter > 'O');
+        i = 1;
+    }
+
+    for (; i < width; i++)
+    {
+        if (!isdigit((unsigned char)text[i]))
+        {
+            return -1;
+        }
+        value = value * 10 + (text[i] - '0');
+    }
+
+    *number = value;
+    return 0;
+}
+
+// Writes the date of a number of days since 1970-01-01 as YYYY-MM-DD.
+static void decay_catalog_write_date(FILE *output, double days)
+{
+    long z = (long)floor(days) + 719468;
+    long era = (z >= 0 ? z : z - 146096) / 146097;
+    long day_of_era = z - era * 146097;
+    long year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    long day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    long month_index = (5 * day_of_year + 2) / 153;
+    long day = day_of_year - (153 * month_index + 2) / 5 + 1;
+    long month = month_index < 10 ? month_index + 3 : month_index - 9;
+    long year = year_of_era + era * 400 + (month <= 2);
+
+    fprintf(output, "%04ld-%02ld-%02ld", year, month, day);
+}
+
+int decay_catalog_parse(const char *line1, const char *line2, decay_catalog_object_t *object)
+{
+    memset(object, 0, sizeof(*object));
+    object->lifetime = NAN;
+
+    if (decay_catalog_line_length(line1, CATALOG_LINE) < CATALOG_LINE1_USED || decay_catalog_line_length(line2, CATALOG_LINE) < CATALOG_LINE2_USED ||
+        line1[0] != '1' || line1[1] != ' ' || line2[0] != '2' || line2[1] != ' ')
+    {
+        return -1;
+    }
+
+    // Columns are 1-based in the format's description and 0-based here.
+    int catalog = 0, catalog2 = 0;
+    double year = 0, day = 0, eccentricity = 0, mean_motion = 0;
+    if (decay_catalog_number(line1 + 2, 5, &catalog) < 0 || decay_catalog_number(line2 + 2, 5, &catalog2) < 0 || catalog != catalog2 ||
+        decay_catalog_decimal(line1 + 18, 2, &year) < 0 || decay_catalog_decimal(line1 + 20, 12, &day) < 0 ||
+        decay_catalog_exponential(line1 + 53, &object->bstar) < 0 ||
+        decay_catalog_decimal(line2 + 26, 7, &eccentricity) < 0 ||
+        decay_catalog_decimal(line2 + 52, 11, &mean_motion) < 0 || !(mean_motion > 0))
+    {
+        return -1;
+    }
+
+    // Two-digit years run from 1957 to 2056.
+    int full_year = year < 57 ? 2000 + (int)year : 1900 + (int)year;
+    object->catalog = catalog;
+    object->epoch = decay_file_days_from_civil(full_year, 1, 1) + day - 1;
+
+    // Semi-major axis of the orbit, which is the radius of the circular orbit with the same period. The eccentricity has an assumed leading decimal point.
+    double period = 86400 / mean_motion;
+    double orbital_radius = cbrt(period * period * GRAVITATIONAL_CONSTANT * EARTH_MASS / (4 * PI * PI));
+    object->altitude = (orbital_radius - EARTH_RADIUS) / 1000;
+    object->eccentricity = eccentricity / 1e7;
+
+    return 0;
+}
+
+// Copies a name line, without a leading "0 " or surrounding blanks.
+static void decay_catalog_set_name(decay_catalog_object_t *object, const char *line, int length)
+{
+    if (length >= 2 && line[0] == '0' && line[1] == ' ')
+    {
+        line += 2;
+        length -= 2;
+    }
+    while (length > 0 && isspace((unsigned char)*line))
+    {
+        line++;
+        length--;
+    }
+    while (length > 0 && isspace((unsigned char)line[length - 1]))
+    {
+        length--;
+    }
+
+    length = length < DECAY_CATALOG_NAME - 1 ? length : DECAY_CATALOG_NAME - 1;
+    memcpy(object->name, line, length);
+    object->name[length] = '\0';
+}
+
+/**
+ * @brief Parses every element set of a loaded catalog in one pass over the text.
+ *
+ * Lines are parsed where they lie. Only a final line without a line break, which could end within the columns that are read, is copied first.
+ *
+ */
+static int decay_catalog_parse_all(const char *text, size_t size, decay_catalog_object_t **objects, int *count)
+{
+    int capacity = size / CATALOG_BYTES_PER_OBJECT + 16;
+    decay_catalog_object_t *list = malloc(capacity * sizeof(decay_catalog_object_t));
+    if (list == NULL)
+    {
+        return -1;
+    }
+
+    const char *end = text + size;
+    const char *line = text;
+    const char *previous = NULL; // Line before the current one, a possible name.
+    int previous_length = 0;
+    int found = 0, malformed = 0;
+    char last[2][CATALOG_LINE + 1];
+
+    while (line < end)
+    {
+        const char *next = memchr(line, '\n', end - line);
+        int length = (next != NULL ? next : end) - line;
+        next = next != NULL ? next + 1 : end;
+
+        if (length >= 2 && line[0] == '1' && line[1] == ' ')
+        {
+            const char *line2 = next;
+            const char *after = line2 < end ? memchr(line2, '\n', end - line2) : NULL;
+            int length2 = line2 < end ? (after != NULL ? after : end) - line2 : 0;
+
+            if (length2 >= 2 && line2[0] == '2' && line2[1] == ' ')
+            {
+                const char *first = line, *second = line2;
+                if (after == NULL)
+                {
+                    // The catalog ends without a line break; copy the lines so that parsing stops within them.
+                    int copy1 = length < CATALOG_LINE ? length : CATALOG_LINE, copy2 = length2 < CATALOG_LINE ? length2 : CATALOG_LINE;
+                    memcpy(last[0], line, copy1);
+                    last[0][copy1] = '\0';
+                    memcpy(last[1], line2, copy2);
+                    last[1][copy2] = '\0';
+                    first = last[0];
+                    second = last[1];
+                }
+
+                if (found == capacity)
+                {
+                    capacity *= 2;
+                    decay_catalog_object_t *grown = realloc(list, capacity * sizeof(decay_catalog_object_t));
+                    if (grown == NULL)
+                    {
+                        free(list);
+                        return -1;
+                    }
+                    list = grown;
+                }
+
+                if (decay_catalog_parse(first, second, &list[found]) == 0)
+                {
+                    if (previous != NULL)
+                    {
+                        decay_catalog_set_name(&list[found], previous, previous_length);
+                    }
+                    found++;
+                }
+                else
+                {
+                    malformed++;
+                }
+
+                previous = NULL;
+                line = after != NULL ? after + 1 : end;
+                continue;
+            }
+        }
+
+        previous = line;
+        previous_length = length;
+        line = next;
+    }
+
+    if (malformed > 0)
+    {
+        dbprintlf(YELLOW_FG "Skipped %d malformed element sets.", malformed);
+    }
+
+    *objects = list;
+    *count = found;
+    return 0;
+}
+
+static int decay_catalog_entry_compare(const void *a, const void *b)
+{
+    const decay_catalog_entry_t *x = a, *y = b;
+    return (x->catalog > y->catalog) - (x->catalog < y->catalog);
+}
+
+// Reads a mass and area map into an array sorted by catalog number.
+static int decay_catalog_map_load(const char *path, decay_catalog_entry_t **entries, int *count)
+{
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        erprintlf(errno);
+        return -1;
+    }
+
+    int capacity = 256, found = 0, line = 0;
+    decay_catalog_entry_t *list = malloc(capacity * sizeof(decay_catalog_entry_t));
+    char text[CATALOG_MAX_LINE];
+
+    while (list != NULL && fgets(text, sizeof(text), fp) != NULL)
+    {
+        line++;
+
+        char *save = NULL;
+        char *fields[3];
+        int fields_found = 0;
+        for (char *field = strtok_r(text, ", \t\r\n", &save); field != NULL && fields_found < 3; field = strtok_r(NULL, ", \t\r\n", &save))
+        {
+            fields[fields_found++] = field;
+        }
+
+        if (fields_found == 0 || fields[0][0] == '#')
+        {
+            continue;
+        }
+
+        int catalog = 0;
+        char *mass_end = NULL, *area_end = NULL;
+        double mass = fields_found == 3 ? strtod(fields[1], &mass_end) : 0;
+        double area = fields_found == 3 ? strtod(fields[2], &area_end) : 0;
+        if (fields_found != 3 || decay_catalog_number(fields[0], strlen(fields[0]), &catalog) < 0 || *mass_end != '\0' || *area_end != '\0' || !(mass > 0) || !(area > 0))
+        {
+            dbprintlf(YELLOW_FG "Skipped line %d of %s: expected CATALOG MASS AREA.", line, path);
+            continue;
+        }
+
+        if (found == capacity)
+        {
+            capacity *= 2;
+            decay_catalog_entry_t *grown = realloc(list, capacity * sizeof(decay_catalog_entry_t));
+            if (grown == NULL)
+            {
+                free(list);
+                list = NULL;
+                break;
+            }
+            list = grown;
+        }
+        list[found++] = (decay_catalog_entry_t){catalog, area / mass};
+    }
+    fclose(fp);
+
+    if (list == NULL)
+    {
+        dbprintlf(RED_FG "Failed to allocate the map of %s.", path);
+        return -1;
+    }
+
+    qsort(list, found, sizeof(decay_catalog_entry_t), decay_catalog_entry_compare);
+    *entries = list;
+    *count = found;
+    return 0;
+}
+
+typedef struct
+{
+    decay_catalog_object_t *objects;
+    const pool_order_t *order; // Most expensive first.
+    const decay_catalog_options_t *options;
+} decay_catalog_screen_t;
+
+static void decay_catalog_job(int index, void *context)
+{
+    decay_catalog_screen_t *screen = context;
+    const decay_catalog_options_t *options = screen->options;
+    decay_catalog_object_t *object = &screen->objects[screen->order[index].index];
+
+    object->lifetime = NAN;
+
+    double orbital_radius = EARTH_RADIUS + object->altitude * 1000;
+    double perigee = orbital_radius * (1 - object->eccentricity) - EARTH_RADIUS;
+    double apogee = orbital_radius * (1 + object->eccentricity) - EARTH_RADIUS;
+
+    // The exponential model stops at its ceiling for circular and elliptical orbits alike, while the standard atmosphere also covers high elliptical orbits.
+    if (object->source == DECAY_CATALOG_NONE ||
+        (options->atmosphere == DECAY_ATMOSPHERE_EXPONENTIAL && !(apogee / 1000 < DECAY_ATMOSPHERE_EXPONENTIAL_CEILING)))
+    {
+        return;
+    }
+
+    // Elements with a perigee below the Karman Line belong to an object that is already coming down.
+    if (perigee <= KARMAN_LINE)
+    {
+        object->lifetime = 0;
+        return;
+    }
+
+    decay_config_t config = {
+        .engine = options->engine,
+        .satellite_mass = 1,
+        .satellite_area = object->area_mass,
+        .altitude = perigee / 1000,
+        .solar_radio_flux = options->solar_radio_flux,
+        .geomagnetic_a_index = options->geomagnetic_a_index,
+        .tolerance = options->tolerance,
+        .time_limit = LIFETIME_LIMIT,
+        .atmosphere = options->atmosphere,
+        .apogee = apogee / 1000,
+    };
+
+    decay_result_t result;
+    if (decay_run(&config, &result) == 0)
+    {
+        object->lifetime = result.lifetime;
+    }
+}
+
+// 0 for objects that re-enter within 50 years, 1 for longer lifetimes, and 2 for objects that were not propagated.
+static inline int decay_catalog_class(const decay_catalog_object_t *object)
+{
+    return isnan(object->lifetime) ? 2 : object->lifetime < 0 ? 1 : 0;
+}
+
+// Orders by re-entry date, soonest first, then by catalog number.
+static int decay_catalog_rank_compare(const void *a, const void *b)
+{
+    const decay_catalog_object_t *x = a, *y = b;
+    int x_class = decay_catalog_class(x), y_class = decay_catalog_class(y);
+    if (x_class != y_class)
+    {
+        return x_class - y_class;
+    }
+
+    if (x_class == 0)
+    {
+        double x_date = x->epoch + x->lifetime / 86400, y_date = y->epoch + y->lifetime / 86400;
+        if (x_date != y_date)
+        {
+            return (x_date > y_date) - (x_date < y_date);
+        }
+    }
+    return (x->catalog > y->catalog) - (x->catalog < y->catalog);
+}
+
+// Writes a name as a CSV field, quoted if it holds a comma or a quote.
+static void decay_catalog_write_name(FILE *output, const char *name)
+{
+    if (strpbrk(name, ",\"") == NULL)
+    {
+        fputs(name, output);
+        return;
+    }
+
+    fputc('"', output);
+    for (const char *c = name; *c != '\0'; c++)
+    {
+        if (*c == '"')
+        {
+            fputc('"', output);
+        }
+        fputc(*c, output);
+    }
+    fputc('"', output);
+}
+
+int decay_catalog_run(const char *path, const char *map_path, FILE *output, const decay_catalog_options_t *options)
+{
+    decay_catalog_entry_t *entries = NULL;
+    int entry_count = 0;
+    if (map_path != NULL && decay_catalog_map_load(map_path, &entries, &entry_count) < 0)
+    {
+        return -1;
+    }
+
+    decay_file_t file;
+    if (decay_file_map(path, true, &file) < 0)
+    {
+        free(entries);
+        return -1;
+    }
+
+    decay_catalog_object_t *objects = NULL;
+    int count = 0;
+    int retval = decay_catalog_parse_all(file.data, file.size, &objects, &count);
+    decay_file_release(&file);
+
+    pool_order_t *order = retval == 0 ? malloc((count > 0 ? count : 1) * sizeof(pool_order_t)) : NULL;
+    if (order == NULL)
+    {
+        dbprintlf(RED_FG "Failed to allocate the objects of %s.", path);
+        free(entries);
+        free(objects);
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        decay_catalog_object_t *object = &objects[i];
+        decay_catalog_entry_t key = {.catalog = object->catalog};
+        const decay_catalog_entry_t *entry = entry_count > 0 ? bsearch(&key, entries, entry_count, sizeof(decay_catalog_entry_t), decay_catalog_entry_compare) : NULL;
+
+        if (entry != NULL)
+        {
+            object->area_mass = entry->area_mass;
+            object->source = DECAY_CATALOG_MAP;
+        }
+        else if (object->bstar > 0)
+        {
+            object->area_mass = 2 * object->bstar / DECAY_CATALOG_BSTAR_RHO;
+            object->source = DECAY_CATALOG_BSTAR;
+        }
+
+        order[i].cost = 1;
+        order[i].index = i;
+        if (object->source != DECAY_CATALOG_NONE && object->altitude * 1000 > KARMAN_LINE && object->altitude <= MAX_ALTITUDE)
+        {
+            order[i].cost = decay_estimate_cost(options->engine, 1, object->area_mass, object->altitude, options->solar_radio_flux, options->geomagnetic_a_index);
+        }
+    }
+    free(entries);
+
+    pool_order(order, count);
+    decay_catalog_screen_t screen = {.objects = objects, .order = order, .options = options};
+    pool_run(count, options->threads, decay_catalog_job, &screen);
+    free(order);
+
+    qsort(objects, count, sizeof(decay_catalog_object_t), decay_catalog_rank_compare);
+
+    decay_stats_t stats = {0};
+    double start = decay_stats_clock();
+
+    int rows = options->limit > 0 && options->limit < count ? options->limit : count;
+    fprintf(output, "rank,catalog,name,epoch,altitude,area_mass,source,days,reentry\n");
+    for (int i = 0; i < rows; i++)
+    {
+        const decay_catalog_object_t *object = &objects[i];
+
+        fprintf(output, "%d,%d,", i + 1, object->catalog);
+        decay_catalog_write_name(output, object->name);
+        fputc(',', output);
+        decay_catalog_write_date(output, object->epoch);
+        fprintf(output, ",%.3f,%g,%s,", object->altitude, object->area_mass, decay_catalog_sources[object->source]);
+
+        if (isnan(object->lifetime))
+        {
+            fprintf(output, ",\n");
+        }
+        else if (object->lifetime < 0)
+        {
+            fprintf(output, "-1,\n");
+        }
+        else
+        {
+            fprintf(output, "%.3f,", object->lifetime / 86400);
+            decay_catalog_write_date(output, object->epoch + object->lifetime / 86400);
+            fputc('\n', output);
+        }
+    }
+    fflush(output);
+
+    stats.io_time = decay_stats_clock() - start;
+    decay_stats_add(&stats);
+
+    free(objects);
+    return count;
+}
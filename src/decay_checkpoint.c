@@ -0,0 +1,211 @@
+/**
+ * @file decay_checkpoint.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Checkpoints of a propagation, from which a later run resumes.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <meb_print.h>
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "decay_checkpoint.h"
+
+struct decay_checkpoints
+{
+    decay_checkpoint_header_t header;
+    uint32_t capacity;
+    decay_checkpoint_t *checkpoints;
+};
+
+static decay_checkpoints_t *decay_checkpoints_allocate(uint32_t capacity)
+{
+    decay_checkpoints_t *checkpoints = calloc(1, sizeof(decay_checkpoints_t));
+    if (checkpoints == NULL)
+    {
+        return NULL;
+    }
+
+    checkpoints->capacity = capacity;
+    checkpoints->checkpoints = malloc(capacity * sizeof(decay_checkpoint_t));
+    if (checkpoints->checkpoints == NULL)
+    {
+        free(checkpoints);
+        return NULL;
+    }
+
+    return checkpoints;
+}
+
+decay_checkpoints_t *decay_checkpoints_create(double interval)
+{
+    decay_checkpoints_t *checkpoints = decay_checkpoints_allocate(DECAY_CHECKPOINT_CAPACITY);
+    if (checkpoints == NULL)
+    {
+        dbprintlf(RED_FG "Failed to allocate %d checkpoints.", DECAY_CHECKPOINT_CAPACITY);
+        return NULL;
+    }
+
+    decay_checkpoint_header_t *header = &checkpoints->header;
+    memcpy(header->magic, DECAY_CHECKPOINT_MAGIC, sizeof(header->magic));
+    header->version = DECAY_CHECKPOINT_VERSION;
+    header->header_size = sizeof(decay_checkpoint_header_t);
+    header->byte_order = DECAY_CHECKPOINT_BYTE_ORDER;
+    header->count = 0;
+    header->interval = interval > 0 ? interval : DECAY_CHECKPOINT_INTERVAL;
+    header->engine = -1; // Matches no propagation until the first run resets it.
+
+    return checkpoints;
+}
+
+decay_checkpoints_t *decay_checkpoints_open(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        // A missing file is a set not yet saved.
+        if (errno != ENOENT)
+        {
+            erprintlf(errno);
+        }
+        return NULL;
+    }
+
+    decay_checkpoint_header_t header;
+    decay_checkpoints_t *checkpoints = NULL;
+    if (fread(&header, sizeof(header), 1, fp) != 1 ||
+        memcmp(header.magic, DECAY_CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != DECAY_CHECKPOINT_VERSION ||
+        header.byte_order != DECAY_CHECKPOINT_BYTE_ORDER ||
+        header.header_size != sizeof(decay_checkpoint_header_t) ||
+        !(header.interval > 0))
+    {
+        dbprintlf(RED_FG "%s is not a version %d checkpoint file for this host.", path, DECAY_CHECKPOINT_VERSION);
+    }
+    else if ((checkpoints = decay_checkpoints_allocate(header.count > DECAY_CHECKPOINT_CAPACITY ? header.count : DECAY_CHECKPOINT_CAPACITY)) == NULL)
+    {
+        dbprintlf(RED_FG "Failed to allocate %u checkpoints.", header.count);
+    }
+    else if (fread(checkpoints->checkpoints, sizeof(decay_checkpoint_t), header.count, fp) != header.count)
+    {
+        dbprintlf(RED_FG "%s holds fewer than its %u checkpoints.", path, header.count);
+        decay_checkpoints_close(checkpoints);
+        checkpoints = NULL;
+    }
+    else
+    {
+        checkpoints->header = header;
+    }
+
+    fclose(fp);
+    return checkpoints;
+}
+
+int decay_checkpoints_save(const decay_checkpoints_t *checkpoints, const char *path)
+{
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        erprintlf(errno);
+        return -1;
+    }
+
+    size_t count = checkpoints->header.count;
+    int retval = 0;
+    if (fwrite(&checkpoints->header, sizeof(decay_checkpoint_header_t), 1, fp) != 1 ||
+        fwrite(checkpoints->checkpoints, sizeof(decay_checkpoint_t), count, fp) != count)
+    {
+        erprintlf(errno);
+        retval = -1;
+    }
+
+    if (fclose(fp) != 0)
+    {
+        retval = -1;
+    }
+
+    return retval;
+}
+
+void decay_checkpoints_close(decay_checkpoints_t *checkpoints)
+{
+    if (checkpoints == NULL)
+    {
+        return;
+    }
+
+    free(checkpoints->checkpoints);
+    free(checkpoints);
+}
+
+const decay_checkpoint_header_t *decay_checkpoints_header(const decay_checkpoints_t *checkpoints)
+{
+    return &checkpoints->header;
+}
+
+const decay_checkpoint_t *decay_checkpoints_get(const decay_checkpoints_t *checkpoints, uint32_t index)
+{
+    return &checkpoints->checkpoints[index];
+}
+
+void decay_checkpoints_reset(decay_checkpoints_t *checkpoints, const decay_checkpoint_header_t *inputs)
+{
+    decay_checkpoint_header_t *header = &checkpoints->header;
+    header->count = 0;
+    header->engine = inputs->engine;
+    header->atmosphere = inputs->atmosphere;
+    header->satellite_mass = inputs->satellite_mass;
+    header->satellite_area = inputs->satellite_area;
+    header->altitude = inputs->altitude;
+    header->apogee = inputs->apogee;
+    header->tolerance = inputs->tolerance;
+    header->step = inputs->step;
+}
+
+// The first multiple of the interval after the latest checkpoint.
+static double decay_checkpoints_next(const decay_checkpoints_t *checkpoints)
+{
+    const decay_checkpoint_header_t *header = &checkpoints->header;
+    if (header->count == 0)
+    {
+        return header->interval;
+    }
+
+    return (floor(checkpoints->checkpoints[header->count - 1].elapsed_time / header->interval) + 1) * header->interval;
+}
+
+double decay_checkpoints_truncate(decay_checkpoints_t *checkpoints, uint32_t count)
+{
+    if (count < checkpoints->header.count)
+    {
+        checkpoints->header.count = count;
+    }
+
+    return decay_checkpoints_next(checkpoints);
+}
+
+double decay_checkpoints_record(decay_checkpoints_t *checkpoints, const decay_checkpoint_t *checkpoint)
+{
+    decay_checkpoint_header_t *header = &checkpoints->header;
+
+    if (header->count == checkpoints->capacity)
+    {
+        // Keeping every second checkpoint leaves about one per doubled interval.
+        uint32_t kept = 0;
+        for (uint32_t i = 1; i < header->count; i += 2)
+        {
+            checkpoints->checkpoints[kept++] = checkpoints->checkpoints[i];
+        }
+        header->count = kept;
+        header->interval *= 2;
+    }
+
+    checkpoints->checkpoints[header->count++] = *checkpoint;
+    return decay_checkpoints_next(checkpoints);
+}
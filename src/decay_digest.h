@@ -0,0 +1,42 @@
+/**
+ * @file decay_digest.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief FNV-1a digests of inputs, shared by the space weather checkpoints and the shard job digests.
+ *
+ * Internal to the library; not installed with the public headers.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef DECAY_DIGEST_H
+#define DECAY_DIGEST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DECAY_DIGEST_BASIS 0xcbf29ce484222325ULL // FNV-1a offset basis, the digest of nothing.
+#define DECAY_DIGEST_PRIME 0x100000001b3ULL      // FNV-1a prime.
+
+/**
+ * @brief Folds the bytes of a value into an FNV-1a digest.
+ *
+ * @param digest Digest so far, starting from DECAY_DIGEST_BASIS.
+ * @param data Value.
+ * @param size Bytes of the value.
+ * @return uint64_t The updated digest.
+ */
+static inline uint64_t decay_digest_mix(uint64_t digest, const void *data, size_t size)
+{
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++)
+    {
+        digest = (digest ^ bytes[i]) * DECAY_DIGEST_PRIME;
+    }
+    return digest;
+}
+
+#endif // DECAY_DIGEST_H
@@ -0,0 +1,120 @@
+/**
+ * @file decay_file.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Loading of input files.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <meb_print.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "decay_file.h"
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+#define DECAY_FILE_NO_MMAP
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+int decay_file_map(const char *path, bool sequential, decay_file_t *file)
+{
+    file->data = NULL;
+    file->size = 0;
+    file->mapped = false;
+
+#ifdef DECAY_FILE_NO_MMAP
+    (void)sequential;
+
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        erprintlf(errno);
+        return -1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long length = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    if (length > 0 && (file->data = malloc(length)) != NULL && fread(file->data, 1, length, fp) == (size_t)length)
+    {
+        file->size = length;
+    }
+    fclose(fp);
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        erprintlf(errno);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void *data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            erprintlf(errno);
+        }
+        else
+        {
+            file->data = data;
+            file->size = st.st_size;
+            file->mapped = true;
+#ifdef MADV_SEQUENTIAL
+            if (sequential)
+            {
+                madvise(data, file->size, MADV_SEQUENTIAL);
+            }
+#endif
+        }
+    }
+    close(fd);
+#endif
+
+    if (file->size == 0)
+    {
+        dbprintlf(RED_FG "Failed to load %s.", path);
+        decay_file_release(file);
+        return -1;
+    }
+
+    return 0;
+}
+
+void decay_file_release(decay_file_t *file)
+{
+#ifndef DECAY_FILE_NO_MMAP
+    if (file->mapped)
+    {
+        munmap(file->data, file->size);
+    }
+    else
+#endif
+    {
+        free(file->data);
+    }
+
+    file->data = NULL;
+    file->size = 0;
+    file->mapped = false;
+}
+
+long decay_file_days_from_civil(int year, int month, int day)
+{
+    year -= month <= 2;
+    long era = (year >= 0 ? year : year - 399) / 400;
+    long year_of_era = year - era * 400;
+    long day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file decay_file.h
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Loading of input files, shared by the lifetime tables, space weather histories, trajectories, and catalogs.
+ *
+ * Internal to the library; not installed with the public headers.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef DECAY_FILE_H
+#define DECAY_FILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief The contents of a whole file.
+ *
+ */
+typedef struct
+{
+    void *data;  // Read-only mapping of the file, or an allocation holding its contents where mapping is unavailable.
+    size_t size; // Bytes.
+    bool mapped;
+} decay_file_t;
+
+/**
+ * @brief Memory-maps a whole file, or reads it where mapping is unavailable.
+ *
+ * @param path File to load.
+ * @param sequential True if the contents will be read once from start to end, which lets the kernel read ahead.
+ * @param file Set to the contents.
+ * @return int 0 on success, -1 if the file is missing, empty, or cannot be loaded.
+ */
+int decay_file_map(const char *path, bool sequential, decay_file_t *file);
+
+/**
+ * @brief Releases the contents of a file: unmaps a mapping, and frees anything else.
+ *
+ * A block allocated to stand in for a file may therefore be released with mapped false.
+ *
+ * @param file Contents from decay_file_map(...); its data may be NULL.
+ */
+void decay_file_release(decay_file_t *file);
+
+/**
+ * @brief Days since 1970-01-01 of a proleptic Gregorian date, as found in the dates of input files.
+ *
+ * @param year Year.
+ * @param month Month, from 1 to 12.
+ * @param day Day of the month, from 1.
+ * @return long Days.
+ */
+long decay_file_days_from_civil(int year, int month, int day);
+
+#endif // DECAY_FILE_H
@@ -0,0 +1,426 @@
+/**
+ * @file decay_monte_carlo.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Monte Carlo re-entry time uncertainty.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <meb_print.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "decay_batch.h"
+#include "pool.h"
+#include "decay_monte_carlo.h"
+
+#define MONTE_CARLO_BATCH 64 // Samples per job with the fixed engine, a multiple of every vector width.
+
+static const double decay_monte_carlo_levels[DECAY_MONTE_CARLO_LEVELS] = {5, 10, 25, 50, 75, 90, 95};
+
+/**
+ * @brief xoshiro256** generator.
+ *
+ */
+typedef struct
+{
+    uint64_t s[4];
+} decay_rng_t;
+
+static inline uint64_t decay_rng_splitmix(uint64_t *x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Independent stream for one sample, seeded by SplitMix64 from the run's seed and the sample's index.
+static void decay_rng_init(decay_rng_t *rng, uint64_t seed, uint64_t index)
+{
+    uint64_t x = seed ^ decay_rng_splitmix(&index);
+    for (int i = 0; i < 4; i++)
+    {
+        rng->s[i] = decay_rng_splitmix(&x);
+    }
+}
+
+static inline uint64_t decay_rng_rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t decay_rng_next(decay_rng_t *rng)
+{
+    uint64_t *s = rng->s;
+    uint64_t result = decay_rng_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = decay_rng_rotl(s[3], 45);
+
+    return result;
+}
+
+// Uniform on (0, 1).
+static inline double decay_rng_uniform(decay_rng_t *rng)
+{
+    return ((decay_rng_next(rng) >> 11) + 0.5) * 0x1.0p-53;
+}
+
+// Standard normal quantile: Acklam's rational approximation, refined by one Halley step to full double precision.
+static double decay_normal_quantile(double p)
+{
+    static const double a[6] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[5] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[6] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[4] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00, 3.754408661907416e+00};
+    const double low = 0.02425;
+
+    double x;
+    if (p < low || p > 1 - low)
+    {
+        double q = sqrt(-2 * log(p < low ? p : 1 - p));
+        x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+        x = p < low ? x : -x;
+    }
+    else
+    {
+        double q = p - 0.5, r = q * q;
+        x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+    }
+
+    double e = 0.5 * erfc(-x / M_SQRT2) - p;
+    double u = e * sqrt(2 * M_PI) * exp(x * x / 2);
+    return x - u / (1 + x * u / 2);
+}
+
+// Draws one value, or NAN if rounding left it outside its range. Normal values are drawn exactly from the normal truncated to positive values (non-negative, which is the same up to rounding, for the space weather) by inverting its CDF.
+static double decay_distribution_sample(const decay_distribution_t *distribution, bool positive, decay_rng_t *rng)
+{
+    double value = distribution->a;
+    switch (distribution->kind)
+    {
+    case DECAY_DISTRIBUTION_UNIFORM:
+        value = distribution->a + (distribution->b - distribution->a) * decay_rng_uniform(rng);
+        break;
+    case DECAY_DISTRIBUTION_NORMAL:
+        if (distribution->b > 0)
+        {
+            // u on (Phi(-a/b), 1) is drawn as 1 - q with q on (0, Phi(a/b)), which keeps the precision of the lower tail.
+            double kept = 0.5 * erfc(-distribution->a / (distribution->b * M_SQRT2));
+            value = distribution->a - distribution->b * decay_normal_quantile(kept * decay_rng_uniform(rng));
+        }
+        break;
+    default:
+        break;
+    }
+
+    return (positive ? value > 0 : value >= 0) ? value : NAN;
+}
+
+// Mass and area must be strictly positive, since the model divides by the mass and an area of 0 never decays.
+static int decay_distribution_check(const decay_distribution_t *distribution, bool positive, const char *name)
+{
+    bool valid = true;
+    switch (distribution->kind)
+    {
+    case DECAY_DISTRIBUTION_FIXED:
+        valid = positive ? distribution->a > 0 : distribution->a >= 0;
+        break;
+    case DECAY_DISTRIBUTION_UNIFORM:
+        valid = (positive ? distribution->a > 0 : distribution->a >= 0) && distribution->b >= distribution->a;
+        break;
+    case DECAY_DISTRIBUTION_NORMAL:
+        valid = distribution->b >= 0 && distribution->a + 3 * distribution->b > 0;
+        break;
+    default:
+        valid = false;
+        break;
+    }
+
+    if (!valid)
+    {
+        dbprintlf(RED_FG "Invalid %s distribution.", name);
+        return -1;
+    }
+    return 0;
+}
+
+int decay_distribution_parse(const char *text, decay_distribution_t *distribution)
+{
+    double a = 0, b = 0;
+    int consumed = 0;
+
+    // "%lf" would read the "15." of "15..25", so the range is split at ".." first.
+    const char *range = strstr(text, "..");
+    if (range != NULL)
+    {
+        char low[64] = {0};
+        if (range - text >= (long)sizeof(low))
+        {
+            return -1;
+        }
+        memcpy(low, text, range - text);
+
+        if (sscanf(low, "%lf%n", &a, &consumed) != 1 || low[consumed] != '\0' || sscanf(range + 2, "%lf%n", &b, &consumed) != 1 || range[2 + consumed] != '\0')
+        {
+            return -1;
+        }
+        distribution->kind = DECAY_DISTRIBUTION_UNIFORM;
+    }
+    else if (sscanf(text, "%lf:%lf%n", &a, &b, &consumed) == 2 && text[consumed] == '\0')
+    {
+        distribution->kind = DECAY_DISTRIBUTION_NORMAL;
+    }
+    else if (sscanf(text, "%lf%n", &a, &consumed) == 1 && text[consumed] == '\0')
+    {
+        distribution->kind = DECAY_DISTRIBUTION_FIXED;
+    }
+    else
+    {
+        return -1;
+    }
+
+    distribution->a = a;
+    distribution->b = b;
+    return 0;
+}
+
+typedef struct
+{
+    const decay_monte_carlo_t *config;
+    double *lifetimes;
+    int batch;          // Samples per job.
+    atomic_bool failed; // Set if any sample could not be drawn.
+} decay_monte_carlo_context_t;
+
+static void decay_monte_carlo_job(int job, void *context)
+{
+    decay_monte_carlo_context_t *run = context;
+    const decay_monte_carlo_t *config = run->config;
+
+    double mass[MONTE_CARLO_BATCH], area[MONTE_CARLO_BATCH], altitude[MONTE_CARLO_BATCH], srf[MONTE_CARLO_BATCH], geo[MONTE_CARLO_BATCH];
+
+    int first = job * run->batch;
+    int count = config->samples - first < run->batch ? config->samples - first : run->batch;
+
+    for (int i = 0; i < count; i++)
+    {
+        decay_rng_t rng;
+        decay_rng_init(&rng, config->seed, (uint64_t)config->offset + first + i);
+
+        mass[i] = decay_distribution_sample(&config->satellite_mass, true, &rng);
+        area[i] = decay_distribution_sample(&config->satellite_area, true, &rng);
+        altitude[i] = config->altitude;
+        srf[i] = decay_distribution_sample(&config->solar_radio_flux, false, &rng);
+        geo[i] = decay_distribution_sample(&config->geomagnetic_a_index, false, &rng);
+
+        if (isnan(mass[i]) || isnan(area[i]) || isnan(srf[i]) || isnan(geo[i]))
+        {
+            atomic_store(&run->failed, true);
+            return;
+        }
+    }
+
+    if (config->engine == DECAY_ENGINE_FIXED)
+    {
+        decay_calculate_batch(count, mass, area, altitude, srf, geo, run->lifetimes + first, DECAY_BATCH_AUTO);
+        return;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        run->lifetimes[first + i] = decay_calculate_lifetime(config->engine, mass[i], area[i], altitude[i], srf[i], geo[i], config->tolerance, LIFETIME_LIMIT);
+    }
+}
+
+// Mean of a distribution, ignoring the truncation of normal values.
+static double decay_distribution_mean(const decay_distribution_t *distribution)
+{
+    return distribution->kind == DECAY_DISTRIBUTION_UNIFORM ? 0.5 * (distribution->a + distribution->b) : distribution->a;
+}
+
+// Standard deviation of a distribution, ignoring the truncation of normal values.
+static double decay_distribution_deviation(const decay_distribution_t *distribution)
+{
+    switch (distribution->kind)
+    {
+    case DECAY_DISTRIBUTION_UNIFORM:
+        return (distribution->b - distribution->a) / sqrt(12);
+    case DECAY_DISTRIBUTION_NORMAL:
+        return distribution->b;
+    default:
+        return 0;
+    }
+}
+
+static int decay_monte_carlo_check(const decay_monte_carlo_t *config)
+{
+    if (config->samples < 1 || config->offset < 0 || config->altitude * 1000 <= KARMAN_LINE || config->altitude > MAX_ALTITUDE ||
+        config->engine < DECAY_ENGINE_FIXED || config->engine > DECAY_ENGINE_QUADRATURE ||
+        decay_distribution_check(&config->satellite_mass, true, "mass") < 0 ||
+        decay_distribution_check(&config->satellite_area, true, "area") < 0 ||
+        decay_distribution_check(&config->solar_radio_flux, false, "Solar Radio Flux") < 0 ||
+        decay_distribution_check(&config->geomagnetic_a_index, false, "Geomagnetic A Index") < 0)
+    {
+        dbprintlf(RED_FG "Invalid Monte Carlo inputs.");
+        return -1;
+    }
+    return 0;
+}
+
+int decay_monte_carlo(const decay_monte_carlo_t *config, double *lifetimes)
+{
+    if (decay_monte_carlo_check(config) < 0)
+    {
+        return -1;
+    }
+
+    // Fixed-step samples are cheap to start and benefit from the vector kernels, so they are claimed in batches.
+    decay_monte_carlo_context_t run = {
+        .config = config,
+        .lifetimes = lifetimes,
+        .batch = config->engine == DECAY_ENGINE_FIXED ? MONTE_CARLO_BATCH : 1,
+    };
+    atomic_init(&run.failed, false);
+    int jobs = (config->samples + run.batch - 1) / run.batch;
+
+    pool_run(jobs, config->threads, decay_monte_carlo_job, &run);
+
+    if (atomic_load(&run.failed))
+    {
+        dbprintlf(RED_FG "A sample fell outside its input's range.");
+        return -1;
+    }
+    return 0;
+}
+
+int decay_monte_carlo_linearized(const decay_monte_carlo_t *config, double *lifetime, double *deviation)
+{
+    *lifetime = -1;
+    *deviation = -1;
+
+    if (decay_monte_carlo_check(config) < 0)
+    {
+        return -1;
+    }
+
+    double mass = decay_distribution_mean(&config->satellite_mass);
+    double area = decay_distribution_mean(&config->satellite_area);
+
+    decay_sensitivity_t sensitivity;
+    decay_config_t run = {
+        .engine = config->engine,
+        .satellite_mass = mass,
+        .satellite_area = area,
+        .altitude = config->altitude,
+        .solar_radio_flux = decay_distribution_mean(&config->solar_radio_flux),
+        .geomagnetic_a_index = decay_distribution_mean(&config->geomagnetic_a_index),
+        .tolerance = config->tolerance,
+        .time_limit = LIFETIME_LIMIT,
+        .sensitivity = &sensitivity,
+    };
+
+    decay_result_t result;
+    if (decay_run(&run, &result) < 0 || result.status != DECAY_STATUS_REENTERED)
+    {
+        dbprintlf(RED_FG "The mean inputs do not re-enter within 50 years.");
+        return -1;
+    }
+
+    // The area-to-mass ratio's deviation to first order in those of the area and the mass.
+    double area_mass_deviation = hypot(decay_distribution_deviation(&config->satellite_area) / mass, area * decay_distribution_deviation(&config->satellite_mass) / (mass * mass));
+
+    double solar_radio_flux_term = sensitivity.solar_radio_flux * decay_distribution_deviation(&config->solar_radio_flux);
+    double geomagnetic_a_index_term = sensitivity.geomagnetic_a_index * decay_distribution_deviation(&config->geomagnetic_a_index);
+    double area_mass_term = sensitivity.area_mass * area_mass_deviation;
+
+    *lifetime = result.lifetime;
+    *deviation = sqrt(solar_radio_flux_term * solar_radio_flux_term + geomagnetic_a_index_term * geomagnetic_a_index_term + area_mass_term * area_mass_term);
+    return 0;
+}
+
+// Orders re-entry times ascending, with lifetimes beyond 50 years (-1) last.
+static int decay_monte_carlo_compare(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    if (x < 0 || y < 0)
+    {
+        return (x < 0) - (y < 0);
+    }
+    return (x > y) - (x < y);
+}
+
+int decay_monte_carlo_summarize(const double *lifetimes, int samples, decay_monte_carlo_summary_t *summary)
+{
+    memset(summary, 0, sizeof(*summary));
+    if (samples < 1)
+    {
+        return -1;
+    }
+
+    double *sorted = malloc(samples * sizeof(double));
+    if (sorted == NULL)
+    {
+        return -1;
+    }
+    memcpy(sorted, lifetimes, samples * sizeof(double));
+    qsort(sorted, samples, sizeof(double), decay_monte_carlo_compare);
+
+    summary->samples = samples;
+    int reentered = 0;
+    while (reentered < samples && sorted[reentered] >= 0)
+    {
+        summary->mean += sorted[reentered];
+        reentered++;
+    }
+    summary->exceeded = samples - reentered;
+    summary->mean = reentered > 0 ? summary->mean / reentered : -1;
+
+    // Linear interpolation between order statistics.
+    for (int i = 0; i < DECAY_MONTE_CARLO_LEVELS; i++)
+    {
+        double position = decay_monte_carlo_levels[i] / 100 * (samples - 1);
+        int lower = (int)position;
+        int upper = lower + 1 < samples ? lower + 1 : lower;
+        double fraction = position - lower;
+
+        summary->level[i] = decay_monte_carlo_levels[i];
+        if (upper >= reentered && fraction > 0)
+        {
+            summary->percentile[i] = -1;
+        }
+        else if (lower >= reentered)
+        {
+            summary->percentile[i] = -1;
+        }
+        else
+        {
+            summary->percentile[i] = sorted[lower] + fraction * (sorted[upper] - sorted[lower]);
+        }
+    }
+
+    if (reentered > 0)
+    {
+        summary->histogram_first = sorted[0];
+        summary->histogram_width = (sorted[reentered - 1] - sorted[0]) / DECAY_MONTE_CARLO_BINS;
+        for (int i = 0; i < reentered; i++)
+        {
+            int bin = summary->histogram_width > 0 ? (int)((sorted[i] - sorted[0]) / summary->histogram_width) : 0;
+            summary->histogram[bin < DECAY_MONTE_CARLO_BINS ? bin : DECAY_MONTE_CARLO_BINS - 1]++;
+        }
+    }
+
+    free(sorted);
+    return 0;
+}
@@ -0,0 +1,416 @@
+/**
+ * @file decay_report.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Console and CSV print-outs of re-entry calculations.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <meb_print.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "buffer.h"
+#include "pool.h"
+#include "decay_report.h"
+
+#define REPORT_MAX_PATH 256
+
+/**
+ * @brief A multi-run altitude sweep.
+ *
+ * Every run writes its console and CSV text into its own buffers so that runs can be computed on any thread and still be printed in order.
+ *
+ */
+typedef struct
+{
+    double satellite_mass;
+    double satellite_area;
+    double altitude;     // Altitude of the first run in kilometers.
+    float run_increment; // Kilometers.
+    int runs;
+    double solar_radio_flux;
+    double geomagnetic_a_index;
+    decay_engine_t engine;
+    double tolerance;
+    bool save_to_csv;
+    const decay_weather_t *weather; // Space weather history, or NULL for the averages above.
+    const decay_report_trajectory_t *trajectory; // Trajectory files, or NULL.
+
+    buffer_t *console;     // Console text per run.
+    buffer_t *csv;         // CSV text per run.
+    double *lifetimes;     // Lifetime per run in seconds, or -1 if it exceeds 50 years or the run is invalid.
+    atomic_int first_failed; // Lowest run whose lifetime exceeds 50 years or that is invalid; higher runs are skipped.
+} decay_sweep_t;
+
+/**
+ * @brief Sample callback context of one run of a sweep.
+ *
+ */
+typedef struct
+{
+    decay_sweep_t *sweep;
+    int run;
+    decay_trajectory_writer_t *writer; // Trajectory file of the run, or NULL.
+    double next_row;                   // Time of the next row of the printed table.
+    double next_sample;                // Time of the next row of the trajectory file.
+    double cadence;                    // Seconds between samples, which fall on both the table's and the file's rows.
+    bool exceeded;                     // A row reached LIFETIME_LIMIT.
+} decay_sweep_rows_t;
+
+// Writes one row of the trajectory table to a run's buffers.
+static void decay_print_row(buffer_t *console, buffer_t *csv, double elapsed_time, double altitude, double orbital_period)
+{
+    buffer_printf(console, "%d\t\t%f\t\t%f" TERMINATOR " \n", (int)(elapsed_time / 86400), altitude, orbital_period);
+    if (csv != NULL) {buffer_printf(csv, "%d, %f, %f\n", (int)(elapsed_time / 86400), altitude, orbital_period);}
+}
+
+// Marks a run as failed and stops every run above it, whose altitude is higher still.
+static void decay_sweep_fail(decay_sweep_t *sweep, int run)
+{
+    sweep->lifetimes[run] = -1;
+
+    int first_failed = atomic_load(&sweep->first_failed);
+    while (run < first_failed && !atomic_compare_exchange_weak(&sweep->first_failed, &first_failed, run))
+        ;
+}
+
+// Reports an abandoned run and stops every run above it.
+static void decay_print_limit_exceeded(decay_sweep_t *sweep, int run)
+{
+    buffer_printf(&sweep->console[run], "Satellite lifetime exceeds 50 years." TERMINATOR " \n");
+    if (sweep->save_to_csv) {buffer_printf(&sweep->csv[run], "Satellite lifetime exceeds 50 years.\n");}
+
+    decay_sweep_fail(sweep, run);
+}
+
+// Reports a run that decay_run(...) rejected, such as one above the exponential atmosphere's ceiling, and stops every run above it.
+static void decay_print_invalid(decay_sweep_t *sweep, int run, double altitude)
+{
+    buffer_printf(&sweep->console[run], RED_FG "ERROR: Invalid run at %f km; the mass and area must be positive and the orbit within the atmosphere model." TERMINATOR " \n", altitude);
+    if (sweep->save_to_csv) {buffer_printf(&sweep->csv[run], "ERROR: Invalid run at %f km; the mass and area must be positive and the orbit within the atmosphere model.\n", altitude);}
+
+    decay_sweep_fail(sweep, run);
+}
+
+// Writes the heading of one run of a sweep.
+static void decay_print_heading(decay_sweep_t *sweep, int run)
+{
+    buffer_printf(&sweep->console[run], "RUN %d/%d" TERMINATOR " \n", run + 1, sweep->runs);
+    buffer_printf(&sweep->console[run], "TIME (days)\tHEIGHT (km)\t\tPERIOD (minutes)" TERMINATOR " \n");
+    if (sweep->save_to_csv) {buffer_printf(&sweep->csv[run], "\nRUN %d/%d\n", run + 1, sweep->runs);}
+    if (sweep->save_to_csv) {buffer_printf(&sweep->csv[run], "TIME (days), HEIGHT (km), PERIOD (minutes)\n");}
+}
+
+// Writes the final row and the re-entry time of one run of a sweep.
+static void decay_print_reentry(decay_sweep_t *sweep, int run, double elapsed_time, double altitude, double orbital_period)
+{
+    buffer_t *console = &sweep->console[run];
+    buffer_t *csv = sweep->save_to_csv ? &sweep->csv[run] : NULL;
+
+    buffer_printf(console, "%d\t\t%f\t\t%f\n" TERMINATOR " \n", (int)(elapsed_time / 86400), altitude, orbital_period);
+    if (csv != NULL) {buffer_printf(csv, "%d, %f, %f\n", (int)(elapsed_time / 86400), altitude, orbital_period);}
+
+    buffer_printf(console, "Re-entry after %f days (%f years).\n" TERMINATOR " \n", elapsed_time / (3600 * 24), elapsed_time / (3600 * 24 * 365));
+    if (csv != NULL) {buffer_printf(csv, "\nRe-entry after %f days (%f years).\n\n", elapsed_time / (3600 * 24), elapsed_time / (3600 * 24 * 365));}
+}
+
+// Records a sample in the trajectory file and prints the weekly rows, and stops the run at 50 years or once a lower run has exceeded them.
+static int decay_sweep_row(double elapsed_time, double altitude, double orbital_period, void *context)
+{
+    decay_sweep_rows_t *rows = context;
+    decay_sweep_t *sweep = rows->sweep;
+
+    // Sample times are accumulated, so they are matched to the rows within half a sample.
+    double slack = 0.5 * rows->cadence;
+
+    if (rows->writer != NULL && elapsed_time >= rows->next_sample - slack)
+    {
+        rows->next_sample += sweep->trajectory->interval;
+        if (decay_trajectory_write(rows->writer, elapsed_time, altitude, orbital_period) < 0)
+        {
+            // Losing the file is not worth losing the print-out.
+            decay_trajectory_finish(rows->writer);
+            rows->writer = NULL;
+        }
+    }
+
+    if (elapsed_time < rows->next_row - slack)
+    {
+        return 0;
+    }
+    rows->next_row += REPORT_INTERVAL;
+
+    decay_print_row(&sweep->console[rows->run], sweep->save_to_csv ? &sweep->csv[rows->run] : NULL, elapsed_time, altitude, orbital_period);
+
+    if (elapsed_time >= LIFETIME_LIMIT)
+    {
+        rows->exceeded = true;
+        return 1;
+    }
+
+    // A lower run has already exceeded 50 years, so this one will never be printed.
+    return rows->run > atomic_load_explicit(&sweep->first_failed, memory_order_relaxed);
+}
+
+// Seconds between the samples of a sweep with a trajectory file: the greatest common divisor, to the millisecond, of the file's interval and REPORT_INTERVAL, so that the printed table stays weekly whatever the file's interval.
+static double decay_sweep_cadence(double interval)
+{
+    long long a = llround(interval * 1000), b = (long long)REPORT_INTERVAL * 1000;
+    if (a <= 0)
+    {
+        return REPORT_INTERVAL;
+    }
+    while (b != 0)
+    {
+        long long r = a % b;
+        a = b;
+        b = r;
+    }
+    return a / 1000.0;
+}
+
+// Opens the trajectory file of one run of a sweep, numbering every run after the first before the extension.
+static decay_trajectory_writer_t *decay_sweep_trajectory(const decay_sweep_t *sweep, int run)
+{
+    const decay_report_trajectory_t *trajectory = sweep->trajectory;
+    if (trajectory == NULL || trajectory->path == NULL || (sweep->engine == DECAY_ENGINE_QUADRATURE && sweep->weather == NULL))
+    {
+        return NULL;
+    }
+
+    char path[REPORT_MAX_PATH];
+    const char *separator = strrchr(trajectory->path, '/');
+    const char *extension = strrchr(separator != NULL ? separator : trajectory->path, '.');
+    if (run == 0)
+    {
+        snprintf(path, sizeof(path), "%s", trajectory->path);
+    }
+    else if (extension == NULL || extension == trajectory->path || extension[-1] == '/')
+    {
+        snprintf(path, sizeof(path), "%s_%d", trajectory->path, run + 1);
+    }
+    else
+    {
+        snprintf(path, sizeof(path), "%.*s_%d%s", (int)(extension - trajectory->path), trajectory->path, run + 1, extension);
+    }
+
+    return decay_trajectory_create(path, trajectory->format, trajectory->interval);
+}
+
+// Calculates one run of a sweep into its buffers.
+static void decay_sweep_run(int run, void *context)
+{
+    decay_sweep_t *sweep = context;
+
+    if (run > atomic_load(&sweep->first_failed))
+    {
+        return;
+    }
+
+    decay_print_heading(sweep, run);
+
+    // The first run starts at exactly the requested altitude.
+    decay_sweep_rows_t rows = {.sweep = sweep, .run = run, .writer = decay_sweep_trajectory(sweep, run)};
+    rows.cadence = rows.writer != NULL ? decay_sweep_cadence(sweep->trajectory->interval) : REPORT_INTERVAL;
+    decay_config_t config = {
+        .engine = sweep->engine,
+        .satellite_mass = sweep->satellite_mass,
+        .satellite_area = sweep->satellite_area,
+        .altitude = run == 0 ? sweep->altitude : decay_sweep_altitude(sweep->altitude, sweep->run_increment, run + 1),
+        .solar_radio_flux = sweep->solar_radio_flux,
+        .geomagnetic_a_index = sweep->geomagnetic_a_index,
+        .weather = sweep->weather,
+        .tolerance = sweep->tolerance,
+        .time_limit = INFINITY,
+        .sample_interval = rows.cadence,
+        .on_sample = decay_sweep_row,
+        .context = &rows,
+    };
+    decay_result_t result;
+
+    decay_run(&config, &result);
+
+    if (rows.writer != NULL)
+    {
+        if (result.status == DECAY_STATUS_REENTERED)
+        {
+            decay_trajectory_write(rows.writer, result.elapsed_time, result.altitude, result.orbital_period);
+        }
+        decay_trajectory_finish(rows.writer);
+    }
+
+    if (result.status == DECAY_STATUS_INVALID)
+    {
+        decay_print_invalid(sweep, run, config.altitude);
+        return;
+    }
+
+    if (result.status == DECAY_STATUS_STOPPED && !rows.exceeded)
+    {
+        return;
+    }
+
+    if (rows.exceeded || result.lifetime >= LIFETIME_LIMIT)
+    {
+        decay_print_limit_exceeded(sweep, run);
+        return;
+    }
+
+    sweep->lifetimes[run] = result.lifetime;
+    decay_print_reentry(sweep, run, result.lifetime, result.altitude, result.orbital_period);
+}
+
+// Writes the summary of one run of a single-pass sweep, whose lifetime is already known.
+static void decay_sweep_summary(int run, void *context)
+{
+    decay_sweep_t *sweep = context;
+    buffer_t *csv = sweep->save_to_csv ? &sweep->csv[run] : NULL;
+
+    double altitude = decay_sweep_altitude(sweep->altitude, sweep->run_increment, run + 1);
+    double elapsed_time = sweep->lifetimes[run];
+
+    decay_print_heading(sweep, run);
+
+    // A single pass integrates the exponential model, whose levels end at its ceiling.
+    if (!(altitude < DECAY_ATMOSPHERE_EXPONENTIAL_CEILING))
+    {
+        decay_print_invalid(sweep, run, altitude);
+        return;
+    }
+
+    // A single pass has no per-run trajectory, so only the end points are reported.
+    decay_print_row(&sweep->console[run], csv, 0, altitude, decay_circular_period(altitude));
+
+    if (elapsed_time < 0)
+    {
+        decay_print_limit_exceeded(sweep, run);
+        return;
+    }
+
+    decay_print_reentry(sweep, run, elapsed_time, KARMAN_LINE / 1000.0, decay_model_period(KARMAN_LINE / 1000.0));
+}
+
+int decay_calculate(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, bool save_to_csv, int runs, float run_increment, decay_engine_t engine, double tolerance, int threads, bool single_pass, const decay_weather_t *weather, const decay_report_trajectory_t *trajectory)
+{
+    int lifetime = 0;
+
+    FILE* fp = NULL;
+    if (save_to_csv)
+    {
+        fp = fopen("data.csv", "a");
+        if (fp == NULL)
+        {
+            save_to_csv = false;
+        }
+    }
+
+    decay_sweep_t sweep = {
+        .satellite_mass = satellite_mass,
+        .satellite_area = satellite_area,
+        .altitude = altitude,
+        .run_increment = run_increment,
+        .runs = runs,
+        .solar_radio_flux = solar_radio_flux,
+        .geomagnetic_a_index = geomagnetic_a_index,
+        .engine = engine,
+        .tolerance = tolerance,
+        .save_to_csv = save_to_csv,
+        .weather = weather,
+        .trajectory = trajectory,
+    };
+    sweep.console = calloc(runs, sizeof(buffer_t));
+    sweep.csv = calloc(runs, sizeof(buffer_t));
+    sweep.lifetimes = calloc(runs, sizeof(double));
+    atomic_init(&sweep.first_failed, runs);
+
+    if (sweep.console == NULL || sweep.csv == NULL || sweep.lifetimes == NULL)
+    {
+        dbprintlf(RED_FG "Failed to allocate buffers for %d runs.", runs);
+        free(sweep.console);
+        free(sweep.csv);
+        free(sweep.lifetimes);
+        if (fp != NULL) {fclose(fp);}
+        return -1;
+    }
+
+    // Parallel and single-pass sweeps compute every run up front; serial sweeps print each run as soon as it finishes. A single pass relies on the model being autonomous, so a history always uses separate runs.
+    pool_job_t job = decay_sweep_run;
+    if (single_pass && weather == NULL)
+    {
+        decay_calculate_sweep(engine, satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index, runs, run_increment, tolerance, sweep.lifetimes);
+        job = decay_sweep_summary;
+        threads = 1;
+    }
+    else if (threads != 1 && runs > 1)
+    {
+        pool_run(runs, threads, decay_sweep_run, &sweep);
+    }
+
+    bprintlf("\nBEGIN CALCULATION");
+    if (save_to_csv) {fprintf(fp, "BEGIN CALCULATION\n");}
+    for (int run = 0; run < runs; run++)
+    {
+        if (threads == 1 || runs == 1)
+        {
+            job(run, &sweep);
+        }
+
+        // The buffered lines end in their own terminators, so they are written as they are.
+        if (sweep.console[run].data != NULL && MEB_ENABLED(MEB_DBG_BPRINT))
+        {
+            MEB_FPRINTF(stdout, "%s", sweep.console[run].data);
+            MEB_FFLUSH(stdout);
+        }
+        if (save_to_csv && sweep.csv[run].data != NULL) {fputs(sweep.csv[run].data, fp);}
+        buffer_free(&sweep.console[run]);
+        buffer_free(&sweep.csv[run]);
+
+        lifetime = sweep.lifetimes[run];
+        if (lifetime < 0)
+        {
+            break;
+        }
+    }
+
+    if (lifetime >= 0)
+    {
+        bprintlf("END CALCULATION");
+        if (save_to_csv) {fprintf(fp, "END CALCULATION\n");}
+        bprintlf("------------------------------------------");
+        if (save_to_csv) {fprintf(fp, "------------------------------------------\n\n");}
+    }
+
+    for (int run = 0; run < runs; run++)
+    {
+        buffer_free(&sweep.console[run]);
+        buffer_free(&sweep.csv[run]);
+    }
+    free(sweep.console);
+    free(sweep.csv);
+    free(sweep.lifetimes);
+
+    if (fp != NULL)
+    {
+        fclose(fp);
+    }
+
+    return lifetime;
+}
+
+int decay_calculate_suppressed(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index)
+{
+    int elapsed_time = decay_calculate_lifetime(DECAY_ENGINE_FIXED, satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index, 0, LIFETIME_LIMIT);
+    if (elapsed_time < 0)
+    {
+        bprintlf("Satellite lifetime exceeds 50 years.");
+    }
+
+    return elapsed_time;
+}
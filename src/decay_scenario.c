@@ -0,0 +1,356 @@
+/**
+ * @file decay_scenario.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Non-interactive processing of scenario files.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <meb_print.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "pool.h"
+#include "decay_digest.h"
+#include "decay_scenario.h"
+#include "decay_stats.h"
+
+#define SCENARIO_MAX_LINE 512
+#define SCENARIO_MAX_FIELDS 8
+#define SCENARIO_MAX_PATH 4096
+
+static const char *decay_scenario_modes[] = {"ttr", "srf", "geo", "error"};
+
+int decay_scenario_parse(const char *text, int line, decay_scenario_t *scenario)
+{
+    memset(scenario, 0, sizeof(*scenario));
+    scenario->line = line;
+    scenario->mode = DECAY_SCENARIO_ERROR;
+    scenario->result = -1;
+
+    char copy[SCENARIO_MAX_LINE];
+    strncpy(copy, text, sizeof(copy) - 1);
+    copy[sizeof(copy) - 1] = '\0';
+
+    char *fields[SCENARIO_MAX_FIELDS];
+    int count = 0;
+    char *save = NULL;
+    for (char *field = strtok_r(copy, ", \t\r\n", &save); field != NULL; field = strtok_r(NULL, ", \t\r\n", &save))
+    {
+        if (count == 0 && field[0] == '#')
+        {
+            return 0;
+        }
+        if (count == SCENARIO_MAX_FIELDS)
+        {
+            return 1;
+        }
+        fields[count++] = field;
+    }
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    // The mode, if any, is the last field.
+    decay_scenario_mode_t mode = DECAY_SCENARIO_TTR;
+    for (int i = DECAY_SCENARIO_TTR; i < DECAY_SCENARIO_ERROR; i++)
+    {
+        if (!strcasecmp(fields[count - 1], decay_scenario_modes[i]))
+        {
+            mode = i;
+            count--;
+            break;
+        }
+    }
+
+    double values[6] = {0};
+    if (count < 5 || count > 6)
+    {
+        return 1;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        char *end = NULL;
+        values[i] = strtod(fields[i], &end);
+        if (end == fields[i] || *end != '\0')
+        {
+            return 1;
+        }
+    }
+
+    scenario->satellite_mass = values[0];
+    scenario->satellite_area = values[1];
+    scenario->altitude = values[2];
+    scenario->solar_radio_flux = values[3];
+    scenario->geomagnetic_a_index = values[4];
+    scenario->mission_time = values[5];
+
+    if (scenario->satellite_mass <= 0 || scenario->satellite_area <= 0 ||
+        scenario->altitude * 1000 <= KARMAN_LINE || scenario->altitude > MAX_ALTITUDE ||
+        (mode != DECAY_SCENARIO_TTR && scenario->mission_time <= 0))
+    {
+        return 1;
+    }
+
+    scenario->mode = mode;
+    return 1;
+}
+
+// Relative run time of a scenario.
+static double decay_scenario_cost(const decay_scenario_t *scenario, const decay_scenario_options_t *options)
+{
+    switch (scenario->mode)
+    {
+    case DECAY_SCENARIO_TTR:
+        return decay_estimate_cost(options->engine, scenario->satellite_mass, scenario->satellite_area, scenario->altitude, scenario->solar_radio_flux, scenario->geomagnetic_a_index);
+    case DECAY_SCENARIO_SRF:
+    case DECAY_SCENARIO_GEO:
+        // Solvers take several runs, each abandoned at 1.5 times the mission time.
+        return options->engine == DECAY_ENGINE_FIXED ? 8 * 1.5 * scenario->mission_time * 86400 : 8;
+    default:
+        return 0;
+    }
+}
+
+typedef struct
+{
+    decay_scenario_t *scenarios;
+    const pool_order_t *order; // Most expensive first.
+    const decay_scenario_options_t *options;
+} decay_scenario_chunk_t;
+
+void decay_scenario_evaluate(decay_scenario_t *scenario, const decay_scenario_options_t *options)
+{
+    double result = -1;
+    switch (scenario->mode)
+    {
+    case DECAY_SCENARIO_TTR:
+    {
+        // The table was filled under the averages and the exponential model; queries outside its grid are run.
+        double lifetime = 0;
+        if (options->table != NULL && options->weather == NULL && options->atmosphere == DECAY_ATMOSPHERE_EXPONENTIAL &&
+            decay_table_lookup(options->table, scenario->satellite_mass, scenario->satellite_area, scenario->altitude, scenario->solar_radio_flux, scenario->geomagnetic_a_index, &lifetime) == 0)
+        {
+            result = lifetime < 0 ? -1 : lifetime / 86400;
+            break;
+        }
+
+        decay_config_t config = {
+            .engine = options->engine,
+            .satellite_mass = scenario->satellite_mass,
+            .satellite_area = scenario->satellite_area,
+            .altitude = scenario->altitude,
+            .solar_radio_flux = scenario->solar_radio_flux,
+            .geomagnetic_a_index = scenario->geomagnetic_a_index,
+            .weather = options->weather,
+            .tolerance = options->tolerance,
+            .time_limit = LIFETIME_LIMIT,
+            .atmosphere = options->atmosphere,
+        };
+
+        char path[SCENARIO_MAX_PATH];
+        if (options->checkpoints != NULL)
+        {
+            snprintf(path, sizeof(path), "%s/%d.ckpt", options->checkpoints, scenario->line);
+            config.checkpoints = decay_checkpoints_open(path);
+            config.checkpoints = config.checkpoints != NULL ? config.checkpoints : decay_checkpoints_create(0);
+        }
+
+        // Orbits the atmosphere model does not cover are errors, not lifetimes beyond 50 years.
+        decay_result_t run;
+        decay_run(&config, &run);
+        result = run.lifetime < 0 ? -1 : run.lifetime / 86400;
+        if (run.status == DECAY_STATUS_INVALID)
+        {
+            scenario->mode = DECAY_SCENARIO_ERROR;
+        }
+
+        if (config.checkpoints != NULL && decay_checkpoints_save(config.checkpoints, path) < 0)
+        {
+            dbprintlf(RED_FG "Failed to save the checkpoints of line %d to %s.", scenario->line, path);
+        }
+        decay_checkpoints_close(config.checkpoints);
+        break;
+    }
+    case DECAY_SCENARIO_SRF:
+    case DECAY_SCENARIO_GEO:
+        // The solvers vary the space weather of the exponential model, which ends at its ceiling.
+        if (!(scenario->altitude < DECAY_ATMOSPHERE_EXPONENTIAL_CEILING))
+        {
+            scenario->mode = DECAY_SCENARIO_ERROR;
+        }
+        else if (scenario->mode == DECAY_SCENARIO_SRF)
+        {
+            result = decay_max_avg_srf_suppressed(scenario->satellite_mass, scenario->satellite_area, scenario->altitude, scenario->geomagnetic_a_index, scenario->mission_time, options->engine, scenario->solar_radio_flux, SOLVER_TOLERANCE);
+        }
+        else
+        {
+            result = decay_max_avg_geo_suppressed(scenario->satellite_mass, scenario->satellite_area, scenario->altitude, scenario->solar_radio_flux, scenario->mission_time, options->engine, scenario->geomagnetic_a_index, SOLVER_TOLERANCE);
+        }
+        break;
+    default:
+        break;
+    }
+
+    scenario->result = result;
+}
+
+void decay_scenario_write(FILE *output, const decay_scenario_t *scenario)
+{
+    if (scenario->mode == DECAY_SCENARIO_ERROR)
+    {
+        fprintf(output, "%d,%s,\n", scenario->line, decay_scenario_modes[scenario->mode]);
+    }
+    else
+    {
+        fprintf(output, "%d,%s,%f\n", scenario->line, decay_scenario_modes[scenario->mode], scenario->result);
+    }
+}
+
+// Folds the inputs of a scenario into the digest of its file.
+static uint64_t decay_scenario_mix(uint64_t digest, const decay_scenario_t *scenario)
+{
+    double inputs[] = {scenario->line, scenario->mode, scenario->satellite_mass, scenario->satellite_area, scenario->altitude, scenario->solar_radio_flux, scenario->geomagnetic_a_index, scenario->mission_time};
+    return decay_digest_mix(digest, inputs, sizeof(inputs));
+}
+
+static void decay_scenario_job(int index, void *context)
+{
+    decay_scenario_chunk_t *chunk = context;
+    decay_scenario_evaluate(&chunk->scenarios[chunk->order[index].index], chunk->options);
+}
+
+int decay_scenario_run(FILE *input, FILE *output, const decay_scenario_options_t *options)
+{
+    decay_scenario_t *scenarios = malloc(DECAY_SCENARIO_CHUNK * sizeof(decay_scenario_t));
+    pool_order_t *order = malloc(DECAY_SCENARIO_CHUNK * sizeof(pool_order_t));
+    if (scenarios == NULL || order == NULL)
+    {
+        dbprintlf(RED_FG "Failed to allocate %d scenarios.", DECAY_SCENARIO_CHUNK);
+        free(scenarios);
+        free(order);
+        return -1;
+    }
+
+    decay_partial_t *partial = NULL;
+    if (options->partial != NULL && (partial = decay_partial_create(options->partial, DECAY_SHARD_BATCH, &options->shard)) == NULL)
+    {
+        free(scenarios);
+        free(order);
+        return -1;
+    }
+
+    // Every shard reads the whole file, so each folds the same scenarios and settings into the job's digest.
+    double settings[] = {options->engine, options->tolerance, options->atmosphere};
+    uint64_t job = decay_digest_mix(DECAY_DIGEST_BASIS, settings, sizeof(settings));
+    if (options->weather != NULL)
+    {
+        uint64_t weather = decay_weather_digest(options->weather, INFINITY);
+        job = decay_digest_mix(job, &weather, sizeof(weather));
+    }
+    if (options->table != NULL)
+    {
+        job = decay_digest_mix(job, decay_table_header(options->table), sizeof(decay_table_header_t));
+    }
+
+    char text[SCENARIO_MAX_LINE];
+    int line = 0;
+    int total = 0;
+    int seen = 0;
+    bool done = false;
+    bool failed = false;
+
+    if (partial == NULL)
+    {
+        fprintf(output, DECAY_SCENARIO_COLUMNS "\n");
+    }
+
+    while (!done && !failed)
+    {
+        int count = 0;
+        while (count < DECAY_SCENARIO_CHUNK)
+        {
+            if (fgets(text, sizeof(text), input) == NULL)
+            {
+                done = true;
+                break;
+            }
+            line++;
+
+            // Discard the rest of an overlong line; it is reported as malformed.
+            bool overlong = strchr(text, '\n') == NULL && !feof(input);
+            if (overlong)
+            {
+                int c;
+                while ((c = fgetc(input)) != EOF && c != '\n')
+                    ;
+            }
+
+            if (decay_scenario_parse(text, line, &scenarios[count]) == 1)
+            {
+                if (overlong)
+                {
+                    scenarios[count].mode = DECAY_SCENARIO_ERROR;
+                }
+                job = decay_scenario_mix(job, &scenarios[count]);
+                if (!decay_shard_owns(&options->shard, seen++))
+                {
+                    continue;
+                }
+                scenarios[count].cost = decay_scenario_cost(&scenarios[count], options);
+                order[count].cost = scenarios[count].cost;
+                order[count].index = count;
+                count++;
+            }
+        }
+
+        pool_order(order, count);
+
+        decay_scenario_chunk_t chunk = {.scenarios = scenarios, .order = order, .options = options};
+        pool_run(count, options->threads, decay_scenario_job, &chunk);
+
+        decay_stats_t stats = {0};
+        double start = decay_stats_clock();
+        for (int i = 0; i < count; i++)
+        {
+            if (partial == NULL)
+            {
+                decay_scenario_write(output, &scenarios[i]);
+                continue;
+            }
+
+            decay_shard_record_t record = {.index = scenarios[i].line, .mode = scenarios[i].mode, .value = scenarios[i].result};
+            if (decay_partial_write(partial, &record) < 0)
+            {
+                failed = true;
+                break;
+            }
+        }
+        if (partial == NULL)
+        {
+            fflush(output);
+        }
+        stats.io_time = decay_stats_clock() - start;
+        decay_stats_add(&stats);
+
+        total += count;
+    }
+
+    free(scenarios);
+    free(order);
+
+    if (partial != NULL && (decay_partial_close(partial, job, seen) < 0 || failed))
+    {
+        dbprintlf(RED_FG "Failed to write the partial results to %s.", options->partial);
+        return -1;
+    }
+
+    return total;
+}
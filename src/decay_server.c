@@ -0,0 +1,799 @@
+/**
+ * @file decay_server.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Long-running query server with a cache of recent results.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <meb_print.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "pool.h"
+#include "decay_server.h"
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+#define DECAY_SERVER_NO_SOCKET
+#else
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#define SERVER_MAX_LINE 512 // Longest request, as for scenario files.
+#define SERVER_MAX_ID 32    // Longest request ID kept, including the terminator.
+#define SERVER_BUFFER 65536 // Bytes of input and of output buffered per client.
+
+/**
+ * @brief Mode and rounded inputs of a request.
+ *
+ */
+typedef struct
+{
+    double values[6]; // Mass, area, altitude, F10.7, Ap, and mission time.
+    int mode;
+} decay_server_key_t;
+
+/**
+ * @brief One cached result, linked into its hash bucket and into the recency list.
+ *
+ */
+typedef struct
+{
+    decay_server_key_t key;
+    double result;
+    int newer; // Recency list neighbours, or -1.
+    int older;
+    int chain; // Next entry in the same bucket, or -1.
+} decay_server_entry_t;
+
+/**
+ * @brief Least recently used cache of results.
+ *
+ * Only the thread serving the clients touches the cache, so it needs no locks.
+ *
+ */
+typedef struct
+{
+    decay_server_entry_t *entries;
+    int *buckets; // First entry of each bucket, or -1.
+    int mask;     // Buckets - 1; the bucket count is a power of two.
+    int capacity;
+    int count;
+    int newest;
+    int oldest;
+} decay_server_cache_t;
+
+/**
+ * @brief One connection: standard input and output, or a socket client.
+ *
+ */
+typedef struct
+{
+    int input;
+    int output;
+    char in[SERVER_BUFFER];
+    int in_length;
+    char out[SERVER_BUFFER];
+    int out_length;
+    bool discarding; // Dropping the rest of an overlong line.
+    bool ended;      // The input has ended; close once the lines already read are answered.
+    bool closing;    // Close once this batch's responses are written.
+    double read_time; // Time of the last read, the arrival of the lines it completed.
+} decay_server_client_t;
+
+typedef enum
+{
+    SERVER_REQUEST = 0,
+    SERVER_STATS,
+    SERVER_QUIT,
+    SERVER_SHUTDOWN,
+} decay_server_command_t;
+
+/**
+ * @brief One line of a batch.
+ *
+ */
+typedef struct
+{
+    decay_server_client_t *client;
+    decay_server_command_t command;
+    char id[SERVER_MAX_ID];
+    decay_scenario_t scenario;
+    decay_server_key_t key;
+    int run;        // Index into the batch's runs, or -1 if answered from the cache.
+    double arrival; // Time the request was read.
+} decay_server_request_t;
+
+/**
+ * @brief A server and its state between batches.
+ *
+ */
+typedef struct
+{
+    const decay_server_options_t *options;
+    decay_server_cache_t cache;
+    decay_server_stats_t stats;
+    int bits; // Mantissa bits kept by the cache keys.
+    decay_server_request_t *requests;
+    decay_scenario_t *runs;
+    int *run_request; // First request of each run.
+    bool shutdown;
+} decay_server_t;
+
+static double decay_server_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Rounds to a number of significant bits.
+static inline double decay_server_quantize(double value, int bits)
+{
+    int exponent = 0;
+    double mantissa = frexp(value, &exponent);
+    return ldexp(round(ldexp(mantissa, bits)), exponent - bits);
+}
+
+static uint64_t decay_server_hash(const decay_server_key_t *key)
+{
+    uint64_t hash = 0x9E3779B97F4A7C15ULL * (key->mode + 1);
+    for (int i = 0; i < 6; i++)
+    {
+        uint64_t bits;
+        memcpy(&bits, &key->values[i], sizeof(bits));
+        hash ^= bits + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+    }
+    hash ^= hash >> 31;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    return hash ^ (hash >> 29);
+}
+
+static inline bool decay_server_key_equal(const decay_server_key_t *x, const decay_server_key_t *y)
+{
+    if (x->mode != y->mode)
+    {
+        return false;
+    }
+    for (int i = 0; i < 6; i++)
+    {
+        if (x->values[i] != y->values[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int decay_server_cache_init(decay_server_cache_t *cache, int capacity)
+{
+    memset(cache, 0, sizeof(*cache));
+    cache->newest = cache->oldest = -1;
+    cache->capacity = capacity;
+    if (capacity == 0)
+    {
+        return 0;
+    }
+
+    int buckets = 1;
+    while (buckets < 2 * capacity)
+    {
+        buckets *= 2;
+    }
+
+    cache->entries = malloc(capacity * sizeof(decay_server_entry_t));
+    cache->buckets = malloc(buckets * sizeof(int));
+    if (cache->entries == NULL || cache->buckets == NULL)
+    {
+        dbprintlf(RED_FG "Failed to allocate a cache of %d results.", capacity);
+        free(cache->entries);
+        free(cache->buckets);
+        return -1;
+    }
+
+    cache->mask = buckets - 1;
+    for (int i = 0; i < buckets; i++)
+    {
+        cache->buckets[i] = -1;
+    }
+    return 0;
+}
+
+static void decay_server_cache_free(decay_server_cache_t *cache)
+{
+    free(cache->entries);
+    free(cache->buckets);
+}
+
+static void decay_server_cache_unlink(decay_server_cache_t *cache, int index)
+{
+    decay_server_entry_t *entry = &cache->entries[index];
+    if (entry->newer >= 0) {cache->entries[entry->newer].older = entry->older;} else {cache->newest = entry->older;}
+    if (entry->older >= 0) {cache->entries[entry->older].newer = entry->newer;} else {cache->oldest = entry->newer;}
+}
+
+static void decay_server_cache_push(decay_server_cache_t *cache, int index)
+{
+    decay_server_entry_t *entry = &cache->entries[index];
+    entry->newer = -1;
+    entry->older = cache->newest;
+    if (cache->newest >= 0) {cache->entries[cache->newest].newer = index;}
+    cache->newest = index;
+    if (cache->oldest < 0) {cache->oldest = index;}
+}
+
+// Finds a result and marks it as the most recently used.
+static bool decay_server_cache_get(decay_server_cache_t *cache, const decay_server_key_t *key, double *result)
+{
+    if (cache->capacity == 0)
+    {
+        return false;
+    }
+
+    for (int index = cache->buckets[decay_server_hash(key) & cache->mask]; index >= 0; index = cache->entries[index].chain)
+    {
+        if (decay_server_key_equal(&cache->entries[index].key, key))
+        {
+            decay_server_cache_unlink(cache, index);
+            decay_server_cache_push(cache, index);
+            *result = cache->entries[index].result;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Adds a result, evicting the least recently used one when full.
+static void decay_server_cache_put(decay_server_cache_t *cache, const decay_server_key_t *key, double result)
+{
+    if (cache->capacity == 0)
+    {
+        return;
+    }
+
+    int index = cache->count;
+    if (cache->count == cache->capacity)
+    {
+        index = cache->oldest;
+        decay_server_cache_unlink(cache, index);
+
+        int *link = &cache->buckets[decay_server_hash(&cache->entries[index].key) & cache->mask];
+        while (*link != index)
+        {
+            link = &cache->entries[*link].chain;
+        }
+        *link = cache->entries[index].chain;
+    }
+    else
+    {
+        cache->count++;
+    }
+
+    decay_server_entry_t *entry = &cache->entries[index];
+    entry->key = *key;
+    entry->result = result;
+
+    int *bucket = &cache->buckets[decay_server_hash(key) & cache->mask];
+    entry->chain = *bucket;
+    *bucket = index;
+    decay_server_cache_push(cache, index);
+}
+
+int decay_server_format_stats(const decay_server_stats_t *stats, char *buffer, int size)
+{
+    // Percentiles are reported as the upper edge of their histogram bin, or the maximum if lower.
+    uint64_t timed = 0;
+    for (int i = 0; i < DECAY_SERVER_LATENCY_BINS; i++)
+    {
+        timed += stats->latency_histogram[i];
+    }
+
+    double percentile[2] = {0, 0};
+    const double levels[2] = {0.5, 0.99};
+    for (int p = 0; p < 2; p++)
+    {
+        uint64_t seen = 0;
+        for (int i = 0; i < DECAY_SERVER_LATENCY_BINS && timed > 0; i++)
+        {
+            seen += stats->latency_histogram[i];
+            if (seen >= levels[p] * timed)
+            {
+                percentile[p] = i < DECAY_SERVER_LATENCY_BINS - 1 && ldexp(1, i) * 1e-6 < stats->latency_max ? ldexp(1, i) * 1e-6 : stats->latency_max;
+                break;
+            }
+        }
+    }
+
+    return snprintf(buffer, size, "stats requests=%" PRIu64 " hits=%" PRIu64 " misses=%" PRIu64 " errors=%" PRIu64 " hit_rate=%.4f entries=%d latency_mean_ms=%.3f latency_p50_ms=%.3f latency_p99_ms=%.3f latency_max_ms=%.3f",
+                    stats->requests, stats->hits, stats->misses, stats->errors, stats->hits + stats->misses > 0 ? (double)stats->hits / (stats->hits + stats->misses) : 0, stats->entries,
+                    timed > 0 ? 1e3 * stats->latency_total / timed : 0, 1e3 * percentile[0], 1e3 * percentile[1], 1e3 * stats->latency_max);
+}
+
+// Writes everything buffered for a client; a client that cannot be written to is closed.
+static void decay_server_flush(decay_server_client_t *client)
+{
+    int written = 0;
+    while (written < client->out_length)
+    {
+        ssize_t n = write(client->output, client->out + written, client->out_length - written);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            client->closing = true;
+            break;
+        }
+        written += n;
+    }
+    client->out_length = 0;
+}
+
+static void decay_server_respond(decay_server_client_t *client, const char *text, int length)
+{
+    if (client->out_length + length + 1 > SERVER_BUFFER)
+    {
+        decay_server_flush(client);
+    }
+    length = length < SERVER_BUFFER - 1 ? length : SERVER_BUFFER - 1;
+    memcpy(client->out + client->out_length, text, length);
+    client->out_length += length;
+    client->out[client->out_length++] = '\n';
+}
+
+// Parses one line into a request; the ID is the first token, and the rest is a scenario line.
+static void decay_server_parse(decay_server_request_t *request, const char *line, int length)
+{
+    char text[SERVER_MAX_LINE];
+    length = length < SERVER_MAX_LINE - 1 ? length : SERVER_MAX_LINE - 1;
+    memcpy(text, line, length);
+    text[length] = '\0';
+
+    char *start = text + strspn(text, " \t\r");
+    char *end = start + strcspn(start, ", \t\r");
+    int id_length = end - start < SERVER_MAX_ID - 1 ? end - start : SERVER_MAX_ID - 1;
+    memcpy(request->id, start, id_length);
+    request->id[id_length] = '\0';
+
+    char *rest = end + strspn(end, ", \t\r");
+    request->command = SERVER_REQUEST;
+    if (*rest == '\0')
+    {
+        request->command = !strcmp(request->id, "stats") ? SERVER_STATS : !strcmp(request->id, "quit") ? SERVER_QUIT : !strcmp(request->id, "shutdown") ? SERVER_SHUTDOWN : SERVER_REQUEST;
+    }
+
+    if (request->command != SERVER_REQUEST || decay_scenario_parse(rest, 0, &request->scenario) == 0)
+    {
+        request->scenario.mode = DECAY_SCENARIO_ERROR;
+    }
+}
+
+// Moves the complete lines of a client's input into the batch.
+static int decay_server_take(decay_server_t *server, decay_server_client_t *client, int count)
+{
+    int consumed = 0;
+    while (count < DECAY_SERVER_CHUNK && !client->closing)
+    {
+        char *newline = memchr(client->in + consumed, '\n', client->in_length - consumed);
+        if (newline == NULL)
+        {
+            break;
+        }
+
+        int length = newline - (client->in + consumed);
+        bool discarded = client->discarding;
+        client->discarding = false;
+
+        if (discarded || length >= SERVER_MAX_LINE)
+        {
+            // The tail of an overlong line is answered as a malformed request.
+            decay_server_request_t *request = &server->requests[count++];
+            memset(request, 0, sizeof(*request));
+            request->client = client;
+            request->scenario.mode = DECAY_SCENARIO_ERROR;
+            request->arrival = client->read_time;
+        }
+        else if (length > 0 && strspn(client->in + consumed, " \t\r") < (size_t)length)
+        {
+            decay_server_request_t *request = &server->requests[count++];
+            memset(request, 0, sizeof(*request));
+            request->client = client;
+            request->arrival = client->read_time;
+            decay_server_parse(request, client->in + consumed, length);
+            if (request->command == SERVER_QUIT)
+            {
+                client->closing = true;
+            }
+        }
+        consumed += length + 1;
+    }
+
+    memmove(client->in, client->in + consumed, client->in_length - consumed);
+    client->in_length -= consumed;
+
+    // A full buffer without a line break holds an overlong line; one that still holds complete lines waits for the next batch.
+    if (client->in_length == SERVER_BUFFER && memchr(client->in, '\n', client->in_length) == NULL)
+    {
+        client->in_length = 0;
+        client->discarding = true;
+    }
+    return count;
+}
+
+static void decay_server_job(int index, void *context)
+{
+    decay_server_t *server = context;
+    decay_scenario_evaluate(&server->runs[index], &server->options->scenario);
+}
+
+// Records the outcome and latency of a request as its response is built; the first request of a run is its miss, and the others hits.
+static void decay_server_count(decay_server_t *server, const decay_server_request_t *request, int index, double now)
+{
+    server->stats.requests++;
+    if (request->scenario.mode == DECAY_SCENARIO_ERROR)
+    {
+        server->stats.errors++;
+    }
+    else if (request->run >= 0 && server->run_request[request->run] == index)
+    {
+        server->stats.misses++;
+    }
+    else
+    {
+        server->stats.hits++;
+    }
+
+    double latency = now - request->arrival;
+    int bin = 0;
+    while (bin < DECAY_SERVER_LATENCY_BINS - 1 && latency >= ldexp(1, bin) * 1e-6)
+    {
+        bin++;
+    }
+
+    server->stats.latency_total += latency;
+    server->stats.latency_max = latency > server->stats.latency_max ? latency : server->stats.latency_max;
+    server->stats.latency_histogram[bin]++;
+}
+
+// Answers a batch: cache hits and repeats first, then the distinct misses across the pool, then every response in order.
+static void decay_server_process(decay_server_t *server, int count)
+{
+    int runs = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        decay_server_request_t *request = &server->requests[i];
+        decay_scenario_t *scenario = &request->scenario;
+        request->run = -1;
+
+        if (request->command != SERVER_REQUEST)
+        {
+            continue;
+        }
+
+        if (scenario->mode == DECAY_SCENARIO_ERROR)
+        {
+            continue;
+        }
+
+        double *values[6] = {&scenario->satellite_mass, &scenario->satellite_area, &scenario->altitude, &scenario->solar_radio_flux, &scenario->geomagnetic_a_index, &scenario->mission_time};
+        memset(&request->key, 0, sizeof(request->key));
+        request->key.mode = scenario->mode;
+        for (int v = 0; v < 6; v++)
+        {
+            *values[v] = decay_server_quantize(*values[v], server->bits);
+            request->key.values[v] = *values[v];
+        }
+
+        if (decay_server_cache_get(&server->cache, &request->key, &scenario->result))
+        {
+            continue;
+        }
+
+        for (int r = 0; r < runs; r++)
+        {
+            if (decay_server_key_equal(&server->requests[server->run_request[r]].key, &request->key))
+            {
+                request->run = r;
+                break;
+            }
+        }
+
+        if (request->run < 0)
+        {
+            request->run = runs;
+            server->runs[runs] = *scenario;
+            server->run_request[runs] = i;
+            runs++;
+        }
+    }
+
+    pool_run(runs, server->options->scenario.threads, decay_server_job, server);
+
+    // Requests are counted and results cached as their responses are built, so that a stats command reports exactly those answered before it.
+    double now = decay_server_now();
+    char line[SERVER_MAX_LINE];
+    static const char *modes[] = {"ttr", "srf", "geo", "error"};
+    for (int i = 0; i < count; i++)
+    {
+        decay_server_request_t *request = &server->requests[i];
+        int length = 0;
+
+        switch (request->command)
+        {
+        case SERVER_STATS:
+            server->stats.entries = server->cache.count;
+            length = decay_server_format_stats(&server->stats, line, sizeof(line));
+            break;
+        case SERVER_QUIT:
+            continue;
+        case SERVER_SHUTDOWN:
+            server->shutdown = true;
+            continue;
+        default:
+            // A run that finds its orbit outside the atmosphere model answers every request for it as malformed, and is not cached.
+            if (request->run >= 0 && server->runs[request->run].mode == DECAY_SCENARIO_ERROR)
+            {
+                request->scenario.mode = DECAY_SCENARIO_ERROR;
+            }
+            decay_server_count(server, request, i, now);
+            if (request->run >= 0 && server->run_request[request->run] == i && request->scenario.mode != DECAY_SCENARIO_ERROR)
+            {
+                decay_server_cache_put(&server->cache, &request->key, server->runs[request->run].result);
+            }
+            if (request->scenario.mode == DECAY_SCENARIO_ERROR)
+            {
+                length = snprintf(line, sizeof(line), "%s,error,", request->id);
+            }
+            else
+            {
+                double result = request->run >= 0 ? server->runs[request->run].result : request->scenario.result;
+                length = snprintf(line, sizeof(line), "%s,%s,%f", request->id, modes[request->scenario.mode], result);
+            }
+            break;
+        }
+
+        length = length < (int)sizeof(line) ? length : (int)sizeof(line) - 1;
+        decay_server_respond(request->client, line, length);
+    }
+    server->stats.entries = server->cache.count;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (server->requests[i].client->out_length > 0)
+        {
+            decay_server_flush(server->requests[i].client);
+        }
+    }
+}
+
+// Reads what is available from a client; returns the bytes read, 0 at the end of its input, or -1 on error.
+static int decay_server_fill(decay_server_client_t *client)
+{
+    ssize_t n;
+    do
+    {
+        n = read(client->input, client->in + client->in_length, SERVER_BUFFER - client->in_length);
+    } while (n < 0 && errno == EINTR);
+
+    if (n > 0)
+    {
+        client->in_length += n;
+        client->read_time = decay_server_now();
+    }
+    return n;
+}
+
+// Marks the end of a client's input; a last request without a line break is still answered.
+static void decay_server_end(decay_server_client_t *client)
+{
+    client->ended = true;
+    if (client->in_length > 0 && client->in_length < SERVER_BUFFER && !client->discarding)
+    {
+        client->in[client->in_length++] = '\n';
+    }
+}
+
+// Serves the complete lines buffered by a set of clients, a batch at a time.
+static void decay_server_drain(decay_server_t *server, decay_server_client_t **clients, int client_count)
+{
+    while (true)
+    {
+        int count = 0;
+        for (int c = 0; c < client_count; c++)
+        {
+            count = decay_server_take(server, clients[c], count);
+        }
+        if (count == 0)
+        {
+            return;
+        }
+        decay_server_process(server, count);
+    }
+}
+
+static int decay_server_stream(decay_server_t *server)
+{
+    decay_server_client_t *client = calloc(1, sizeof(decay_server_client_t));
+    if (client == NULL)
+    {
+        return -1;
+    }
+    client->input = STDIN_FILENO;
+    client->output = STDOUT_FILENO;
+
+    // A blocking read returns everything already written, which forms the next batch.
+    while (!server->shutdown && !client->closing && !client->ended)
+    {
+        if (decay_server_fill(client) <= 0)
+        {
+            decay_server_end(client);
+        }
+        decay_server_drain(server, &client, 1);
+    }
+
+    free(client);
+    return 0;
+}
+
+#ifndef DECAY_SERVER_NO_SOCKET
+static int decay_server_socket(decay_server_t *server, const char *path)
+{
+    struct sockaddr_un address = {0};
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        dbprintlf(RED_FG "Socket path %s is too long.", path);
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        erprintlf(errno);
+        return -1;
+    }
+
+    unlink(path);
+    if (bind(listener, (struct sockaddr *)&address, sizeof(address)) < 0 || listen(listener, DECAY_SERVER_CLIENTS) < 0)
+    {
+        erprintlf(errno);
+        close(listener);
+        return -1;
+    }
+
+    decay_server_client_t *clients[DECAY_SERVER_CLIENTS];
+    int client_count = 0;
+    struct pollfd fds[DECAY_SERVER_CLIENTS + 1];
+
+    // A stop request ends the loop like a shutdown command, so that the socket file is removed.
+    while (!server->shutdown && !(server->options->stop != NULL && *server->options->stop))
+    {
+        fds[0] = (struct pollfd){listener, client_count < DECAY_SERVER_CLIENTS ? POLLIN : 0, 0};
+        for (int c = 0; c < client_count; c++)
+        {
+            fds[c + 1] = (struct pollfd){clients[c]->input, POLLIN, 0};
+        }
+
+        if (poll(fds, client_count + 1, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            erprintlf(errno);
+            break;
+        }
+
+        for (int c = 0; c < client_count; c++)
+        {
+            if ((fds[c + 1].revents & (POLLIN | POLLHUP | POLLERR)) && decay_server_fill(clients[c]) <= 0)
+            {
+                decay_server_end(clients[c]);
+            }
+        }
+
+        decay_server_drain(server, clients, client_count);
+
+        // Closed clients are removed before new ones join, so that the poll set matches the clients.
+        for (int c = 0; c < client_count;)
+        {
+            if (clients[c]->closing || clients[c]->ended)
+            {
+                close(clients[c]->input);
+                free(clients[c]);
+                clients[c] = clients[--client_count];
+                continue;
+            }
+            c++;
+        }
+
+        if (fds[0].revents & POLLIN)
+        {
+            int fd = accept(listener, NULL, NULL);
+            decay_server_client_t *client = fd >= 0 ? calloc(1, sizeof(decay_server_client_t)) : NULL;
+            if (client != NULL)
+            {
+                client->input = client->output = fd;
+                clients[client_count++] = client;
+            }
+            else if (fd >= 0)
+            {
+                close(fd);
+            }
+        }
+    }
+
+    for (int c = 0; c < client_count; c++)
+    {
+        close(clients[c]->input);
+        free(clients[c]);
+    }
+    close(listener);
+    unlink(path);
+
+    return 0;
+}
+#endif
+
+int decay_server_run(const char *path, const decay_server_options_t *options, decay_server_stats_t *stats)
+{
+    decay_server_t server = {0};
+    server.options = options;
+
+    double quantum = options->quantum > 0 ? options->quantum : DECAY_SERVER_QUANTUM;
+    server.bits = (int)ceil(-log2(quantum));
+    server.bits = server.bits < 1 ? 1 : server.bits > 53 ? 53 : server.bits;
+
+    server.requests = malloc(DECAY_SERVER_CHUNK * sizeof(decay_server_request_t));
+    server.runs = malloc(DECAY_SERVER_CHUNK * sizeof(decay_scenario_t));
+    server.run_request = malloc(DECAY_SERVER_CHUNK * sizeof(int));
+    if (server.requests == NULL || server.runs == NULL || server.run_request == NULL ||
+        decay_server_cache_init(&server.cache, options->cache_entries < 0 ? DECAY_SERVER_CACHE : options->cache_entries) < 0)
+    {
+        dbprintlf(RED_FG "Failed to allocate the server.");
+        free(server.requests);
+        free(server.runs);
+        free(server.run_request);
+        return -1;
+    }
+
+    int retval = 0;
+    if (!strcmp(path, "-"))
+    {
+        retval = decay_server_stream(&server);
+    }
+    else
+    {
+#ifdef DECAY_SERVER_NO_SOCKET
+        dbprintlf(RED_FG "Sockets are unavailable; serve standard input with \"-\".");
+        retval = -1;
+#else
+        retval = decay_server_socket(&server, path);
+#endif
+    }
+
+    if (stats != NULL)
+    {
+        *stats = server.stats;
+    }
+
+    decay_server_cache_free(&server.cache);
+    free(server.requests);
+    free(server.runs);
+    free(server.run_request);
+
+    return retval;
+}
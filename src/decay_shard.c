@@ -0,0 +1,469 @@
+/**
+ * @file decay_shard.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Jobs split across processes, with mergeable partial results.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <meb_print.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pool.h"
+#include "decay_digest.h"
+#include "decay_scenario.h"
+#include "decay_shard.h"
+
+#define SHARD_SWEEP_COLUMNS "run,altitude,days"
+#define SHARD_MONTE_CARLO_COLUMNS "statistic,days,samples"
+
+struct decay_partial
+{
+    FILE *fp;
+    decay_shard_header_t header;
+};
+
+static const decay_shard_t decay_shard_whole = {0, 1};
+
+int decay_shard_parse(const char *text, decay_shard_t *shard)
+{
+    int index = 0, count = 0, consumed = 0;
+    if (sscanf(text, "%d/%d%n", &index, &count, &consumed) != 2 || text[consumed] != '\0' || index < 0 || index >= count)
+    {
+        return -1;
+    }
+
+    shard->index = index;
+    shard->count = count;
+    return 0;
+}
+
+void decay_shard_range(const decay_shard_t *shard, int total, int *first, int *count)
+{
+    if (shard->count < 2)
+    {
+        *first = 0;
+        *count = total;
+        return;
+    }
+
+    int share = total / shard->count, extra = total % shard->count;
+    *first = shard->index * share + (shard->index < extra ? shard->index : extra);
+    *count = share + (shard->index < extra);
+}
+
+decay_partial_t *decay_partial_create(const char *path, decay_shard_kind_t kind, const decay_shard_t *shard)
+{
+    decay_partial_t *partial = calloc(1, sizeof(decay_partial_t));
+    if (partial == NULL)
+    {
+        dbprintlf(RED_FG "Failed to allocate a partial result file.");
+        return NULL;
+    }
+
+    partial->fp = fopen(path, "wb");
+    if (partial->fp == NULL)
+    {
+        erprintlf(errno);
+        free(partial);
+        return NULL;
+    }
+
+    shard = shard->count < 2 ? &decay_shard_whole : shard;
+
+    decay_shard_header_t *header = &partial->header;
+    memcpy(header->magic, DECAY_SHARD_MAGIC, sizeof(header->magic));
+    header->version = DECAY_SHARD_VERSION;
+    header->header_size = sizeof(decay_shard_header_t);
+    header->byte_order = DECAY_SHARD_BYTE_ORDER;
+    header->kind = kind;
+    header->index = shard->index;
+    header->shards = shard->count;
+
+    // The header is rewritten with the job's digest and totals once every record is in.
+    if (fwrite(header, sizeof(decay_shard_header_t), 1, partial->fp) != 1)
+    {
+        erprintlf(errno);
+        fclose(partial->fp);
+        free(partial);
+        return NULL;
+    }
+
+    return partial;
+}
+
+int decay_partial_write(decay_partial_t *partial, const decay_shard_record_t *record)
+{
+    if (fwrite(record, sizeof(decay_shard_record_t), 1, partial->fp) != 1)
+    {
+        erprintlf(errno);
+        return -1;
+    }
+
+    partial->header.count++;
+    return 0;
+}
+
+int decay_partial_close(decay_partial_t *partial, uint64_t job, int total)
+{
+    if (partial == NULL)
+    {
+        return 0;
+    }
+
+    partial->header.job = job;
+    partial->header.total = total;
+
+    int retval = 0;
+    if (fseek(partial->fp, 0, SEEK_SET) != 0 || fwrite(&partial->header, sizeof(decay_shard_header_t), 1, partial->fp) != 1)
+    {
+        erprintlf(errno);
+        retval = -1;
+    }
+
+    if (fclose(partial->fp) != 0)
+    {
+        retval = -1;
+    }
+
+    free(partial);
+    return retval;
+}
+
+static void decay_shard_sweep_write(FILE *output, const decay_shard_record_t *record)
+{
+    fprintf(output, "%u,%f,%f\n", record->index, record->input, record->value);
+}
+
+typedef struct
+{
+    const decay_shard_sweep_t *sweep;
+    decay_shard_record_t *records;
+    int count;
+} decay_shard_sweep_context_t;
+
+static void decay_shard_sweep_job(int index, void *context)
+{
+    decay_shard_sweep_context_t *run = context;
+    const decay_shard_sweep_t *sweep = run->sweep;
+    // Higher runs live longer and are started first: job 0 takes the last record.
+    decay_shard_record_t *record = &run->records[run->count - 1 - index];
+
+    double lifetime = decay_calculate_lifetime(sweep->engine, sweep->satellite_mass, sweep->satellite_area, record->input, sweep->solar_radio_flux, sweep->geomagnetic_a_index, sweep->tolerance, LIFETIME_LIMIT);
+    record->value = lifetime < 0 ? -1 : lifetime / 86400;
+}
+
+// Digest of the inputs of a sweep, shared by all of its shards.
+static uint64_t decay_shard_sweep_digest(const decay_shard_sweep_t *sweep)
+{
+    double inputs[] = {sweep->engine, sweep->satellite_mass, sweep->satellite_area, sweep->altitude, sweep->solar_radio_flux, sweep->geomagnetic_a_index, sweep->runs, sweep->run_increment, sweep->tolerance};
+    return decay_digest_mix(DECAY_DIGEST_BASIS, inputs, sizeof(inputs));
+}
+
+int decay_shard_sweep(const decay_shard_sweep_t *sweep, const decay_shard_t *shard, FILE *output, const char *partial)
+{
+    shard = shard != NULL ? shard : &decay_shard_whole;
+
+    if (sweep->runs < 1 || sweep->run_increment <= 0 || sweep->satellite_mass <= 0 || sweep->satellite_area <= 0 ||
+        sweep->altitude * 1000 <= KARMAN_LINE || sweep->altitude > MAX_ALTITUDE ||
+        sweep->engine < DECAY_ENGINE_FIXED || sweep->engine > DECAY_ENGINE_QUADRATURE)
+    {
+        dbprintlf(RED_FG "Invalid sweep inputs.");
+        return -1;
+    }
+
+    decay_shard_record_t *records = malloc(sweep->runs * sizeof(decay_shard_record_t));
+    if (records == NULL)
+    {
+        dbprintlf(RED_FG "Failed to allocate %d runs.", sweep->runs);
+        return -1;
+    }
+
+    int count = 0;
+    for (int run = 1; run <= sweep->runs; run++)
+    {
+        if (decay_shard_owns(shard, run - 1))
+        {
+            records[count++] = (decay_shard_record_t){run, 0, decay_sweep_altitude(sweep->altitude, sweep->run_increment, run), -1};
+        }
+    }
+
+    decay_shard_sweep_context_t context = {.sweep = sweep, .records = records, .count = count};
+    pool_run(count, sweep->threads, decay_shard_sweep_job, &context);
+
+    int retval = count;
+    if (partial != NULL)
+    {
+        decay_partial_t *file = decay_partial_create(partial, DECAY_SHARD_SWEEP, shard);
+        for (int i = 0; file != NULL && i < count && retval >= 0; i++)
+        {
+            retval = decay_partial_write(file, &records[i]) < 0 ? -1 : retval;
+        }
+        if (file == NULL || decay_partial_close(file, decay_shard_sweep_digest(sweep), sweep->runs) < 0)
+        {
+            retval = -1;
+        }
+    }
+    else
+    {
+        fprintf(output, SHARD_SWEEP_COLUMNS "\n");
+        for (int i = 0; i < count; i++)
+        {
+            decay_shard_sweep_write(output, &records[i]);
+        }
+        fflush(output);
+    }
+
+    free(records);
+    return retval;
+}
+
+static void decay_shard_monte_carlo_write(FILE *output, const double *lifetimes, int samples)
+{
+    decay_monte_carlo_summary_t summary;
+    fprintf(output, SHARD_MONTE_CARLO_COLUMNS "\n");
+    if (decay_monte_carlo_summarize(lifetimes, samples, &summary) < 0)
+    {
+        fprintf(output, "all,,0\n");
+        return;
+    }
+
+    fprintf(output, "all,,%d\n", summary.samples);
+    fprintf(output, "exceeded,,%d\n", summary.exceeded);
+    fprintf(output, "mean,%f,%d\n", summary.mean < 0 ? -1 : summary.mean / 86400, summary.samples - summary.exceeded);
+    for (int i = 0; i < DECAY_MONTE_CARLO_LEVELS; i++)
+    {
+        fprintf(output, "p%.0f,%f,\n", summary.level[i], summary.percentile[i] < 0 ? -1 : summary.percentile[i] / 86400);
+    }
+    for (int i = 0; i < DECAY_MONTE_CARLO_BINS && summary.samples > summary.exceeded; i++)
+    {
+        fprintf(output, "bin,%f,%d\n", (summary.histogram_first + i * summary.histogram_width) / 86400, summary.histogram[i]);
+    }
+    fflush(output);
+}
+
+// Digest of the inputs of a Monte Carlo run, shared by all of its shards.
+static uint64_t decay_shard_monte_carlo_digest(const decay_monte_carlo_t *config)
+{
+    const decay_distribution_t *distributions[] = {&config->satellite_mass, &config->satellite_area, &config->solar_radio_flux, &config->geomagnetic_a_index};
+    double inputs[] = {config->altitude, config->samples, config->engine, config->tolerance};
+
+    uint64_t digest = decay_digest_mix(DECAY_DIGEST_BASIS, inputs, sizeof(inputs));
+    for (int i = 0; i < 4; i++)
+    {
+        double distribution[] = {distributions[i]->kind, distributions[i]->a, distributions[i]->b};
+        digest = decay_digest_mix(digest, distribution, sizeof(distribution));
+    }
+    return decay_digest_mix(digest, &config->seed, sizeof(config->seed));
+}
+
+int decay_shard_monte_carlo(const decay_monte_carlo_t *config, const decay_shard_t *shard, FILE *output, const char *partial)
+{
+    shard = shard != NULL ? shard : &decay_shard_whole;
+
+    if (config->offset != 0 || config->samples < 1)
+    {
+        dbprintlf(RED_FG "Invalid Monte Carlo inputs.");
+        return -1;
+    }
+
+    // The shard draws the samples of its block exactly as the whole run would.
+    decay_monte_carlo_t block = *config;
+    decay_shard_range(shard, config->samples, &block.offset, &block.samples);
+
+    double *lifetimes = malloc(block.samples > 0 ? block.samples * sizeof(double) : 1);
+    if (lifetimes == NULL)
+    {
+        dbprintlf(RED_FG "Failed to allocate %d samples.", block.samples);
+        return -1;
+    }
+
+    if (block.samples > 0 && decay_monte_carlo(&block, lifetimes) < 0)
+    {
+        free(lifetimes);
+        return -1;
+    }
+
+    int retval = block.samples;
+    if (partial != NULL)
+    {
+        decay_partial_t *file = decay_partial_create(partial, DECAY_SHARD_MONTE_CARLO, shard);
+        for (int i = 0; file != NULL && i < block.samples && retval >= 0; i++)
+        {
+            decay_shard_record_t record = {.index = block.offset + i, .value = lifetimes[i]};
+            retval = decay_partial_write(file, &record) < 0 ? -1 : retval;
+        }
+        if (file == NULL || decay_partial_close(file, decay_shard_monte_carlo_digest(config), config->samples) < 0)
+        {
+            retval = -1;
+        }
+    }
+    else
+    {
+        decay_shard_monte_carlo_write(output, lifetimes, block.samples);
+    }
+
+    free(lifetimes);
+    return retval;
+}
+
+// Orders records by item.
+static int decay_shard_compare(const void *a, const void *b)
+{
+    const decay_shard_record_t *x = a, *y = b;
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+// Reads a partial result file, appending its records.
+static int decay_shard_read(const char *path, decay_shard_header_t *header, decay_shard_record_t **records, size_t *count)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        erprintlf(errno);
+        return -1;
+    }
+
+    int retval = -1;
+    decay_shard_record_t *grown = NULL;
+    if (fread(header, sizeof(decay_shard_header_t), 1, fp) != 1 ||
+        memcmp(header->magic, DECAY_SHARD_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != DECAY_SHARD_VERSION ||
+        header->byte_order != DECAY_SHARD_BYTE_ORDER ||
+        header->header_size != sizeof(decay_shard_header_t))
+    {
+        dbprintlf(RED_FG "%s is not a version %d partial result file for this host.", path, DECAY_SHARD_VERSION);
+    }
+    else if (header->count > header->total || (grown = realloc(*records, (*count + header->count + 1) * sizeof(decay_shard_record_t))) == NULL)
+    {
+        dbprintlf(RED_FG "Failed to allocate the %u records of %s.", header->count, path);
+    }
+    else if (*records = grown, fread(grown + *count, sizeof(decay_shard_record_t), header->count, fp) != header->count)
+    {
+        dbprintlf(RED_FG "%s holds fewer than its %u records.", path, header->count);
+    }
+    else
+    {
+        *count += header->count;
+        retval = 0;
+    }
+
+    fclose(fp);
+    return retval;
+}
+
+int decay_shard_merge(const char *const *paths, int count, FILE *output)
+{
+    if (count < 1)
+    {
+        dbprintlf(RED_FG "No partial result files to merge.");
+        return -1;
+    }
+
+    decay_shard_header_t first, header;
+    decay_shard_record_t *records = NULL;
+    size_t total = 0;
+    bool *merged = NULL;
+    int retval = -1;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (decay_shard_read(paths[i], i == 0 ? &first : &header, &records, &total) < 0)
+        {
+            goto cleanup;
+        }
+
+        if (i == 0)
+        {
+            header = first;
+            merged = calloc(first.shards, sizeof(bool));
+            if (merged == NULL)
+            {
+                dbprintlf(RED_FG "Failed to allocate %u shards.", first.shards);
+                goto cleanup;
+            }
+        }
+        else if (header.kind != first.kind || header.job != first.job || header.shards != first.shards || header.total != first.total)
+        {
+            dbprintlf(RED_FG "%s is a partial result of another job than %s.", paths[i], paths[0]);
+            goto cleanup;
+        }
+
+        if (header.index >= header.shards || merged[header.index])
+        {
+            dbprintlf(RED_FG "%s repeats shard %u of %u.", paths[i], header.index, header.shards);
+            goto cleanup;
+        }
+        merged[header.index] = true;
+    }
+
+    if (count != (int)first.shards || total != first.total)
+    {
+        dbprintlf(RED_FG "The files hold %d of %u shards and %zu of %u items.", count, first.shards, total, first.total);
+        goto cleanup;
+    }
+
+    qsort(records, total, sizeof(decay_shard_record_t), decay_shard_compare);
+    for (size_t i = 1; i < total; i++)
+    {
+        if (records[i].index == records[i - 1].index)
+        {
+            dbprintlf(RED_FG "Item %u appears in more than one file.", records[i].index);
+            goto cleanup;
+        }
+    }
+
+    switch (first.kind)
+    {
+    case DECAY_SHARD_BATCH:
+        fprintf(output, DECAY_SCENARIO_COLUMNS "\n");
+        for (size_t i = 0; i < total; i++)
+        {
+            decay_scenario_t scenario = {
+                .line = records[i].index,
+                .mode = records[i].mode,
+                .result = records[i].value,
+            };
+            decay_scenario_write(output, &scenario);
+        }
+        break;
+    case DECAY_SHARD_SWEEP:
+        fprintf(output, SHARD_SWEEP_COLUMNS "\n");
+        for (size_t i = 0; i < total; i++)
+        {
+            decay_shard_sweep_write(output, &records[i]);
+        }
+        break;
+    case DECAY_SHARD_MONTE_CARLO:
+    {
+        // Sorted by sample index, the values are exactly those of a single run.
+        double *lifetimes = malloc(total > 0 ? total * sizeof(double) : 1);
+        if (lifetimes == NULL)
+        {
+            dbprintlf(RED_FG "Failed to allocate %zu samples.", total);
+            goto cleanup;
+        }
+        for (size_t i = 0; i < total; i++)
+        {
+            lifetimes[i] = records[i].value;
+        }
+        decay_shard_monte_carlo_write(output, lifetimes, total);
+        free(lifetimes);
+        break;
+    }
+    default:
+        dbprintlf(RED_FG "Unknown kind of job %u.", first.kind);
+        goto cleanup;
+    }
+    fflush(output);
+    retval = total;
+
+cleanup:
+    free(records);
+    free(merged);
+    return retval;
+}
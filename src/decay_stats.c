@@ -0,0 +1,138 @@
+/**
+ * @file decay_stats.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Runtime counters and timers of the re-entry calculations.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "decay_stats.h"
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+#define DECAY_STATS_NO_RUSAGE
+#else
+#include <sys/resource.h>
+#endif
+
+// Totals are merged by whole propagations, so plain atomic additions are cheap enough; times are kept in nanoseconds.
+static atomic_bool decay_stats_on;
+static _Atomic uint64_t decay_stats_runs;
+static _Atomic uint64_t decay_stats_steps;
+static _Atomic uint64_t decay_stats_rejected_steps;
+static _Atomic uint64_t decay_stats_density_evaluations;
+static _Atomic uint64_t decay_stats_exp_calls;
+static _Atomic uint64_t decay_stats_pow_calls;
+static _Atomic uint64_t decay_stats_solves;
+static _Atomic uint64_t decay_stats_solver_iterations;
+static _Atomic uint64_t decay_stats_solver_failures;
+static _Atomic uint64_t decay_stats_physics_ns;
+static _Atomic uint64_t decay_stats_io_ns;
+
+void decay_stats_enable(bool enabled)
+{
+#ifdef DECAY_NO_STATS
+    (void)enabled;
+#else
+    atomic_store_explicit(&decay_stats_on, enabled, memory_order_relaxed);
+#endif
+}
+
+bool decay_stats_enabled(void)
+{
+    return atomic_load_explicit(&decay_stats_on, memory_order_relaxed);
+}
+
+void decay_stats_reset(void)
+{
+    atomic_store(&decay_stats_runs, 0);
+    atomic_store(&decay_stats_steps, 0);
+    atomic_store(&decay_stats_rejected_steps, 0);
+    atomic_store(&decay_stats_density_evaluations, 0);
+    atomic_store(&decay_stats_exp_calls, 0);
+    atomic_store(&decay_stats_pow_calls, 0);
+    atomic_store(&decay_stats_solves, 0);
+    atomic_store(&decay_stats_solver_iterations, 0);
+    atomic_store(&decay_stats_solver_failures, 0);
+    atomic_store(&decay_stats_physics_ns, 0);
+    atomic_store(&decay_stats_io_ns, 0);
+}
+
+void decay_stats_get(decay_stats_t *stats)
+{
+    stats->runs = atomic_load(&decay_stats_runs);
+    stats->steps = atomic_load(&decay_stats_steps);
+    stats->rejected_steps = atomic_load(&decay_stats_rejected_steps);
+    stats->density_evaluations = atomic_load(&decay_stats_density_evaluations);
+    stats->exp_calls = atomic_load(&decay_stats_exp_calls);
+    stats->pow_calls = atomic_load(&decay_stats_pow_calls);
+    stats->solves = atomic_load(&decay_stats_solves);
+    stats->solver_iterations = atomic_load(&decay_stats_solver_iterations);
+    stats->solver_failures = atomic_load(&decay_stats_solver_failures);
+    stats->physics_time = atomic_load(&decay_stats_physics_ns) * 1e-9;
+    stats->io_time = atomic_load(&decay_stats_io_ns) * 1e-9;
+    stats->peak_memory = 0;
+
+#ifndef DECAY_STATS_NO_RUSAGE
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        stats->peak_memory = usage.ru_maxrss; // KiB on Linux.
+    }
+#endif
+}
+
+void decay_stats_add(const decay_stats_t *delta)
+{
+    if (!decay_stats_enabled())
+    {
+        return;
+    }
+
+    atomic_fetch_add_explicit(&decay_stats_runs, delta->runs, memory_order_relaxed);
+    atomic_fetch_add_explicit(&decay_stats_steps, delta->steps, memory_order_relaxed);
+    atomic_fetch_add_explicit(&decay_stats_rejected_steps, delta->rejected_steps, memory_order_relaxed);
+    atomic_fetch_add_explicit(&decay_stats_density_evaluations, delta->density_evaluations, memory_order_relaxed);
+    atomic_fetch_add_explicit(&decay_stats_exp_calls, delta->exp_calls, memory_order_relaxed);
+    atomic_fetch_add_explicit(&decay_stats_pow_calls, delta->pow_calls, memory_order_relaxed);
+    atomic_fetch_add_explicit(&decay_stats_solves, delta->solves, memory_order_relaxed);
+    atomic_fetch_add_explicit(&decay_stats_solver_iterations, delta->solver_iterations, memory_order_relaxed);
+    atomic_fetch_add_explicit(&decay_stats_solver_failures, delta->solver_failures, memory_order_relaxed);
+    atomic_fetch_add_explicit(&decay_stats_physics_ns, delta->physics_time > 0 ? (uint64_t)(delta->physics_time * 1e9) : 0, memory_order_relaxed);
+    atomic_fetch_add_explicit(&decay_stats_io_ns, delta->io_time > 0 ? (uint64_t)(delta->io_time * 1e9) : 0, memory_order_relaxed);
+}
+
+double decay_stats_clock(void)
+{
+    if (!decay_stats_enabled())
+    {
+        return 0;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void decay_stats_print(FILE *stream)
+{
+    decay_stats_t stats;
+    decay_stats_get(&stats);
+
+    double total_time = stats.physics_time + stats.io_time;
+
+    fprintf(stream, "Runs:                %" PRIu64 "\n", stats.runs);
+    fprintf(stream, "Steps:               %" PRIu64 " (%" PRIu64 " rejected, %.1f per run)\n", stats.steps, stats.rejected_steps, stats.runs > 0 ? (double)stats.steps / stats.runs : 0);
+    fprintf(stream, "Density evaluations: %" PRIu64 "\n", stats.density_evaluations);
+    fprintf(stream, "exp calls:           %" PRIu64 "\n", stats.exp_calls);
+    fprintf(stream, "pow calls:           %" PRIu64 "\n", stats.pow_calls);
+    fprintf(stream, "Solves:              %" PRIu64 " (%" PRIu64 " iterations, %" PRIu64 " failed)\n", stats.solves, stats.solver_iterations, stats.solver_failures);
+    fprintf(stream, "Physics time:        %.3f s\n", stats.physics_time);
+    fprintf(stream, "I/O time:            %.3f s (%.1f%%)\n", stats.io_time, total_time > 0 ? 100 * stats.io_time / total_time : 0);
+    fprintf(stream, "Peak memory:         %ld KiB\n", stats.peak_memory);
+}
@@ -0,0 +1,309 @@
+/**
+ * @file decay_table.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Precomputed lifetime tables.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <meb_print.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "decay_file.h"
+#include "decay_table.h"
+
+struct decay_table
+{
+    const decay_table_header_t *header;
+    const double *data;
+    decay_file_t file;
+};
+
+static size_t decay_table_cells(const decay_table_header_t *header)
+{
+    size_t cells = 1;
+    for (int axis = 0; axis < DECAY_TABLE_AXES; axis++)
+    {
+        cells *= header->count[axis];
+    }
+    return cells;
+}
+
+// Whether a header describes a grid that interpolation can use and that fits in size bytes of file.
+static bool decay_table_grid_valid(const decay_table_header_t *header, size_t size)
+{
+    size_t capacity = (size - header->header_size) / sizeof(double);
+    size_t cells = 1;
+    for (int axis = 0; axis < DECAY_TABLE_AXES; axis++)
+    {
+        // Every cell needs two points per axis; the product is checked as it grows so that it cannot wrap.
+        if (header->count[axis] < 2 || !(header->last[axis] > header->first[axis]) || cells > capacity / header->count[axis])
+        {
+            return false;
+        }
+        cells *= header->count[axis];
+    }
+    return true;
+}
+
+// Grid coordinates of a query: the table's axes are altitude, ln(area / mass), F10.7, and Ap.
+static void decay_table_coordinates(double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, double x[DECAY_TABLE_AXES])
+{
+    x[DECAY_TABLE_ALTITUDE] = altitude;
+    x[DECAY_TABLE_AREA_MASS] = log(satellite_area / satellite_mass);
+    x[DECAY_TABLE_SRF] = solar_radio_flux;
+    x[DECAY_TABLE_GEO] = geomagnetic_a_index;
+}
+
+// Multilinear interpolation of the log-lifetime over the 16 corners of the cell holding x.
+static int decay_table_interpolate(const decay_table_header_t *header, const double *data, const double x[DECAY_TABLE_AXES], double *log_lifetime)
+{
+    size_t index[DECAY_TABLE_AXES];
+    size_t stride[DECAY_TABLE_AXES];
+    double fraction[DECAY_TABLE_AXES];
+
+    size_t step = 1;
+    for (int axis = DECAY_TABLE_AXES - 1; axis >= 0; axis--)
+    {
+        stride[axis] = step;
+        step *= header->count[axis];
+
+        double spacing = (header->last[axis] - header->first[axis]) / (header->count[axis] - 1);
+        double position = (x[axis] - header->first[axis]) / spacing;
+        if (!(position >= 0 && position <= header->count[axis] - 1))
+        {
+            return -1;
+        }
+
+        index[axis] = position >= header->count[axis] - 1 ? header->count[axis] - 2 : (size_t)position;
+        fraction[axis] = position - index[axis];
+    }
+
+    size_t base = 0;
+    for (int axis = 0; axis < DECAY_TABLE_AXES; axis++)
+    {
+        base += index[axis] * stride[axis];
+    }
+
+    double sum = 0;
+    for (int corner = 0; corner < (1 << DECAY_TABLE_AXES); corner++)
+    {
+        double weight = 1;
+        size_t offset = base;
+        for (int axis = 0; axis < DECAY_TABLE_AXES; axis++)
+        {
+            if (corner & (1 << axis))
+            {
+                weight *= fraction[axis];
+                offset += stride[axis];
+            }
+            else
+            {
+                weight *= 1 - fraction[axis];
+            }
+        }
+        sum += weight * data[offset];
+    }
+
+    *log_lifetime = sum;
+    return 0;
+}
+
+// Log-lifetime at a point of the parameter space; mass is fixed at 1 kg since only the ratio matters.
+static double decay_table_evaluate(decay_engine_t engine, const double x[DECAY_TABLE_AXES])
+{
+    double lifetime = decay_calculate_lifetime(engine, 1, exp(x[DECAY_TABLE_AREA_MASS]), x[DECAY_TABLE_ALTITUDE], x[DECAY_TABLE_SRF], x[DECAY_TABLE_GEO], ADAPTIVE_TOLERANCE, INFINITY);
+    return log(lifetime);
+}
+
+int decay_table_generate(const char *path, const uint32_t count[DECAY_TABLE_AXES], const double first[DECAY_TABLE_AXES], const double last[DECAY_TABLE_AXES], decay_engine_t engine)
+{
+    decay_table_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DECAY_TABLE_MAGIC, sizeof(header.magic));
+    header.version = DECAY_TABLE_VERSION;
+    header.header_size = sizeof(header);
+    header.byte_order = DECAY_TABLE_BYTE_ORDER;
+    header.engine = engine;
+
+    for (int axis = 0; axis < DECAY_TABLE_AXES; axis++)
+    {
+        if (count[axis] < 2 || !(last[axis] > first[axis]))
+        {
+            dbprintlf(RED_FG "Axis %d needs at least two increasing grid points.", axis);
+            return -1;
+        }
+        header.count[axis] = count[axis];
+        header.first[axis] = first[axis];
+        header.last[axis] = last[axis];
+    }
+
+    // The table is filled under the exponential model, whose density is undefined from its ceiling up.
+    if (first[DECAY_TABLE_ALTITUDE] * 1000 <= KARMAN_LINE || !(last[DECAY_TABLE_ALTITUDE] < DECAY_ATMOSPHERE_EXPONENTIAL_CEILING))
+    {
+        dbprintlf(RED_FG "Grid altitudes must lie above the Karman Line and below %.0f km.", DECAY_ATMOSPHERE_EXPONENTIAL_CEILING);
+        return -1;
+    }
+
+    size_t cells = decay_table_cells(&header);
+    double *data = malloc(cells * sizeof(double));
+    if (data == NULL)
+    {
+        dbprintlf(RED_FG "Failed to allocate %zu grid points.", cells);
+        return -1;
+    }
+
+    // Fill every grid point.
+    for (size_t cell = 0; cell < cells; cell++)
+    {
+        double x[DECAY_TABLE_AXES];
+        size_t remainder = cell;
+        for (int axis = DECAY_TABLE_AXES - 1; axis >= 0; axis--)
+        {
+            size_t i = remainder % count[axis];
+            remainder /= count[axis];
+            x[axis] = first[axis] + i * (last[axis] - first[axis]) / (count[axis] - 1);
+        }
+        data[cell] = decay_table_evaluate(engine, x);
+
+        // A run that failed would store log(-1) and spread NaN through the interpolation and the error measurement.
+        if (!isfinite(data[cell]))
+        {
+            dbprintlf(RED_FG "No lifetime at %g km, %g m^2/kg, F10.7 %g, Ap %g.", x[DECAY_TABLE_ALTITUDE], exp(x[DECAY_TABLE_AREA_MASS]), x[DECAY_TABLE_SRF], x[DECAY_TABLE_GEO]);
+            free(data);
+            return -1;
+        }
+    }
+
+    // Measure the interpolation error at every cell center, where multilinear interpolation is least accurate.
+    size_t centers = 1;
+    for (int axis = 0; axis < DECAY_TABLE_AXES; axis++)
+    {
+        centers *= count[axis] - 1;
+    }
+
+    double sum_squares = 0;
+    for (size_t center = 0; center < centers; center++)
+    {
+        double x[DECAY_TABLE_AXES];
+        size_t remainder = center;
+        for (int axis = DECAY_TABLE_AXES - 1; axis >= 0; axis--)
+        {
+            size_t i = remainder % (count[axis] - 1);
+            remainder /= count[axis] - 1;
+            x[axis] = first[axis] + (i + 0.5) * (last[axis] - first[axis]) / (count[axis] - 1);
+        }
+
+        double interpolated = 0;
+        decay_table_interpolate(&header, data, x, &interpolated);
+        double error = fabs(expm1(interpolated - decay_table_evaluate(engine, x)));
+
+        sum_squares += error * error;
+        if (error > header.max_error)
+        {
+            header.max_error = error;
+        }
+    }
+    header.rms_error = sqrt(sum_squares / centers);
+
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        erprintlf(errno);
+        free(data);
+        return -1;
+    }
+
+    int retval = 0;
+    if (fwrite(&header, sizeof(header), 1, fp) != 1 || fwrite(data, sizeof(double), cells, fp) != cells)
+    {
+        erprintlf(errno);
+        retval = -1;
+    }
+
+    if (fclose(fp) != 0)
+    {
+        retval = -1;
+    }
+    free(data);
+
+    return retval;
+}
+
+decay_table_t *decay_table_open(const char *path)
+{
+    decay_file_t file;
+    if (decay_file_map(path, false, &file) < 0)
+    {
+        return NULL;
+    }
+
+    const decay_table_header_t *header = file.data;
+    size_t size = file.size;
+    if (size < sizeof(decay_table_header_t) ||
+        memcmp(header->magic, DECAY_TABLE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != DECAY_TABLE_VERSION ||
+        header->byte_order != DECAY_TABLE_BYTE_ORDER ||
+        header->header_size != sizeof(decay_table_header_t) ||
+        !decay_table_grid_valid(header, size))
+    {
+        dbprintlf(RED_FG "%s is not a version %d lifetime table for this host.", path, DECAY_TABLE_VERSION);
+        decay_file_release(&file);
+        return NULL;
+    }
+
+    decay_table_t *table = malloc(sizeof(decay_table_t));
+    if (table == NULL)
+    {
+        decay_file_release(&file);
+        return NULL;
+    }
+
+    table->header = header;
+    table->data = (const double *)((const char *)file.data + header->header_size);
+    table->file = file;
+
+    return table;
+}
+
+void decay_table_close(decay_table_t *table)
+{
+    if (table == NULL)
+    {
+        return;
+    }
+
+    decay_file_release(&table->file);
+    free(table);
+}
+
+const decay_table_header_t *decay_table_header(const decay_table_t *table)
+{
+    return table->header;
+}
+
+int decay_table_lookup(const decay_table_t *table, double satellite_mass, double satellite_area, double altitude, double solar_radio_flux, double geomagnetic_a_index, double *lifetime)
+{
+    double x[DECAY_TABLE_AXES];
+    double log_lifetime = 0;
+
+    decay_table_coordinates(satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index, x);
+    if (decay_table_interpolate(table->header, table->data, x, &log_lifetime) < 0)
+    {
+        return -1;
+    }
+
+    *lifetime = exp(log_lifetime);
+    if (*lifetime >= LIFETIME_LIMIT)
+    {
+        *lifetime = -1;
+    }
+
+    return 0;
+}
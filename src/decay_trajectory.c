@@ -0,0 +1,290 @@
+/**
+ * @file decay_trajectory.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Buffered, decimated trajectory output.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <meb_print.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "decay_file.h"
+#include "decay_stats.h"
+#include "decay_trajectory.h"
+
+#define TRAJECTORY_STREAM_BUFFER (1 << 20) // Bytes of stdio buffering per file.
+
+/**
+ * @brief A file being written.
+ *
+ * Binary files are written columnar while the row count is still unknown: full blocks of times go straight to the file after a placeholder header, while full blocks of altitudes and periods are spilled to temporary files that are appended when the writer finishes.
+ *
+ */
+struct decay_trajectory_writer
+{
+    FILE *file;
+    FILE *spill[2]; // Altitudes and periods of the blocks written so far (binary only).
+    decay_trajectory_format_t format;
+    decay_trajectory_header_t header;
+    double *column[3]; // Times, altitudes, and periods of the current block.
+    int rows;          // Rows in the current block.
+    bool failed;
+};
+
+struct decay_trajectory
+{
+    const decay_trajectory_header_t *header;
+    const double *column[3];
+    decay_file_t file;
+};
+
+decay_trajectory_writer_t *decay_trajectory_create(const char *path, decay_trajectory_format_t format, double interval)
+{
+    decay_trajectory_writer_t *writer = calloc(1, sizeof(decay_trajectory_writer_t));
+    if (writer == NULL)
+    {
+        return NULL;
+    }
+
+    writer->format = format;
+    memcpy(writer->header.magic, DECAY_TRAJECTORY_MAGIC, sizeof(writer->header.magic));
+    writer->header.version = DECAY_TRAJECTORY_VERSION;
+    writer->header.header_size = sizeof(decay_trajectory_header_t);
+    writer->header.byte_order = DECAY_TRAJECTORY_BYTE_ORDER;
+    writer->header.interval = interval;
+
+    writer->file = fopen(path, format == DECAY_TRAJECTORY_BINARY ? "wb" : "w");
+    if (writer->file == NULL)
+    {
+        erprintlf(errno);
+        free(writer);
+        return NULL;
+    }
+    setvbuf(writer->file, NULL, _IOFBF, TRAJECTORY_STREAM_BUFFER);
+
+    if (format == DECAY_TRAJECTORY_BINARY)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            writer->column[i] = malloc(DECAY_TRAJECTORY_BLOCK * sizeof(double));
+            writer->failed |= writer->column[i] == NULL;
+        }
+        // Placeholder, rewritten with the row count by decay_trajectory_finish(...).
+        writer->failed |= fwrite(&writer->header, sizeof(decay_trajectory_header_t), 1, writer->file) != 1;
+    }
+    else
+    {
+        writer->failed |= fprintf(writer->file, "TIME (s), HEIGHT (km), PERIOD (s)\n") < 0;
+    }
+
+    if (writer->failed)
+    {
+        dbprintlf(RED_FG "Failed to start %s.", path);
+        decay_trajectory_finish(writer);
+        return NULL;
+    }
+
+    return writer;
+}
+
+// Writes the current block: times to the file, altitudes and periods to the spill files. The block is emptied even on failure, which the writer latches.
+static void decay_trajectory_spill(decay_trajectory_writer_t *writer)
+{
+    size_t rows = writer->rows;
+    writer->rows = 0;
+
+    for (int i = 0; i < 2 && writer->spill[i] == NULL; i++)
+    {
+        writer->spill[i] = tmpfile();
+        if (writer->spill[i] == NULL)
+        {
+            erprintlf(errno);
+            writer->failed = true;
+            return;
+        }
+        setvbuf(writer->spill[i], NULL, _IOFBF, TRAJECTORY_STREAM_BUFFER);
+    }
+
+    writer->failed |= fwrite(writer->column[0], sizeof(double), rows, writer->file) != rows;
+    writer->failed |= fwrite(writer->column[1], sizeof(double), rows, writer->spill[0]) != rows;
+    writer->failed |= fwrite(writer->column[2], sizeof(double), rows, writer->spill[1]) != rows;
+}
+
+int decay_trajectory_write(decay_trajectory_writer_t *writer, double elapsed_time, double altitude, double orbital_period)
+{
+    // Once a write has failed the file is incomplete, so no further rows are taken.
+    if (writer->failed)
+    {
+        return -1;
+    }
+
+    if (writer->format == DECAY_TRAJECTORY_CSV)
+    {
+        writer->failed |= fprintf(writer->file, "%.3f, %f, %f\n", elapsed_time, altitude, orbital_period) < 0;
+        writer->header.count++;
+        return writer->failed ? -1 : 0;
+    }
+
+    writer->column[0][writer->rows] = elapsed_time;
+    writer->column[1][writer->rows] = altitude;
+    writer->column[2][writer->rows] = orbital_period;
+    writer->header.count++;
+
+    if (++writer->rows == DECAY_TRAJECTORY_BLOCK)
+    {
+        decay_trajectory_spill(writer);
+    }
+
+    return writer->failed ? -1 : 0;
+}
+
+int decay_trajectory_sample(double elapsed_time, double altitude, double orbital_period, void *writer)
+{
+    return decay_trajectory_write(writer, elapsed_time, altitude, orbital_period) < 0;
+}
+
+// Appends a spill file to the output.
+static bool decay_trajectory_append(FILE *file, FILE *spill, double *block)
+{
+    rewind(spill);
+
+    size_t rows;
+    while ((rows = fread(block, sizeof(double), DECAY_TRAJECTORY_BLOCK, spill)) > 0)
+    {
+        if (fwrite(block, sizeof(double), rows, file) != rows)
+        {
+            return false;
+        }
+    }
+
+    return !ferror(spill);
+}
+
+int decay_trajectory_finish(decay_trajectory_writer_t *writer)
+{
+    if (writer == NULL)
+    {
+        return 0;
+    }
+
+    double start = decay_stats_clock();
+
+    if (writer->format == DECAY_TRAJECTORY_BINARY && writer->file != NULL && !writer->failed)
+    {
+        if (writer->spill[0] == NULL)
+        {
+            // Every row fits in one block, so the columns are written directly.
+            size_t rows = writer->rows;
+            for (int i = 0; i < 3; i++)
+            {
+                writer->failed |= fwrite(writer->column[i], sizeof(double), rows, writer->file) != rows;
+            }
+        }
+        else
+        {
+            if (writer->rows > 0)
+            {
+                decay_trajectory_spill(writer);
+            }
+            for (int i = 0; i < 2 && !writer->failed; i++)
+            {
+                writer->failed |= !decay_trajectory_append(writer->file, writer->spill[i], writer->column[0]);
+            }
+        }
+
+        writer->failed |= fseek(writer->file, 0, SEEK_SET) != 0;
+        writer->failed |= fwrite(&writer->header, sizeof(decay_trajectory_header_t), 1, writer->file) != 1;
+    }
+
+    if (writer->file != NULL && fclose(writer->file) != 0)
+    {
+        writer->failed = true;
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        if (writer->spill[i] != NULL)
+        {
+            fclose(writer->spill[i]);
+        }
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        free(writer->column[i]);
+    }
+
+    decay_stats_t stats = {0};
+    stats.io_time = decay_stats_clock() - start;
+    decay_stats_add(&stats);
+
+    int retval = writer->failed ? -1 : 0;
+    free(writer);
+    return retval;
+}
+
+decay_trajectory_t *decay_trajectory_open(const char *path)
+{
+    decay_file_t file;
+    if (decay_file_map(path, false, &file) < 0)
+    {
+        return NULL;
+    }
+
+    const decay_trajectory_header_t *header = file.data;
+    size_t size = file.size;
+    if (size < sizeof(decay_trajectory_header_t) ||
+        memcmp(header->magic, DECAY_TRAJECTORY_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != DECAY_TRAJECTORY_VERSION ||
+        header->byte_order != DECAY_TRAJECTORY_BYTE_ORDER ||
+        header->header_size != sizeof(decay_trajectory_header_t) ||
+        (size - header->header_size) / (3 * sizeof(double)) < header->count)
+    {
+        dbprintlf(RED_FG "%s is not a version %d binary trajectory for this host.", path, DECAY_TRAJECTORY_VERSION);
+        decay_file_release(&file);
+        return NULL;
+    }
+
+    decay_trajectory_t *trajectory = malloc(sizeof(decay_trajectory_t));
+    if (trajectory == NULL)
+    {
+        decay_file_release(&file);
+        return NULL;
+    }
+
+    trajectory->header = header;
+    trajectory->column[0] = (const double *)((const char *)file.data + header->header_size);
+    trajectory->column[1] = trajectory->column[0] + header->count;
+    trajectory->column[2] = trajectory->column[1] + header->count;
+    trajectory->file = file;
+
+    return trajectory;
+}
+
+void decay_trajectory_close(decay_trajectory_t *trajectory)
+{
+    if (trajectory == NULL)
+    {
+        return;
+    }
+
+    decay_file_release(&trajectory->file);
+    free(trajectory);
+}
+
+const decay_trajectory_header_t *decay_trajectory_header(const decay_trajectory_t *trajectory)
+{
+    return trajectory->header;
+}
+
+void decay_trajectory_columns(const decay_trajectory_t *trajectory, const double **elapsed_time, const double **altitude, const double **orbital_period)
+{
+    if (elapsed_time != NULL) {*elapsed_time = trajectory->column[0];}
+    if (altitude != NULL) {*altitude = trajectory->column[1];}
+    if (orbital_period != NULL) {*orbital_period = trajectory->column[2];}
+}
@@ -0,0 +1,374 @@
+/**
+ * @file decay_weather.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Time-varying space weather from an F10.7 and Ap history.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <meb_print.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "decay_digest.h"
+#include "decay_file.h"
+#include "decay_weather.h"
+
+#define WEATHER_SPACING_TOLERANCE 1e-3 // Fraction of the interval by which a CSV sample may stray from the even grid.
+
+struct decay_weather
+{
+    const decay_weather_header_t *header;
+    const double *sh_numerator;
+    const double *solar_radio_flux;
+    const double *geomagnetic_a_index;
+    uint64_t *digest; // Digest of the grid and of the scale height numerators up to each sample.
+    decay_file_t file; // Mapping of a binary file, or allocation holding the same layout for a CSV file.
+};
+
+// Points the arrays into a block laid out as the binary format, and computes the digests.
+static decay_weather_t *decay_weather_wrap(const decay_file_t *file)
+{
+    decay_weather_t *weather = malloc(sizeof(decay_weather_t));
+    if (weather == NULL)
+    {
+        return NULL;
+    }
+
+    weather->header = file->data;
+    weather->sh_numerator = (const double *)((const char *)file->data + weather->header->header_size);
+    weather->solar_radio_flux = weather->sh_numerator + weather->header->count;
+    weather->geomagnetic_a_index = weather->solar_radio_flux + weather->header->count;
+    weather->file = *file;
+
+    weather->digest = malloc(weather->header->count * sizeof(uint64_t));
+    if (weather->digest == NULL)
+    {
+        free(weather);
+        return NULL;
+    }
+
+    double grid[] = {weather->header->start, weather->header->interval};
+    uint64_t digest = decay_digest_mix(DECAY_DIGEST_BASIS, grid, sizeof(grid));
+    for (uint32_t i = 0; i < weather->header->count; i++)
+    {
+        digest = decay_digest_mix(digest, &weather->sh_numerator[i], sizeof(double));
+        weather->digest[i] = digest;
+    }
+
+    return weather;
+}
+
+// Parses the TIME field of a CSV line into days, advancing *cursor past it.
+static int decay_weather_parse_time(const char **cursor, bool *is_date, double *days)
+{
+    const char *p = *cursor;
+
+    if (isdigit((unsigned char)p[0]) && isdigit((unsigned char)p[1]) && isdigit((unsigned char)p[2]) && isdigit((unsigned char)p[3]) && p[4] == '-')
+    {
+        int year = 0, month = 0, day = 0, hour = 0, minute = 0, consumed = 0;
+        if (sscanf(p, "%4d-%2d-%2d%n", &year, &month, &day, &consumed) != 3 || month < 1 || month > 12 || day < 1 || day > 31)
+        {
+            return -1;
+        }
+        p += consumed;
+
+        if ((*p == 'T' || *p == ' ') && sscanf(p + 1, "%2d:%2d%n", &hour, &minute, &consumed) == 2)
+        {
+            p += 1 + consumed;
+        }
+
+        *is_date = true;
+        *days = decay_file_days_from_civil(year, month, day) + (hour * 60 + minute) / 1440.0;
+    }
+    else
+    {
+        char *end = NULL;
+        *days = strtod(p, &end);
+        if (end == p)
+        {
+            return -1;
+        }
+        p = end;
+        *is_date = false;
+    }
+
+    *cursor = p;
+    return 0;
+}
+
+// Reads the next comma- or whitespace-separated number.
+static int decay_weather_parse_field(const char **cursor, double *value)
+{
+    const char *p = *cursor;
+    while (*p == ',' || *p == ' ' || *p == '\t')
+    {
+        p++;
+    }
+
+    char *end = NULL;
+    *value = strtod(p, &end);
+    if (end == p)
+    {
+        return -1;
+    }
+
+    *cursor = end;
+    return 0;
+}
+
+static decay_weather_t *decay_weather_parse_csv(const char *path, char *text)
+{
+    size_t capacity = 1024, count = 0;
+    double *times = malloc(capacity * sizeof(double));
+    double *values = malloc(2 * capacity * sizeof(double));
+    decay_weather_t *weather = NULL;
+    bool dates = false;
+    int line = 0;
+
+    for (char *cursor = text; cursor != NULL && *cursor != '\0' && times != NULL && values != NULL; line++)
+    {
+        char *next = strchr(cursor, '\n');
+        if (next != NULL)
+        {
+            *next++ = '\0';
+        }
+
+        const char *p = cursor;
+        cursor = next;
+        while (*p == ' ' || *p == '\t')
+        {
+            p++;
+        }
+        if (!(isdigit((unsigned char)*p) || *p == '-' || *p == '+' || *p == '.'))
+        {
+            continue;
+        }
+
+        if (count == capacity)
+        {
+            capacity *= 2;
+            double *grown_times = realloc(times, capacity * sizeof(double));
+            times = grown_times != NULL ? grown_times : times;
+            double *grown_values = realloc(values, 2 * capacity * sizeof(double));
+            values = grown_values != NULL ? grown_values : values;
+            if (grown_times == NULL || grown_values == NULL)
+            {
+                dbprintlf(RED_FG "Failed to allocate %zu samples.", capacity);
+                goto cleanup;
+            }
+        }
+
+        bool is_date = false;
+        if (decay_weather_parse_time(&p, &is_date, &times[count]) < 0 ||
+            decay_weather_parse_field(&p, &values[2 * count]) < 0 ||
+            decay_weather_parse_field(&p, &values[2 * count + 1]) < 0 ||
+            (count > 0 && is_date != dates))
+        {
+            dbprintlf(RED_FG "%s:%d: expected TIME, F10.7, AP.", path, line + 1);
+            goto cleanup;
+        }
+        dates = is_date;
+        count++;
+    }
+
+    if (times == NULL || values == NULL || count == 0)
+    {
+        dbprintlf(RED_FG "%s holds no samples.", path);
+        goto cleanup;
+    }
+
+    // Dates are relative to the first sample; plain numbers are already relative to the start of the propagation.
+    double first = dates ? times[0] : 0;
+    double interval = count > 1 ? times[1] - times[0] : 1;
+    if (!(interval > 0))
+    {
+        dbprintlf(RED_FG "%s: samples must be in increasing order of time.", path);
+        goto cleanup;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (fabs(times[i] - (times[0] + i * interval)) > WEATHER_SPACING_TOLERANCE * interval)
+        {
+            dbprintlf(RED_FG "%s: sample %zu breaks the spacing of %g days.", path, i + 1, interval);
+            goto cleanup;
+        }
+    }
+
+    size_t size = sizeof(decay_weather_header_t) + 3 * count * sizeof(double);
+    char *block = calloc(1, size);
+    if (block == NULL)
+    {
+        goto cleanup;
+    }
+
+    decay_weather_header_t *header = (decay_weather_header_t *)block;
+    memcpy(header->magic, DECAY_WEATHER_MAGIC, sizeof(header->magic));
+    header->version = DECAY_WEATHER_VERSION;
+    header->header_size = sizeof(decay_weather_header_t);
+    header->byte_order = DECAY_WEATHER_BYTE_ORDER;
+    header->count = count;
+    header->start = (times[0] - first) * 86400;
+    header->interval = interval * 86400;
+
+    double *sh_numerator = (double *)(block + sizeof(decay_weather_header_t));
+    double *solar_radio_flux = sh_numerator + count;
+    double *geomagnetic_a_index = solar_radio_flux + count;
+    for (size_t i = 0; i < count; i++)
+    {
+        solar_radio_flux[i] = values[2 * i];
+        geomagnetic_a_index[i] = values[2 * i + 1];
+        sh_numerator[i] = 900 + 2.5 * (solar_radio_flux[i] - 70) + 1.5 * geomagnetic_a_index[i];
+    }
+
+    decay_file_t file = {.data = block, .size = size, .mapped = false};
+    weather = decay_weather_wrap(&file);
+    if (weather == NULL)
+    {
+        free(block);
+    }
+
+cleanup:
+    free(times);
+    free(values);
+    return weather;
+}
+
+decay_weather_t *decay_weather_open(const char *path)
+{
+    decay_file_t file;
+    if (decay_file_map(path, false, &file) < 0)
+    {
+        return NULL;
+    }
+
+    if (file.size < sizeof(DECAY_WEATHER_MAGIC) - 1 || memcmp(file.data, DECAY_WEATHER_MAGIC, sizeof(DECAY_WEATHER_MAGIC) - 1) != 0)
+    {
+        // CSV text is parsed from a NUL-terminated copy.
+        char *text = malloc(file.size + 1);
+        decay_weather_t *weather = NULL;
+        if (text == NULL)
+        {
+            dbprintlf(RED_FG "Failed to load %s.", path);
+        }
+        else
+        {
+            memcpy(text, file.data, file.size);
+            text[file.size] = '\0';
+            weather = decay_weather_parse_csv(path, text);
+        }
+        free(text);
+        decay_file_release(&file);
+        return weather;
+    }
+
+    const decay_weather_header_t *header = file.data;
+    if (file.size < sizeof(decay_weather_header_t) ||
+        header->version != DECAY_WEATHER_VERSION ||
+        header->byte_order != DECAY_WEATHER_BYTE_ORDER ||
+        header->header_size != sizeof(decay_weather_header_t) ||
+        header->count == 0 || !(header->interval > 0) ||
+        file.size < header->header_size + 3 * (size_t)header->count * sizeof(double))
+    {
+        dbprintlf(RED_FG "%s is not a version %d space weather history for this host.", path, DECAY_WEATHER_VERSION);
+        decay_file_release(&file);
+        return NULL;
+    }
+
+    decay_weather_t *weather = decay_weather_wrap(&file);
+    if (weather == NULL)
+    {
+        decay_file_release(&file);
+    }
+    return weather;
+}
+
+int decay_weather_save(const decay_weather_t *weather, const char *path)
+{
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        erprintlf(errno);
+        return -1;
+    }
+
+    size_t count = weather->header->count;
+    int retval = 0;
+    if (fwrite(weather->header, sizeof(decay_weather_header_t), 1, fp) != 1 ||
+        fwrite(weather->sh_numerator, sizeof(double), count, fp) != count ||
+        fwrite(weather->solar_radio_flux, sizeof(double), count, fp) != count ||
+        fwrite(weather->geomagnetic_a_index, sizeof(double), count, fp) != count)
+    {
+        erprintlf(errno);
+        retval = -1;
+    }
+
+    if (fclose(fp) != 0)
+    {
+        retval = -1;
+    }
+
+    return retval;
+}
+
+void decay_weather_close(decay_weather_t *weather)
+{
+    if (weather == NULL)
+    {
+        return;
+    }
+
+    decay_file_release(&weather->file);
+    free(weather->digest);
+    free(weather);
+}
+
+const decay_weather_header_t *decay_weather_header(const decay_weather_t *weather)
+{
+    return weather->header;
+}
+
+// Position of a time on the sample grid, snapped to a sample boundary when within rounding error of one.
+static double decay_weather_position(const decay_weather_t *weather, double time)
+{
+    double position = (time - weather->header->start) / weather->header->interval;
+    double boundary = nearbyint(position);
+    return fabs(position - boundary) < 1e-9 * (1 + fabs(boundary)) ? boundary : position;
+}
+
+// Sample in effect at a time.
+static uint32_t decay_weather_index(const decay_weather_t *weather, double time)
+{
+    double position = decay_weather_position(weather, time);
+    uint32_t last = weather->header->count - 1;
+
+    return position <= 0 ? 0 : position >= last ? last : (uint32_t)position;
+}
+
+double decay_weather_sh_numerator(const decay_weather_t *weather, double time)
+{
+    return weather->sh_numerator[decay_weather_index(weather, time)];
+}
+
+double decay_weather_next_change(const decay_weather_t *weather, double time)
+{
+    double position = decay_weather_position(weather, time);
+    if (position >= weather->header->count - 1)
+    {
+        return INFINITY;
+    }
+
+    double index = position < 0 ? 0 : floor(position) + 1;
+    return weather->header->start + index * weather->header->interval;
+}
+
+uint64_t decay_weather_digest(const decay_weather_t *weather, double time)
+{
+    return weather->digest[decay_weather_index(weather, time)];
+}
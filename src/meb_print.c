@@ -0,0 +1,307 @@
+/**
+ * @file meb_print.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Asynchronous backend of the print macros, used when MEB_ASYNC is defined.
+ *
+ * Every thread that prints owns a single-producer ring buffer, so printing takes no lock: a message is formatted on the caller's stack and copied into the ring. A background thread drains every ring into stdio in large writes and flushes once per pass rather than once per line. Rings of exited threads are handed to the next new thread, so pools that start threads for every job do not accumulate them.
+ *
+ * A message that does not fit in the free space of its ring makes the caller drain the rings itself, which bounds memory and applies backpressure. Messages too large for any ring are written directly after a drain.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef MEB_ASYNC
+#define MEB_ASYNC
+#endif
+#include <meb_print.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MEB_LOG_RING_SIZE (1 << 16)  // Bytes per ring; a power of two.
+#define MEB_LOG_MAX_RINGS 256        // Threads that may print concurrently through rings; others write directly.
+#define MEB_LOG_MESSAGE 1024         // Messages up to this size are formatted on the stack.
+#define MEB_LOG_PERIOD_NS 2000000    // Nanoseconds the writer sleeps when every ring is empty.
+
+#define MEB_LOG_STDOUT 0
+#define MEB_LOG_STDERR 1
+#define MEB_LOG_PADDING 2 // Skips to the start of the ring.
+
+/**
+ * @brief Header of a message in a ring. The text follows, padded to a multiple of the header size.
+ *
+ */
+typedef struct
+{
+    uint32_t length;
+    uint32_t stream;
+} meb_log_record_t;
+
+typedef struct
+{
+    _Atomic size_t head; // Bytes written by the owner, ever.
+    _Atomic size_t tail; // Bytes drained by the writer, ever.
+    atomic_bool free;    // The owner has exited.
+    char data[MEB_LOG_RING_SIZE];
+} meb_log_ring_t;
+
+static meb_log_ring_t *meb_log_rings[MEB_LOG_MAX_RINGS];
+static atomic_int meb_log_ring_count;
+static atomic_int meb_log_level_mask = MEB_DBG_ALL;
+static atomic_bool meb_log_running;
+
+static pthread_once_t meb_log_once = PTHREAD_ONCE_INIT;
+static pthread_key_t meb_log_key;
+static pthread_t meb_log_writer;
+static pthread_mutex_t meb_log_drain_lock = PTHREAD_MUTEX_INITIALIZER; // Held by whoever drains, the only consumer of the rings.
+static bool meb_log_started;
+
+static __thread meb_log_ring_t *meb_log_ring;
+
+static inline size_t meb_log_align(size_t length)
+{
+    return (length + sizeof(meb_log_record_t) - 1) & ~(sizeof(meb_log_record_t) - 1);
+}
+
+// Writes out every complete message of every ring. Called with meb_log_drain_lock held.
+static bool meb_log_drain_locked(void)
+{
+    bool drained = false;
+    int count = atomic_load_explicit(&meb_log_ring_count, memory_order_acquire);
+
+    for (int i = 0; i < count; i++)
+    {
+        meb_log_ring_t *ring = meb_log_rings[i];
+        if (ring == NULL)
+        {
+            continue;
+        }
+
+        size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        while (tail != head)
+        {
+            meb_log_record_t *record = (meb_log_record_t *)&ring->data[tail & (MEB_LOG_RING_SIZE - 1)];
+            if (record->stream == MEB_LOG_PADDING)
+            {
+                tail += MEB_LOG_RING_SIZE - (tail & (MEB_LOG_RING_SIZE - 1));
+                continue;
+            }
+
+            fwrite(record + 1, 1, record->length, record->stream == MEB_LOG_STDERR ? stderr : stdout);
+            tail += sizeof(meb_log_record_t) + meb_log_align(record->length);
+            drained = true;
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+
+    if (drained)
+    {
+        fflush(stdout);
+        fflush(stderr);
+    }
+    return drained;
+}
+
+static void *meb_log_thread(void *unused)
+{
+    (void)unused;
+    struct timespec period = {0, MEB_LOG_PERIOD_NS};
+
+    while (atomic_load_explicit(&meb_log_running, memory_order_acquire))
+    {
+        pthread_mutex_lock(&meb_log_drain_lock);
+        bool drained = meb_log_drain_locked();
+        pthread_mutex_unlock(&meb_log_drain_lock);
+
+        if (!drained)
+        {
+            nanosleep(&period, NULL);
+        }
+    }
+
+    return NULL;
+}
+
+static void meb_log_stop(void)
+{
+    if (meb_log_started)
+    {
+        atomic_store_explicit(&meb_log_running, false, memory_order_release);
+        pthread_join(meb_log_writer, NULL);
+        meb_log_started = false;
+    }
+    meb_log_flush();
+}
+
+// Hands the ring of an exiting thread to the next new one.
+static void meb_log_release(void *ring)
+{
+    atomic_store_explicit(&((meb_log_ring_t *)ring)->free, true, memory_order_release);
+}
+
+static void meb_log_start(void)
+{
+    pthread_key_create(&meb_log_key, meb_log_release);
+
+    atomic_store(&meb_log_running, true);
+    meb_log_started = pthread_create(&meb_log_writer, NULL, meb_log_thread, NULL) == 0;
+    atomic_store(&meb_log_running, meb_log_started);
+
+    atexit(meb_log_stop);
+}
+
+// Ring of the calling thread, claimed on its first message; NULL once every ring is taken.
+static meb_log_ring_t *meb_log_claim(void)
+{
+    if (meb_log_ring != NULL)
+    {
+        return meb_log_ring;
+    }
+
+    pthread_once(&meb_log_once, meb_log_start);
+    if (!meb_log_started)
+    {
+        return NULL;
+    }
+
+    int count = atomic_load_explicit(&meb_log_ring_count, memory_order_acquire);
+    for (int i = 0; i < count && meb_log_ring == NULL; i++)
+    {
+        bool expected = true;
+        if (meb_log_rings[i] != NULL && atomic_compare_exchange_strong(&meb_log_rings[i]->free, &expected, false))
+        {
+            meb_log_ring = meb_log_rings[i];
+        }
+    }
+
+    if (meb_log_ring == NULL)
+    {
+        meb_log_ring_t *ring = calloc(1, sizeof(meb_log_ring_t));
+
+        // Slots are filled before the count is raised past them, so readers never see an unset slot below the count.
+        pthread_mutex_lock(&meb_log_drain_lock);
+        int index = atomic_load(&meb_log_ring_count);
+        if (ring != NULL && index < MEB_LOG_MAX_RINGS)
+        {
+            meb_log_rings[index] = ring;
+            atomic_store_explicit(&meb_log_ring_count, index + 1, memory_order_release);
+            meb_log_ring = ring;
+        }
+        pthread_mutex_unlock(&meb_log_drain_lock);
+
+        if (meb_log_ring == NULL)
+        {
+            free(ring);
+            return NULL;
+        }
+    }
+
+    pthread_setspecific(meb_log_key, meb_log_ring);
+    return meb_log_ring;
+}
+
+// Copies a message into the caller's ring. Returns false if it can never fit.
+static bool meb_log_push(meb_log_ring_t *ring, int stream, const char *text, size_t length)
+{
+    size_t size = sizeof(meb_log_record_t) + meb_log_align(length);
+    if (size > MEB_LOG_RING_SIZE / 4)
+    {
+        return false;
+    }
+
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t offset = head & (MEB_LOG_RING_SIZE - 1);
+    size_t padding = offset + size > MEB_LOG_RING_SIZE ? MEB_LOG_RING_SIZE - offset : 0;
+
+    while (head + padding + size - atomic_load_explicit(&ring->tail, memory_order_acquire) > MEB_LOG_RING_SIZE)
+    {
+        meb_log_flush();
+    }
+
+    if (padding > 0)
+    {
+        ((meb_log_record_t *)&ring->data[offset])->stream = MEB_LOG_PADDING;
+        head += padding;
+        offset = 0;
+    }
+
+    meb_log_record_t *record = (meb_log_record_t *)&ring->data[offset];
+    record->length = length;
+    record->stream = stream;
+    memcpy(record + 1, text, length);
+
+    atomic_store_explicit(&ring->head, head + size, memory_order_release);
+    return true;
+}
+
+int meb_log_printf(FILE *stream, const char *format, ...)
+{
+    char message[MEB_LOG_MESSAGE];
+    char *text = message;
+
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    if (length < 0)
+    {
+        return length;
+    }
+
+    if ((size_t)length >= sizeof(message))
+    {
+        text = malloc(length + 1);
+        if (text == NULL)
+        {
+            return -1;
+        }
+        va_start(args, format);
+        vsnprintf(text, length + 1, format, args);
+        va_end(args);
+    }
+
+    meb_log_ring_t *ring = (stream == stdout || stream == stderr) ? meb_log_claim() : NULL;
+    if (ring == NULL || !meb_log_push(ring, stream == stderr ? MEB_LOG_STDERR : MEB_LOG_STDOUT, text, length))
+    {
+        // Too large for a ring, or no ring to be had: drain first so that the thread's earlier messages stay ahead of this one.
+        pthread_mutex_lock(&meb_log_drain_lock);
+        meb_log_drain_locked();
+        fwrite(text, 1, length, stream);
+        fflush(stream);
+        pthread_mutex_unlock(&meb_log_drain_lock);
+    }
+
+    if (text != message)
+    {
+        free(text);
+    }
+    return length;
+}
+
+void meb_log_flush(void)
+{
+    pthread_mutex_lock(&meb_log_drain_lock);
+    meb_log_drain_locked();
+    fflush(stdout);
+    fflush(stderr);
+    pthread_mutex_unlock(&meb_log_drain_lock);
+}
+
+int meb_log_levels(void)
+{
+    return atomic_load_explicit(&meb_log_level_mask, memory_order_relaxed);
+}
+
+void meb_log_set_levels(int levels)
+{
+    atomic_store_explicit(&meb_log_level_mask, levels, memory_order_relaxed);
+}
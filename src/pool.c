@@ -0,0 +1,102 @@
+/**
+ * @file pool.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Minimal worker pool for independent jobs.
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <meb_print.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "pool.h"
+
+typedef struct
+{
+    int count;
+    pool_job_t job;
+    void *context;
+    atomic_int next; // Next unclaimed index.
+} pool_t;
+
+static void *pool_worker(void *arg)
+{
+    pool_t *pool = arg;
+
+    for (int index = atomic_fetch_add(&pool->next, 1); index < pool->count; index = atomic_fetch_add(&pool->next, 1))
+    {
+        pool->job(index, pool->context);
+    }
+
+    return NULL;
+}
+
+int pool_run(int count, int threads, pool_job_t job, void *context)
+{
+    pool_t pool = {.count = count, .job = job, .context = context};
+    atomic_init(&pool.next, 0);
+
+    if (threads < 1)
+    {
+        threads = pool_default_threads();
+    }
+    if (threads > count)
+    {
+        threads = count;
+    }
+
+    pthread_t *workers = threads > 1 ? malloc((threads - 1) * sizeof(pthread_t)) : NULL;
+    int started = 0;
+    while (workers != NULL && started < threads - 1)
+    {
+        int rc = pthread_create(&workers[started], NULL, pool_worker, &pool);
+        if (rc != 0)
+        {
+            erprintlf(rc);
+            break;
+        }
+        started++;
+    }
+
+    // The caller works too, so the jobs finish even if no worker could be started.
+    pool_worker(&pool);
+
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+
+    return threads > 1 && started == 0 ? -1 : 0;
+}
+
+// Orders by decreasing cost, then by index.
+static int pool_order_compare(const void *a, const void *b)
+{
+    const pool_order_t *x = a, *y = b;
+    if (x->cost != y->cost)
+    {
+        return (x->cost < y->cost) - (x->cost > y->cost);
+    }
+    return x->index - y->index;
+}
+
+void pool_order(pool_order_t *order, int count)
+{
+    qsort(order, count, sizeof(pool_order_t), pool_order_compare);
+}
+
+int pool_default_threads(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    return processors > 0 ? (int)processors : 1;
+#else
+    return 1;
+#endif
+}
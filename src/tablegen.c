@@ -0,0 +1,95 @@
+/**
+ * @file tablegen.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Generates the precomputed lifetime table used by decay_table_lookup(...).
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <meb_print.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "decay_table.h"
+
+int main(int argc, char *argv[])
+{
+    const char *path = "lifetime.dlt";
+    // Quadrature matches the fixed engine of decay_calculate_suppressed(...) far inside the interpolation error, which would need days to fill the default grid.
+    decay_engine_t engine = DECAY_ENGINE_QUADRATURE;
+
+    // Default grid: 150-1000 km by 5 km, 1e-3 to 1 m^2/kg by quarter decades, F10.7 60-300 by 10, Ap 0-100 by 5.
+    uint32_t count[DECAY_TABLE_AXES] = {171, 13, 25, 21};
+    double first[DECAY_TABLE_AXES] = {150, log(1e-3), 60, 0};
+    double last[DECAY_TABLE_AXES] = {1000, log(1), 300, 100};
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--engine") && i + 1 < argc)
+        {
+            engine = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--altitude") && i + 3 < argc)
+        {
+            first[DECAY_TABLE_ALTITUDE] = atof(argv[++i]);
+            last[DECAY_TABLE_ALTITUDE] = atof(argv[++i]);
+            count[DECAY_TABLE_ALTITUDE] = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--area-mass") && i + 3 < argc)
+        {
+            first[DECAY_TABLE_AREA_MASS] = log(atof(argv[++i]));
+            last[DECAY_TABLE_AREA_MASS] = log(atof(argv[++i]));
+            count[DECAY_TABLE_AREA_MASS] = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--srf") && i + 3 < argc)
+        {
+            first[DECAY_TABLE_SRF] = atof(argv[++i]);
+            last[DECAY_TABLE_SRF] = atof(argv[++i]);
+            count[DECAY_TABLE_SRF] = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--geo") && i + 3 < argc)
+        {
+            first[DECAY_TABLE_GEO] = atof(argv[++i]);
+            last[DECAY_TABLE_GEO] = atof(argv[++i]);
+            count[DECAY_TABLE_GEO] = atoi(argv[++i]);
+        }
+        else if (argv[i][0] != '-')
+        {
+            path = argv[i];
+        }
+        else
+        {
+            bprintlf("Usage: %s [FILE] [--engine 0|1|2] [--altitude MIN MAX COUNT] [--area-mass MIN MAX COUNT] [--srf MIN MAX COUNT] [--geo MIN MAX COUNT]", argv[0]);
+            return 1;
+        }
+    }
+
+    if (engine < DECAY_ENGINE_FIXED || engine > DECAY_ENGINE_QUADRATURE)
+    {
+        bprintlf(RED_FG "ERROR: Unknown engine %d.", engine);
+        return 1;
+    }
+
+    bprintlf("Generating %u x %u x %u x %u lifetime table...", count[0], count[1], count[2], count[3]);
+
+    if (decay_table_generate(path, count, first, last, engine) < 0)
+    {
+        bprintlf(RED_FG "ERROR: Failed to generate %s.", path);
+        return 1;
+    }
+
+    decay_table_t *table = decay_table_open(path);
+    if (table == NULL)
+    {
+        bprintlf(RED_FG "ERROR: Failed to read back %s.", path);
+        return 1;
+    }
+
+    bprintlf("Wrote %s: interpolation error %.2e max, %.2e RMS (relative, at cell centers).", path, decay_table_header(table)->max_error, decay_table_header(table)->rms_error);
+    decay_table_close(table);
+
+    return 0;
+}
@@ -10,18 +10,758 @@
  */
 
 // #include <stdlib.h>
+#include <inttypes.h>
+#include <math.h>
+#include <signal.h>
+#include <stdlib.h>
 #include "meb_print.h"
 #include "decay.h"
+#include "decay_catalog.h"
+#include "decay_monte_carlo.h"
+#include "decay_report.h"
+#include "decay_scenario.h"
+#include "decay_server.h"
+#include "decay_shard.h"
+#include "decay_stats.h"
+#include "pool.h"
 #include <stdbool.h>
 
-int main(void)
+// Writes the --stats summary to stderr, clear of results on stdout.
+static void stats_report(void)
 {
+#ifdef MEB_ASYNC
+    meb_log_flush(); // Queued messages come first.
+#endif
+    fprintf(stderr, "\nRuntime statistics:\n");
+    decay_stats_print(stderr);
+}
+
+// Runs a scenario file non-interactively: decay.out --batch FILE [options].
+static int batch_main(int argc, char *argv[])
+{
+    const char *input_path = NULL, *output_path = NULL, *weather_path = NULL, *table_path = NULL;
+    decay_scenario_options_t options = {
+        .engine = DECAY_ENGINE_FIXED,
+        .tolerance = ADAPTIVE_TOLERANCE,
+        .threads = pool_default_threads(),
+    };
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--batch") && i + 1 < argc)
+        {
+            input_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--output") && i + 1 < argc)
+        {
+            output_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--engine") && i + 1 < argc)
+        {
+            options.engine = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc)
+        {
+            options.tolerance = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+        {
+            options.threads = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--weather") && i + 1 < argc)
+        {
+            weather_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--atmosphere") && i + 1 < argc)
+        {
+            options.atmosphere = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--checkpoints") && i + 1 < argc)
+        {
+            options.checkpoints = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--shard") && i + 1 < argc && decay_shard_parse(argv[i + 1], &options.shard) == 0)
+        {
+            i++;
+        }
+        else if (!strcmp(argv[i], "--partial") && i + 1 < argc)
+        {
+            options.partial = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--table") && i + 1 < argc)
+        {
+            table_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--stats"))
+        {
+            bprintlf("Usage: %s [--batch FILE|- [--output FILE] [--engine 0|1|2] [--tolerance TOL] [--threads N] [--weather FILE] [--atmosphere 0|1] [--table FILE] [--checkpoints DIR] [--shard I/N] [--partial FILE]] [--stats]", argv[0]);
+            bprintlf("       %s --catalog FILE [options]; run with --catalog alone to list them.", argv[0]);
+            bprintlf("       %s --serve SOCKET|- [options]; run with --serve alone to list them.", argv[0]);
+            bprintlf("       %s --sweep RUNS [options]; run with --sweep alone to list them.", argv[0]);
+            bprintlf("       %s --monte-carlo SAMPLES [options]; run with --monte-carlo alone to list them.", argv[0]);
+            bprintlf("       %s --merge PARTIAL... [--output FILE]", argv[0]);
+            bprintlf("       %s --compare FILE|- [options]; run with --compare alone to list them.", argv[0]);
+            return 1;
+        }
+    }
+
+    if (input_path == NULL || options.engine < DECAY_ENGINE_FIXED || options.engine > DECAY_ENGINE_QUADRATURE || options.atmosphere < DECAY_ATMOSPHERE_EXPONENTIAL || options.atmosphere > DECAY_ATMOSPHERE_STANDARD)
+    {
+        bprintlf(RED_FG "ERROR: A scenario file and a known engine and atmosphere are required.");
+        return 1;
+    }
+
+    FILE *input = strcmp(input_path, "-") ? fopen(input_path, "r") : stdin;
+    FILE *output = output_path != NULL && options.partial == NULL ? fopen(output_path, "w") : stdout;
+    decay_weather_t *weather = weather_path != NULL ? decay_weather_open(weather_path) : NULL;
+    options.weather = weather;
+    decay_table_t *table = table_path != NULL ? decay_table_open(table_path) : NULL;
+    options.table = table;
+
+    int retval = 0;
+    if (input == NULL || output == NULL || (weather_path != NULL && weather == NULL) || (table_path != NULL && table == NULL))
+    {
+        bprintlf(RED_FG "ERROR: Could not open %s.", input == NULL ? input_path : output == NULL ? output_path : weather == NULL && weather_path != NULL ? weather_path : table_path);
+        retval = 1;
+    }
+    else if (decay_scenario_run(input, output, &options) < 0)
+    {
+        retval = 1;
+    }
+
+    if (input != NULL && input != stdin) {fclose(input);}
+    if (output != NULL && output != stdout) {fclose(output);}
+    decay_weather_close(weather);
+    decay_table_close(table);
+
+    return retval;
+}
+
+// Compares spacecraft configurations that share an orbit and space weather: decay.out --compare FILE|- --altitude KM --srf F10.7 --geo AP [options].
+static int compare_main(int argc, char *argv[])
+{
+    const char *input_path = NULL, *output_path = NULL;
+    double altitude = 0, solar_radio_flux = 0, geomagnetic_a_index = 0, tolerance = ADAPTIVE_TOLERANCE;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--compare") && i + 1 < argc)
+        {
+            input_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--altitude") && i + 1 < argc)
+        {
+            altitude = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--srf") && i + 1 < argc)
+        {
+            solar_radio_flux = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--geo") && i + 1 < argc)
+        {
+            geomagnetic_a_index = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc)
+        {
+            tolerance = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--output") && i + 1 < argc)
+        {
+            output_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--stats"))
+        {
+            bprintlf("Usage: %s --compare FILE|- --altitude KM --srf F10.7 --geo AP [--tolerance TOL] [--output FILE] [--stats]", argv[0]);
+            return 1;
+        }
+    }
+
+    // The one integration every configuration is rescaled from.
+    decay_normalized_t normalized;
+    if (input_path == NULL || altitude * 1000 <= KARMAN_LINE || !(altitude < DECAY_ATMOSPHERE_EXPONENTIAL_CEILING) ||
+        decay_normalize(altitude, solar_radio_flux, geomagnetic_a_index, tolerance, &normalized) < 0)
+    {
+        bprintlf(RED_FG "ERROR: A configuration file and an initial altitude between %d and %.0f km are required.", KARMAN_LINE / 1000, DECAY_ATMOSPHERE_EXPONENTIAL_CEILING);
+        return 1;
+    }
+
+    FILE *input = strcmp(input_path, "-") ? fopen(input_path, "r") : stdin;
+    FILE *output = output_path != NULL ? fopen(output_path, "w") : stdout;
+    if (input == NULL || output == NULL)
+    {
+        bprintlf(RED_FG "ERROR: Could not open %s.", input == NULL ? input_path : output_path);
+        if (input != NULL && input != stdin) {fclose(input);}
+        return 1;
+    }
+
+    // Each line holds MASS AREA; malformed lines are answered with empty fields, like a batch.
+    fprintf(output, "line,mass,area,days,error_days\n");
+    char line[256];
+    for (int number = 1; fgets(line, sizeof(line), input) != NULL; number++)
+    {
+        double satellite_mass = 0, satellite_area = 0;
+        for (char *c = line; *c != '\0'; c++)
+        {
+            *c = *c == ',' ? ' ' : *c;
+        }
+
+        char first = 0;
+        if (sscanf(line, " %c", &first) != 1 || first == '#')
+        {
+            continue;
+        }
+
+        if (sscanf(line, "%lf %lf", &satellite_mass, &satellite_area) != 2 || !(satellite_mass > 0) || !(satellite_area > 0))
+        {
+            fprintf(output, "%d,,,,\n", number);
+            continue;
+        }
+
+        double error_bound = 0;
+        double lifetime = decay_normalized_lifetime(&normalized, satellite_mass, satellite_area, &error_bound);
+        if (lifetime < 0)
+        {
+            fprintf(output, "%d,%f,%f,-1,\n", number, satellite_mass, satellite_area);
+        }
+        else
+        {
+            fprintf(output, "%d,%f,%f,%f,%f\n", number, satellite_mass, satellite_area, lifetime / 86400, error_bound / 86400);
+        }
+    }
+
+    if (input != stdin) {fclose(input);}
+    if (output != stdout) {fclose(output);}
+
+    return 0;
+}
+
+// Screens a TLE catalog non-interactively: decay.out --catalog FILE [options].
+static int catalog_main(int argc, char *argv[])
+{
+    const char *catalog_path = NULL, *map_path = NULL, *output_path = NULL;
+    decay_catalog_options_t options = {
+        .engine = DECAY_ENGINE_QUADRATURE,
+        .tolerance = ADAPTIVE_TOLERANCE,
+        .threads = pool_default_threads(),
+        .solar_radio_flux = DECAY_CATALOG_SRF,
+        .geomagnetic_a_index = DECAY_CATALOG_GEO,
+        .atmosphere = DECAY_ATMOSPHERE_EXPONENTIAL,
+        .limit = 0,
+    };
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--catalog") && i + 1 < argc)
+        {
+            catalog_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--masses") && i + 1 < argc)
+        {
+            map_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--output") && i + 1 < argc)
+        {
+            output_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--engine") && i + 1 < argc)
+        {
+            options.engine = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc)
+        {
+            options.tolerance = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+        {
+            options.threads = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--srf") && i + 1 < argc)
+        {
+            options.solar_radio_flux = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--geo") && i + 1 < argc)
+        {
+            options.geomagnetic_a_index = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--atmosphere") && i + 1 < argc)
+        {
+            options.atmosphere = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--top") && i + 1 < argc)
+        {
+            options.limit = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--stats"))
+        {
+            bprintlf("Usage: %s --catalog FILE [--masses FILE] [--output FILE] [--engine 0|1|2] [--tolerance TOL] [--threads N] [--srf F10.7] [--geo AP] [--atmosphere 0|1] [--top N] [--stats]", argv[0]);
+            return 1;
+        }
+    }
+
+    if (catalog_path == NULL || options.engine < DECAY_ENGINE_FIXED || options.engine > DECAY_ENGINE_QUADRATURE || options.atmosphere < DECAY_ATMOSPHERE_EXPONENTIAL || options.atmosphere > DECAY_ATMOSPHERE_STANDARD)
+    {
+        bprintlf(RED_FG "ERROR: A catalog file and a known engine and atmosphere are required.");
+        return 1;
+    }
+
+    FILE *output = output_path != NULL ? fopen(output_path, "w") : stdout;
+    if (output == NULL)
+    {
+        bprintlf(RED_FG "ERROR: Could not open %s.", output_path);
+        return 1;
+    }
+
+    int retval = decay_catalog_run(catalog_path, map_path, output, &options) < 0;
+
+    if (output != stdout) {fclose(output);}
+
+    return retval;
+}
+
+// Runs a multi-run sweep, or a shard of it, non-interactively: decay.out --sweep RUNS [options].
+static int sweep_main(int argc, char *argv[])
+{
+    const char *output_path = NULL, *partial = NULL;
+    decay_shard_sweep_t sweep = {
+        .engine = DECAY_ENGINE_FIXED,
+        .run_increment = 50,
+        .tolerance = ADAPTIVE_TOLERANCE,
+        .threads = pool_default_threads(),
+    };
+    decay_shard_t shard = {.index = 0, .count = 1};
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--sweep") && i + 1 < argc)
+        {
+            sweep.runs = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--increment") && i + 1 < argc)
+        {
+            sweep.run_increment = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--mass") && i + 1 < argc)
+        {
+            sweep.satellite_mass = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--area") && i + 1 < argc)
+        {
+            sweep.satellite_area = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--altitude") && i + 1 < argc)
+        {
+            sweep.altitude = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--srf") && i + 1 < argc)
+        {
+            sweep.solar_radio_flux = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--geo") && i + 1 < argc)
+        {
+            sweep.geomagnetic_a_index = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--engine") && i + 1 < argc)
+        {
+            sweep.engine = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc)
+        {
+            sweep.tolerance = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+        {
+            sweep.threads = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--shard") && i + 1 < argc && decay_shard_parse(argv[i + 1], &shard) == 0)
+        {
+            i++;
+        }
+        else if (!strcmp(argv[i], "--partial") && i + 1 < argc)
+        {
+            partial = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--output") && i + 1 < argc)
+        {
+            output_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--stats"))
+        {
+            bprintlf("Usage: %s --sweep RUNS --mass KG --area M2 --altitude KM --srf F10.7 --geo AP [--increment KM] [--engine 0|1|2] [--tolerance TOL] [--threads N] [--shard I/N] [--partial FILE] [--output FILE] [--stats]", argv[0]);
+            return 1;
+        }
+    }
+
+    FILE *output = output_path != NULL && partial == NULL ? fopen(output_path, "w") : stdout;
+    if (output == NULL)
+    {
+        bprintlf(RED_FG "ERROR: Could not open %s.", output_path);
+        return 1;
+    }
+
+    int retval = 0;
+    if (decay_shard_sweep(&sweep, &shard, output, partial) < 0)
+    {
+        bprintlf(RED_FG "ERROR: A positive run count, mass, and area, an initial altitude between %d and %.1f km, and a known engine are required.", KARMAN_LINE / 1000, MAX_ALTITUDE);
+        retval = 1;
+    }
+
+    if (output != stdout) {fclose(output);}
+
+    return retval;
+}
+
+// Runs a Monte Carlo analysis, or a shard of it, non-interactively: decay.out --monte-carlo SAMPLES [options].
+static int monte_carlo_main(int argc, char *argv[])
+{
+    const char *output_path = NULL, *partial = NULL;
+    const char *fields[4] = {NULL};
+    decay_monte_carlo_t config = {0};
+    config.seed = 1;
+    config.engine = DECAY_ENGINE_FIXED;
+    config.tolerance = ADAPTIVE_TOLERANCE;
+    config.threads = pool_default_threads();
+    decay_shard_t shard = {.index = 0, .count = 1};
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--monte-carlo") && i + 1 < argc)
+        {
+            config.samples = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--mass") && i + 1 < argc)
+        {
+            fields[0] = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--area") && i + 1 < argc)
+        {
+            fields[1] = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--srf") && i + 1 < argc)
+        {
+            fields[2] = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--geo") && i + 1 < argc)
+        {
+            fields[3] = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--altitude") && i + 1 < argc)
+        {
+            config.altitude = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc)
+        {
+            config.seed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (!strcmp(argv[i], "--engine") && i + 1 < argc)
+        {
+            config.engine = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc)
+        {
+            config.tolerance = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+        {
+            config.threads = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--shard") && i + 1 < argc && decay_shard_parse(argv[i + 1], &shard) == 0)
+        {
+            i++;
+        }
+        else if (!strcmp(argv[i], "--partial") && i + 1 < argc)
+        {
+            partial = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--output") && i + 1 < argc)
+        {
+            output_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--stats"))
+        {
+            bprintlf("Usage: %s --monte-carlo SAMPLES --mass DIST --area DIST --altitude KM --srf DIST --geo DIST [--seed N] [--engine 0|1|2] [--tolerance TOL] [--threads N] [--shard I/N] [--partial FILE] [--output FILE] [--stats]", argv[0]);
+            bprintlf("       where each DIST is fixed (X), normal (MEAN:SD), or uniform (LOW..HIGH).");
+            return 1;
+        }
+    }
+
+    decay_distribution_t *distributions[4] = {&config.satellite_mass, &config.satellite_area, &config.solar_radio_flux, &config.geomagnetic_a_index};
+    for (int i = 0; i < 4; i++)
+    {
+        if (fields[i] == NULL || decay_distribution_parse(fields[i], distributions[i]) < 0)
+        {
+            bprintlf(RED_FG "ERROR: Distributions of the mass, area, Solar Radio Flux, and Geomagnetic A Index are required.");
+            return 1;
+        }
+    }
+
+    FILE *output = output_path != NULL && partial == NULL ? fopen(output_path, "w") : stdout;
+    if (output == NULL)
+    {
+        bprintlf(RED_FG "ERROR: Could not open %s.", output_path);
+        return 1;
+    }
+
+    int retval = 0;
+    if (decay_shard_monte_carlo(&config, &shard, output, partial) < 0)
+    {
+        bprintlf(RED_FG "ERROR: Monte Carlo run failed.");
+        retval = 1;
+    }
+
+    if (output != stdout) {fclose(output);}
+
+    return retval;
+}
+
+// Combines the partial results of every shard of a job: decay.out --merge PARTIAL... [--output FILE].
+static int merge_main(int argc, char *argv[])
+{
+    const char *output_path = NULL;
+    const char **paths = malloc(argc * sizeof(const char *));
+    int count = 0;
+    if (paths == NULL)
+    {
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--output") && i + 1 < argc)
+        {
+            output_path = argv[++i];
+        }
+        else if (argv[i][0] != '-')
+        {
+            paths[count++] = argv[i];
+        }
+        else if (strcmp(argv[i], "--merge") && strcmp(argv[i], "--stats"))
+        {
+            bprintlf("Usage: %s --merge PARTIAL... [--output FILE] [--stats]", argv[0]);
+            free(paths);
+            return 1;
+        }
+    }
+
+    FILE *output = output_path != NULL ? fopen(output_path, "w") : stdout;
+    if (output == NULL)
+    {
+        bprintlf(RED_FG "ERROR: Could not open %s.", output_path);
+        free(paths);
+        return 1;
+    }
+
+    int retval = 0;
+    if (decay_shard_merge(paths, count, output) < 0)
+    {
+        bprintlf(RED_FG "ERROR: The partial results do not make up one whole job.");
+        retval = 1;
+    }
+
+    if (output != stdout) {fclose(output);}
+    free(paths);
+
+    return retval;
+}
+
+#if !(defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__))
+// Set by SIGINT and SIGTERM while serving a socket.
+static volatile sig_atomic_t serve_interrupted = 0;
+
+static void serve_interrupt(int signal)
+{
+    (void)signal;
+    serve_interrupted = 1;
+}
+#endif
+
+// Serves queries from a Unix socket or standard input: decay.out --serve PATH|- [options].
+static int serve_main(int argc, char *argv[])
+{
+    const char *path = NULL, *weather_path = NULL, *table_path = NULL;
+    decay_server_options_t options = {
+        .scenario = {
+            .engine = DECAY_ENGINE_ADAPTIVE,
+            .tolerance = ADAPTIVE_TOLERANCE,
+            .threads = pool_default_threads(),
+            .atmosphere = DECAY_ATMOSPHERE_EXPONENTIAL,
+        },
+        .cache_entries = DECAY_SERVER_CACHE,
+        .quantum = DECAY_SERVER_QUANTUM,
+    };
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--serve") && i + 1 < argc)
+        {
+            path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--engine") && i + 1 < argc)
+        {
+            options.scenario.engine = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc)
+        {
+            options.scenario.tolerance = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+        {
+            options.scenario.threads = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--weather") && i + 1 < argc)
+        {
+            weather_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--atmosphere") && i + 1 < argc)
+        {
+            options.scenario.atmosphere = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--cache") && i + 1 < argc)
+        {
+            options.cache_entries = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--quantum") && i + 1 < argc)
+        {
+            options.quantum = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--table") && i + 1 < argc)
+        {
+            table_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--stats"))
+        {
+            bprintlf("Usage: %s --serve SOCKET|- [--engine 0|1|2] [--tolerance TOL] [--threads N] [--weather FILE] [--atmosphere 0|1] [--table FILE] [--cache ENTRIES] [--quantum RELATIVE] [--stats]", argv[0]);
+            return 1;
+        }
+    }
+
+    if (path == NULL || options.scenario.engine < DECAY_ENGINE_FIXED || options.scenario.engine > DECAY_ENGINE_QUADRATURE || options.scenario.atmosphere < DECAY_ATMOSPHERE_EXPONENTIAL || options.scenario.atmosphere > DECAY_ATMOSPHERE_STANDARD)
+    {
+        bprintlf(RED_FG "ERROR: A socket path or - and a known engine and atmosphere are required.");
+        return 1;
+    }
+
+    decay_weather_t *weather = weather_path != NULL ? decay_weather_open(weather_path) : NULL;
+    if (weather_path != NULL && weather == NULL)
+    {
+        bprintlf(RED_FG "ERROR: Could not open %s.", weather_path);
+        return 1;
+    }
+    options.scenario.weather = weather;
+
+    decay_table_t *table = table_path != NULL ? decay_table_open(table_path) : NULL;
+    if (table_path != NULL && table == NULL)
+    {
+        bprintlf(RED_FG "ERROR: Could not open %s.", table_path);
+        decay_weather_close(weather);
+        return 1;
+    }
+    options.scenario.table = table;
+
+#if !(defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__))
+    // A client that disconnects before its responses are written must not end the server.
+    signal(SIGPIPE, SIG_IGN);
+
+    // Interrupts stop a socket server so that it removes the socket file; standard input keeps the default handlers.
+    if (strcmp(path, "-"))
+    {
+        struct sigaction action = {0};
+        action.sa_handler = serve_interrupt;
+        sigaction(SIGINT, &action, NULL);
+        sigaction(SIGTERM, &action, NULL);
+        options.stop = &serve_interrupted;
+    }
+#endif
+
+    // Results go to standard output when serving it, so the final counters go to stderr.
+    decay_server_stats_t stats;
+    int retval = decay_server_run(path, &options, &stats) < 0;
+
+    char line[512];
+    decay_server_format_stats(&stats, line, sizeof(line));
+#ifdef MEB_ASYNC
+    meb_log_flush(); // Queued messages come first.
+#endif
+    fprintf(stderr, "%s\n", line);
+
+    decay_weather_close(weather);
+    decay_table_close(table);
+    return retval;
+}
+
+int main(int argc, char *argv[])
+{
+    // --stats reports on the whole session at exit, batch or interactive.
+    bool batch = false, catalog = false, serve = false, sweep = false, monte_carlo = false, merge = false, compare = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--stats"))
+        {
+            decay_stats_enable(true);
+            atexit(stats_report);
+        }
+        else
+        {
+            batch = true;
+            catalog = catalog || !strcmp(argv[i], "--catalog");
+            serve = serve || !strcmp(argv[i], "--serve");
+            sweep = sweep || !strcmp(argv[i], "--sweep");
+            monte_carlo = monte_carlo || !strcmp(argv[i], "--monte-carlo");
+            merge = merge || !strcmp(argv[i], "--merge");
+            compare = compare || !strcmp(argv[i], "--compare");
+        }
+    }
+
+    if (serve)
+    {
+        return serve_main(argc, argv);
+    }
+
+    if (catalog)
+    {
+        return catalog_main(argc, argv);
+    }
+
+    if (sweep)
+    {
+        return sweep_main(argc, argv);
+    }
+
+    if (monte_carlo)
+    {
+        return monte_carlo_main(argc, argv);
+    }
+
+    if (merge)
+    {
+        return merge_main(argc, argv);
+    }
+
+    if (compare)
+    {
+        return compare_main(argc, argv);
+    }
+
+    if (batch)
+    {
+        return batch_main(argc, argv);
+    }
+
     int user_input = 0;
     float satellite_mass = 0.f, satellite_area = 0.f, altitude = 0.f, solar_radio_flux = 0.f, geomagnetic_a_index = 0.f, mission_time = 0.f;
     bool save_to_csv = false;
+    bool single_pass = false;
     char arg_list[128] = {0};
     int runs = 1;
     float run_increment = 50;
+    int threads = pool_default_threads();
+    int engine = DECAY_ENGINE_FIXED;
+    double tolerance = ADAPTIVE_TOLERANCE;
+    double solver_tolerance = SOLVER_TOLERANCE;
+    double last_srf = 0, last_geo = 0; // Previous answers, used to warm-start the solvers.
+    decay_weather_t *weather = NULL;
+    char weather_path[128] = {0};
+    decay_report_trajectory_t trajectory = {.path = NULL, .format = DECAY_TRAJECTORY_CSV, .interval = TEMPORAL_RESOLUTION};
+    char trajectory_path[128] = {0};
 
 get_input:
     bprintlf("What would you like to calculate?");
@@ -29,7 +769,37 @@ get_input:
     bprintlf("(2) Maximum average Solar Radio Flux.");
     bprintlf("(3) Maximum average Geomagnetic A Index.");
     bprintlf("(4) Save-to-CSV (TTR only): %s", save_to_csv ? "ON" : "OFF");
-    bprintlf("(5) Runs: %d; Increment +%.03f km", runs, run_increment);
+    bprintlf("(5) Runs: %d; Increment +%.03f km; Threads: %d", runs, run_increment, threads);
+    if (engine == DECAY_ENGINE_ADAPTIVE)
+    {
+        bprintlf("(6) Engine: ADAPTIVE; Tolerance %g", tolerance);
+    }
+    else if (engine == DECAY_ENGINE_QUADRATURE)
+    {
+        bprintlf("(6) Engine: QUADRATURE (no trajectory)");
+    }
+    else
+    {
+        bprintlf("(6) Engine: FIXED (%d s steps)", TEMPORAL_RESOLUTION);
+    }
+    bprintlf("(7) Sweep mode (TTR only): %s", single_pass ? "SINGLE-PASS (end points only)" : "SEPARATE RUNS");
+    bprintlf("(8) Re-entry time uncertainty (Monte Carlo).");
+    if (weather != NULL)
+    {
+        bprintlf("(9) Space weather (TTR only): HISTORY %s (%u samples every %g hours)", weather_path, decay_weather_header(weather)->count, decay_weather_header(weather)->interval / 3600);
+    }
+    else
+    {
+        bprintlf("(9) Space weather (TTR only): AVERAGES");
+    }
+    if (trajectory.path != NULL)
+    {
+        bprintlf("(10) Trajectory files (TTR only): %s every %g s to %s", trajectory.format == DECAY_TRAJECTORY_BINARY ? "BINARY" : "CSV", trajectory.interval, trajectory.path);
+    }
+    else
+    {
+        bprintlf("(10) Trajectory files (TTR only): OFF");
+    }
     // bprintlf("(5) GO BACK");
     bprintlf("(0) QUIT");
     bprintf("> ");
@@ -68,15 +838,24 @@ intake:
             bprintlf(RED_FG "ERROR: Maximum altitude of %.1f km exceeded.\n", MAX_ALTITUDE);
             goto intake;
         }
+        else if (!(altitude < DECAY_ATMOSPHERE_EXPONENTIAL_CEILING))
+        {
+            bprintlf(RED_FG "ERROR: The exponential atmosphere ends at %.0f km.\n", DECAY_ATMOSPHERE_EXPONENTIAL_CEILING);
+            goto intake;
+        }
         
-        decay_calculate(satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index, save_to_csv, runs, run_increment);
+        if (weather != NULL)
+        {
+            bprintlf("Using the space weather history %s in place of the averages.", weather_path);
+        }
+        decay_calculate(satellite_mass, satellite_area, altitude, solar_radio_flux, geomagnetic_a_index, save_to_csv, runs, run_increment, engine, tolerance, threads, single_pass, weather, &trajectory);
         bprintlf();
         
         goto intake;
 
     case 2:
         bprintlf("Enter the following values separated by spaces:");
-        bprintlf("Satellite Mass (kg)   Windward Area (m^2)   Initial Altitude (km)   Avg. Geomagnetic A Index   Mission Time (days)");
+        bprintlf("Satellite Mass (kg)   Windward Area (m^2)   Initial Altitude (km)   Avg. Geomagnetic A Index   Mission Time (days)   [Tolerance (sfu), default %g]", SOLVER_TOLERANCE);
         bprintf("> ");
 
         fgets(arg_list, sizeof(arg_list), stdin);
@@ -87,7 +866,8 @@ intake:
             goto get_input;
         }
 
-        if (sscanf(arg_list, "%f %f %f %f %f", &satellite_mass, &satellite_area, &altitude, &geomagnetic_a_index, &mission_time) != 5)
+        solver_tolerance = SOLVER_TOLERANCE;
+        if (sscanf(arg_list, "%f %f %f %f %f %lf", &satellite_mass, &satellite_area, &altitude, &geomagnetic_a_index, &mission_time, &solver_tolerance) < 5)
         {
             bprintf(RED_FG "ERROR: Invalid input; incorrect number of arguments entered.\n");
             while ((getchar()) != '\n')
@@ -99,15 +879,20 @@ intake:
             bprintlf(RED_FG "ERROR: Maximum altitude of %.1f km exceeded.\n", MAX_ALTITUDE);
             goto intake;
         }
+        else if (!(altitude < DECAY_ATMOSPHERE_EXPONENTIAL_CEILING))
+        {
+            bprintlf(RED_FG "ERROR: The exponential atmosphere ends at %.0f km.\n", DECAY_ATMOSPHERE_EXPONENTIAL_CEILING);
+            goto intake;
+        }
 
-        decay_max_avg_srf(satellite_mass, satellite_area, altitude, geomagnetic_a_index, mission_time);
+        last_srf = decay_max_avg_srf(satellite_mass, satellite_area, altitude, geomagnetic_a_index, mission_time, engine, last_srf, solver_tolerance);
         bprintlf();
 
         goto intake;
 
     case 3:
         bprintlf("Enter the following values separated by spaces:");
-        bprintlf("Satellite Mass (kg)   Windward Area (m^2)   Initial Altitude (km)   Avg. Solar Radio Flux (F10.7)   Mission Time (days)");
+        bprintlf("Satellite Mass (kg)   Windward Area (m^2)   Initial Altitude (km)   Avg. Solar Radio Flux (F10.7)   Mission Time (days)   [Tolerance, default %g]", SOLVER_TOLERANCE);
         bprintf("> ");
 
         fgets(arg_list, sizeof(arg_list), stdin);
@@ -118,7 +903,8 @@ intake:
             goto get_input;
         }
 
-        if (sscanf(arg_list, "%f %f %f %f %f", &satellite_mass, &satellite_area, &altitude, &solar_radio_flux, &mission_time) != 5)
+        solver_tolerance = SOLVER_TOLERANCE;
+        if (sscanf(arg_list, "%f %f %f %f %f %lf", &satellite_mass, &satellite_area, &altitude, &solar_radio_flux, &mission_time, &solver_tolerance) < 5)
         {
             bprintf(RED_FG "ERROR: Invalid input; incorrect number of arguments entered.\n");
             while ((getchar()) != '\n')
@@ -130,8 +916,13 @@ intake:
             bprintlf(RED_FG "ERROR: Maximum altitude of %.1f km exceeded.\n", MAX_ALTITUDE);
             goto intake;
         }
+        else if (!(altitude < DECAY_ATMOSPHERE_EXPONENTIAL_CEILING))
+        {
+            bprintlf(RED_FG "ERROR: The exponential atmosphere ends at %.0f km.\n", DECAY_ATMOSPHERE_EXPONENTIAL_CEILING);
+            goto intake;
+        }
 
-        decay_max_avg_geo(satellite_mass, satellite_area, altitude, solar_radio_flux, mission_time);
+        last_geo = decay_max_avg_geo(satellite_mass, satellite_area, altitude, solar_radio_flux, mission_time, engine, last_geo, solver_tolerance);
         bprintlf();
 
         goto intake;
@@ -139,10 +930,13 @@ intake:
     case 4:
         save_to_csv = save_to_csv ? false : true;
         goto get_input;
+    case 7:
+        single_pass = single_pass ? false : true;
+        goto get_input;
     case 5:
         
         bprintlf("Enter the following values separated by spaces:");
-        bprintlf("Number of Runs Desired   Altitude Increase Each Run (km)");
+        bprintlf("Number of Runs Desired   Altitude Increase Each Run (km)   [Threads, default %d]", pool_default_threads());
         bprintf("> ");
 
         fgets(arg_list, sizeof(arg_list), stdin);
@@ -153,7 +947,8 @@ intake:
             goto get_input;
         }
 
-        if (sscanf(arg_list, "%d %f", &runs, &run_increment) != 2)
+        threads = pool_default_threads();
+        if (sscanf(arg_list, "%d %f %d", &runs, &run_increment, &threads) < 2)
         {
             bprintf(RED_FG "ERROR: Invalid input; incorrect number of arguments entered.\n");
             while ((getchar()) != '\n')
@@ -172,12 +967,198 @@ intake:
             run_increment = 0.001;
             goto get_input;
         }
+        else if (threads < 1)
+        {
+            bprintlf(RED_FG "ERROR: Minimum of one thread.\n");
+            threads = 1;
+            goto get_input;
+        }
+
+        bprintlf();
+
+        goto get_input;
+
+    case 6:
+        bprintlf("Enter the following values separated by spaces:");
+        bprintlf("Engine (0: Fixed, 1: Adaptive, 2: Quadrature)   Relative Tolerance (Adaptive only, default %g)", ADAPTIVE_TOLERANCE);
+        bprintf("> ");
+
+        fgets(arg_list, sizeof(arg_list), stdin);
+
+        if (!strcmp(arg_list, "\n"))
+        {
+            dbprintlf(RED_FG "Input canceled.\n")
+            goto get_input;
+        }
 
+        tolerance = ADAPTIVE_TOLERANCE;
+        if (sscanf(arg_list, "%d %lf", &engine, &tolerance) < 1)
+        {
+            bprintf(RED_FG "ERROR: Invalid input; incorrect number of arguments entered.\n");
+            goto get_input;
+        }
+        else if (engine < DECAY_ENGINE_FIXED || engine > DECAY_ENGINE_QUADRATURE)
+        {
+            bprintlf(RED_FG "ERROR: Unknown engine %d.\n", engine);
+            engine = DECAY_ENGINE_FIXED;
+            goto get_input;
+        }
+        else if (tolerance <= 0 || tolerance >= 1)
+        {
+            bprintlf(RED_FG "ERROR: Tolerance must be between 0 and 1.\n");
+            tolerance = ADAPTIVE_TOLERANCE;
+            goto get_input;
+        }
+
+        bprintlf();
+
+        goto get_input;
+
+    case 8:
+        bprintlf("Enter the following values separated by spaces; each may be fixed (X), normal (MEAN:SD), or uniform (LOW..HIGH):");
+        bprintlf("Satellite Mass (kg)   Windward Area (m^2)   Initial Altitude (km)   Avg. Solar Radio Flux (F10.7, sfu)   Avg. Geomagnetic A Index   Samples   [Seed, default 1]");
+        bprintf("> ");
+
+        fgets(arg_list, sizeof(arg_list), stdin);
+
+        if (!strcmp(arg_list, "\n"))
+        {
+            dbprintlf(RED_FG "Input canceled.\n")
+            goto get_input;
+        }
+
+        {
+            char fields[5][32] = {{0}};
+            decay_monte_carlo_t config = {0};
+            config.seed = 1;
+            config.engine = engine;
+            config.tolerance = tolerance;
+            config.threads = threads;
+
+            decay_distribution_t altitude_distribution;
+            if (sscanf(arg_list, "%31s %31s %31s %31s %31s %d %" SCNu64, fields[0], fields[1], fields[2], fields[3], fields[4], &config.samples, &config.seed) < 6 ||
+                decay_distribution_parse(fields[0], &config.satellite_mass) < 0 ||
+                decay_distribution_parse(fields[1], &config.satellite_area) < 0 ||
+                decay_distribution_parse(fields[2], &altitude_distribution) < 0 || altitude_distribution.kind != DECAY_DISTRIBUTION_FIXED ||
+                decay_distribution_parse(fields[3], &config.solar_radio_flux) < 0 ||
+                decay_distribution_parse(fields[4], &config.geomagnetic_a_index) < 0)
+            {
+                bprintf(RED_FG "ERROR: Invalid input; expected five distributions (fixed altitude) and a sample count.\n");
+                goto intake;
+            }
+            config.altitude = altitude_distribution.a;
+
+            double *lifetimes = malloc(config.samples > 0 ? config.samples * sizeof(double) : 1);
+            decay_monte_carlo_summary_t summary;
+            if (lifetimes == NULL || decay_monte_carlo(&config, lifetimes) < 0 || decay_monte_carlo_summarize(lifetimes, config.samples, &summary) < 0)
+            {
+                bprintlf(RED_FG "ERROR: Monte Carlo run failed.\n");
+                free(lifetimes);
+                goto intake;
+            }
+            free(lifetimes);
+
+            bprintlf("%d samples; %d exceed 50 years.", summary.samples, summary.exceeded);
+
+            double linearized = 0, deviation = 0;
+            if (decay_monte_carlo_linearized(&config, &linearized, &deviation) == 0)
+            {
+                bprintlf("Linearized: %.2f +/- %.2f days", linearized / 86400, deviation / 86400);
+            }
+            for (int i = 0; i < DECAY_MONTE_CARLO_LEVELS; i++)
+            {
+                if (summary.percentile[i] < 0)
+                {
+                    bprintlf("P%02.0f: > 50 years", summary.level[i]);
+                }
+                else
+                {
+                    bprintlf("P%02.0f: %.2f days", summary.level[i], summary.percentile[i] / 86400);
+                }
+            }
+
+            int most = 1;
+            for (int i = 0; i < DECAY_MONTE_CARLO_BINS; i++)
+            {
+                most = summary.histogram[i] > most ? summary.histogram[i] : most;
+            }
+            for (int i = 0; i < DECAY_MONTE_CARLO_BINS && summary.samples > summary.exceeded; i++)
+            {
+                double lower = (summary.histogram_first + i * summary.histogram_width) / 86400;
+                bprintlf("%10.2f - %10.2f days %6d %.*s", lower, lower + summary.histogram_width / 86400, summary.histogram[i], summary.histogram[i] * 40 / most, "########################################");
+            }
+        }
+        bprintlf();
+
+        goto intake;
+
+    case 9:
+        bprintlf("Enter the path of an F10.7 and Ap history (CSV or binary), optionally followed by a path to save it in binary (press ENTER to use averages):");
+        bprintf("> ");
+
+        fgets(arg_list, sizeof(arg_list), stdin);
+
+        decay_weather_close(weather);
+        weather = NULL;
+
+        {
+            char save_path[128] = {0};
+            if (sscanf(arg_list, "%127s %127s", weather_path, save_path) < 1)
+            {
+                bprintlf("Using average space weather.\n");
+                goto get_input;
+            }
+
+            weather = decay_weather_open(weather_path);
+            if (weather == NULL)
+            {
+                bprintlf(RED_FG "ERROR: Could not load %s.\n", weather_path);
+                goto get_input;
+            }
+
+            if (save_path[0] != '\0' && decay_weather_save(weather, save_path) < 0)
+            {
+                bprintlf(RED_FG "ERROR: Could not save %s.\n", save_path);
+            }
+        }
+        bprintlf();
+
+        goto get_input;
+
+    case 10:
+        bprintlf("Enter the following values separated by spaces (press ENTER to turn trajectory files off):");
+        bprintlf("Path of the First Run   [Format (csv or binary), default csv]   [Seconds per Row, default %d]", TEMPORAL_RESOLUTION);
+        bprintf("> ");
+
+        fgets(arg_list, sizeof(arg_list), stdin);
+
+        trajectory.path = NULL;
+
+        {
+            char format[16] = "csv";
+            double interval = TEMPORAL_RESOLUTION;
+            if (sscanf(arg_list, "%127s %15s %lf", trajectory_path, format, &interval) < 1)
+            {
+                bprintlf("Trajectory files off.\n");
+                goto get_input;
+            }
+
+            if ((strcmp(format, "csv") && strcmp(format, "binary")) || !(interval > 0))
+            {
+                bprintlf(RED_FG "ERROR: Expected a format of csv or binary and a positive interval.\n");
+                goto get_input;
+            }
+
+            trajectory.path = trajectory_path;
+            trajectory.format = strcmp(format, "binary") ? DECAY_TRAJECTORY_CSV : DECAY_TRAJECTORY_BINARY;
+            trajectory.interval = interval;
+        }
         bprintlf();
 
         goto get_input;
 
     case 0:
+        decay_weather_close(weather);
         return 1;
     default:
         bprintlf(RED_FG "ERROR: Invalid value %hhu.\n", user_input);
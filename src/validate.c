@@ -0,0 +1,361 @@
+/**
+ * @file validate.c
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Measures the accuracy and cost of every engine setting against a fine-step reference.
+ *
+ * Reference lifetimes over a grid of altitudes and space weather are first computed with the adaptive engine at a tolerance far tighter than any setting under test. Their own error is estimated against a run ten times tighter still, and they are checked against the fixed engine at a much finer step than TEMPORAL_RESOLUTION, whose re-entry times are only resolved to its step. Every engine setting is then timed over the same grid, and its re-entry time errors are reported next to its cost in a table sorted by cost, with the Pareto-optimal settings (no other setting is both cheaper and more accurate) marked. The program exits with a failure if the reference disagrees with the fine fixed-step run, if any setting exceeds its declared error budget, if an elliptical orbit of the exponential model above its ceiling is not rejected, or if a Monte Carlo run with a mostly negative mass distribution draws a mass that is not positive.
+ *
+ * @version See Git tags for version information.
+ * @date 2026.10.17
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "meb_print.h"
+#include "decay.h"
+#include "decay_monte_carlo.h"
+#include "pool.h"
+
+#define VALIDATE_REFERENCE_TOLERANCE 1e-10 // Adaptive tolerance of the reference.
+#define VALIDATE_REFERENCE_STEP 1          // Seconds per step of the fixed-step check of the reference.
+#define VALIDATE_REFERENCE_AGREEMENT 1e-5  // Largest relative difference allowed between the reference and that check.
+#define VALIDATE_MASS 10          // Kilograms.
+#define VALIDATE_AREA 0.1         // Square meters.
+#define VALIDATE_MAX_CASES 64
+
+/**
+ * @brief One engine setting under test, with the largest relative re-entry time error it is allowed over the grid.
+ *
+ */
+typedef struct
+{
+    const char *name;
+    decay_engine_t engine;
+    double step;      // Seconds per fixed step.
+    double tolerance; // Adaptive tolerance.
+    double budget;    // Relative error.
+} validate_setting_t;
+
+/**
+ * @brief One grid point.
+ *
+ */
+typedef struct
+{
+    double altitude;
+    double solar_radio_flux;
+    double geomagnetic_a_index;
+    double reference; // Lifetime in seconds with the adaptive engine at VALIDATE_REFERENCE_TOLERANCE.
+    double estimate;  // Lifetime in seconds at a tenth of that tolerance, the estimate of the reference's own error.
+    double check;     // Lifetime in seconds with the fixed engine at the check step.
+} validate_case_t;
+
+/**
+ * @brief Outcome of one setting over the grid.
+ *
+ */
+typedef struct
+{
+    double max_error;     // Largest relative error.
+    double rms_error;     // Root mean square relative error.
+    double max_seconds;   // Largest absolute error in seconds.
+    double cost;          // Wall time over the whole grid in seconds.
+    bool pareto;
+} validate_result_t;
+
+// The 60 s fixed engine is the production reference; the others are judged against the same budget or tighter.
+static const validate_setting_t validate_settings[] = {
+    {.name = "fixed 300 s", .engine = DECAY_ENGINE_FIXED, .step = 300, .budget = 2e-3},
+    {.name = "fixed 120 s", .engine = DECAY_ENGINE_FIXED, .step = 120, .budget = 1e-3},
+    {.name = "fixed 60 s", .engine = DECAY_ENGINE_FIXED, .step = 60, .budget = 5e-4},
+    {.name = "fixed 30 s", .engine = DECAY_ENGINE_FIXED, .step = 30, .budget = 5e-4},
+    {.name = "fixed 10 s", .engine = DECAY_ENGINE_FIXED, .step = 10, .budget = 5e-4},
+    {.name = "adaptive 1e-4", .engine = DECAY_ENGINE_ADAPTIVE, .tolerance = 1e-4, .budget = 1e-3},
+    {.name = "adaptive 1e-5", .engine = DECAY_ENGINE_ADAPTIVE, .tolerance = 1e-5, .budget = 5e-4},
+    {.name = "adaptive 1e-6", .engine = DECAY_ENGINE_ADAPTIVE, .tolerance = 1e-6, .budget = 5e-4},
+    {.name = "adaptive 1e-8", .engine = DECAY_ENGINE_ADAPTIVE, .tolerance = 1e-8, .budget = 5e-4},
+    {.name = "quadrature", .engine = DECAY_ENGINE_QUADRATURE, .budget = 5e-4},
+};
+
+#define VALIDATE_SETTINGS (int)(sizeof(validate_settings) / sizeof(validate_settings[0]))
+
+/**
+ * @brief Reference runs shared across the pool.
+ *
+ */
+typedef struct
+{
+    validate_case_t *cases;
+    double step;
+} validate_reference_t;
+
+static double validate_lifetime(const validate_case_t *grid, decay_engine_t engine, double step, double tolerance)
+{
+    decay_config_t config = {
+        .engine = engine,
+        .satellite_mass = VALIDATE_MASS,
+        .satellite_area = VALIDATE_AREA,
+        .altitude = grid->altitude,
+        .solar_radio_flux = grid->solar_radio_flux,
+        .geomagnetic_a_index = grid->geomagnetic_a_index,
+        .tolerance = tolerance,
+        .time_limit = INFINITY,
+        .step = step,
+    };
+
+    decay_result_t result;
+    decay_run(&config, &result);
+    return result.lifetime;
+}
+
+static void validate_reference_job(int index, void *context)
+{
+    validate_reference_t *reference = context;
+    validate_case_t *grid = &reference->cases[index];
+    grid->reference = validate_lifetime(grid, DECAY_ENGINE_ADAPTIVE, 0, VALIDATE_REFERENCE_TOLERANCE);
+    grid->estimate = validate_lifetime(grid, DECAY_ENGINE_ADAPTIVE, 0, VALIDATE_REFERENCE_TOLERANCE / 10);
+    grid->check = validate_lifetime(grid, DECAY_ENGINE_FIXED, reference->step, 0);
+}
+
+/**
+ * @brief Checks elliptical and circular orbits of the exponential model on either side of its ceiling with every engine.
+ *
+ * Orbits whose apogee reaches DECAY_ATMOSPHERE_EXPONENTIAL_CEILING, such as a geostationary transfer orbit or a circular orbit above it, must be rejected as invalid rather than reported as re-entered; those below it must re-enter.
+ *
+ * @return int Number of failed checks.
+ */
+static int validate_elliptical(void)
+{
+    // Perigee and apogee in kilometers, with an apogee of 0 for a circular orbit, and whether the orbit is valid.
+    static const struct
+    {
+        double perigee;
+        double apogee;
+        bool valid;
+    } orbits[] = {{250, 2400, true}, {250, 3000, false}, {200, 35786, false}, {2500, 0, false}};
+    static const decay_engine_t engines[] = {DECAY_ENGINE_FIXED, DECAY_ENGINE_ADAPTIVE, DECAY_ENGINE_QUADRATURE};
+
+    int failures = 0;
+    for (int o = 0; o < (int)(sizeof(orbits) / sizeof(orbits[0])); o++)
+    {
+        for (int e = 0; e < (int)(sizeof(engines) / sizeof(engines[0])); e++)
+        {
+            decay_config_t config = {
+                .engine = engines[e],
+                .satellite_mass = VALIDATE_MASS,
+                .satellite_area = VALIDATE_AREA,
+                .altitude = orbits[o].perigee,
+                .solar_radio_flux = 150,
+                .geomagnetic_a_index = 15,
+                .time_limit = INFINITY,
+                .atmosphere = DECAY_ATMOSPHERE_EXPONENTIAL,
+                .apogee = orbits[o].apogee,
+            };
+
+            decay_result_t result;
+            int ret = decay_run(&config, &result);
+            bool passed = orbits[o].valid ? ret == 0 && result.status == DECAY_STATUS_REENTERED && result.lifetime > 0
+                                          : ret < 0 && result.status == DECAY_STATUS_INVALID && result.lifetime < 0;
+            failures += !passed;
+
+            if (!passed)
+            {
+                bprintlf(RED_FG "FAIL: Exponential %g x %g km orbit with engine %d: returned %d, status %d, lifetime %g s.", orbits[o].perigee, orbits[o].apogee, engines[e], ret, result.status, result.lifetime);
+            }
+        }
+    }
+
+    bprintlf("Elliptical orbits of the exponential model: %d failed.", failures);
+    return failures;
+}
+
+/**
+ * @brief Checks that a Monte Carlo run whose mass distribution is mostly negative draws only positive masses.
+ *
+ * Normal inputs are truncated to positive values; with a mean of -2.9 kg and a deviation of 1 kg, fewer than one draw in five hundred of the untruncated normal is positive. Every sample of this light satellite re-enters within days, so any sample counted as exceeding 50 years means that a mass was not drawn from the truncated distribution.
+ *
+ * @return int Number of failed checks.
+ */
+static int validate_monte_carlo(void)
+{
+    decay_monte_carlo_t config = {
+        .satellite_mass = {DECAY_DISTRIBUTION_NORMAL, -2.9, 1},
+        .satellite_area = {DECAY_DISTRIBUTION_FIXED, VALIDATE_AREA, 0},
+        .altitude = 300,
+        .solar_radio_flux = {DECAY_DISTRIBUTION_NORMAL, -50, 60},
+        .geomagnetic_a_index = {DECAY_DISTRIBUTION_FIXED, 15, 0},
+        .samples = 200,
+        .seed = 1,
+        .engine = DECAY_ENGINE_FIXED,
+    };
+
+    double lifetimes[200];
+    decay_monte_carlo_summary_t summary = {0};
+    int failures = decay_monte_carlo(&config, lifetimes) < 0 || decay_monte_carlo_summarize(lifetimes, config.samples, &summary) < 0 || summary.exceeded > 0;
+
+    if (failures)
+    {
+        bprintlf(RED_FG "FAIL: Monte Carlo run with a mostly negative mass distribution: %d of %d samples exceeded 50 years.", summary.exceeded, config.samples);
+    }
+
+    bprintlf("Truncated Monte Carlo distributions: %d failed.", failures);
+    return failures;
+}
+
+static double validate_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char *argv[])
+{
+    double reference_step = VALIDATE_REFERENCE_STEP;
+    double budget = 0; // Overrides every declared budget when positive.
+    int threads = pool_default_threads();
+    bool quick = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--reference") && i + 1 < argc)
+        {
+            reference_step = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--budget") && i + 1 < argc)
+        {
+            budget = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+        {
+            threads = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--quick"))
+        {
+            quick = true;
+        }
+        else
+        {
+            bprintlf("Usage: %s [--reference STEP] [--budget RELATIVE_ERROR] [--threads N] [--quick]", argv[0]);
+            return 1;
+        }
+    }
+
+    if (!(reference_step > 0))
+    {
+        bprintlf(RED_FG "ERROR: The reference step must be positive.");
+        return 1;
+    }
+
+    // Low to mid altitudes at solar minimum and maximum; --quick keeps the short lifetimes only.
+    static const double altitudes[] = {250, 300, 350, 400};
+    static const double weather[][2] = {{70, 5}, {250, 30}};
+    int altitude_count = quick ? 2 : (int)(sizeof(altitudes) / sizeof(altitudes[0]));
+
+    validate_case_t cases[VALIDATE_MAX_CASES];
+    int count = 0;
+    for (int a = 0; a < altitude_count; a++)
+    {
+        for (int w = 0; w < (int)(sizeof(weather) / sizeof(weather[0])); w++)
+        {
+            cases[count++] = (validate_case_t){altitudes[a], weather[w][0], weather[w][1], 0, 0, 0};
+        }
+    }
+
+    int elliptical_failures = validate_elliptical();
+    int monte_carlo_failures = validate_monte_carlo();
+
+    bprintlf("Computing %d reference lifetimes at a tolerance of %g, checked with %g s steps...", count, VALIDATE_REFERENCE_TOLERANCE, reference_step);
+    validate_reference_t reference = {.cases = cases, .step = reference_step};
+    pool_run(count, threads, validate_reference_job, &reference);
+
+    double reference_error = 0, reference_disagreement = 0;
+    for (int c = 0; c < count; c++)
+    {
+        if (!(cases[c].reference > 0) || !(cases[c].estimate > 0) || !(cases[c].check > 0))
+        {
+            bprintlf(RED_FG "ERROR: No reference lifetime at %g km.", cases[c].altitude);
+            return 1;
+        }
+
+        double error = fabs(cases[c].reference - cases[c].estimate) / cases[c].reference;
+        double disagreement = fabs(cases[c].reference - cases[c].check) / cases[c].reference;
+        reference_error = error > reference_error ? error : reference_error;
+        reference_disagreement = disagreement > reference_disagreement ? disagreement : reference_disagreement;
+    }
+
+    bool reference_passed = reference_disagreement <= VALIDATE_REFERENCE_AGREEMENT;
+    bprintlf("Reference error estimate %.3e; fixed %g s steps differ by %.3e (allowed %.1e)  %s", reference_error, reference_step, reference_disagreement, VALIDATE_REFERENCE_AGREEMENT, reference_passed ? GREEN_FG "PASS" : RED_FG "FAIL");
+
+    // Settings are timed one at a time on this thread so that their costs compare.
+    validate_result_t results[VALIDATE_SETTINGS] = {0};
+    for (int s = 0; s < VALIDATE_SETTINGS; s++)
+    {
+        const validate_setting_t *setting = &validate_settings[s];
+        validate_result_t *result = &results[s];
+
+        for (int c = 0; c < count; c++)
+        {
+            double start = validate_now();
+            double lifetime = validate_lifetime(&cases[c], setting->engine, setting->step, setting->tolerance);
+            result->cost += validate_now() - start;
+
+            double seconds = fabs(lifetime - cases[c].reference);
+            double error = seconds / cases[c].reference;
+            result->max_error = error > result->max_error ? error : result->max_error;
+            result->max_seconds = seconds > result->max_seconds ? seconds : result->max_seconds;
+            result->rms_error += error * error;
+        }
+        result->rms_error = sqrt(result->rms_error / count);
+    }
+
+    int order[VALIDATE_SETTINGS];
+    for (int s = 0; s < VALIDATE_SETTINGS; s++)
+    {
+        order[s] = s;
+        results[s].pareto = true;
+        for (int t = 0; t < VALIDATE_SETTINGS; t++)
+        {
+            if (t != s && results[t].cost <= results[s].cost && results[t].max_error <= results[s].max_error &&
+                (results[t].cost < results[s].cost || results[t].max_error < results[s].max_error))
+            {
+                results[s].pareto = false;
+            }
+        }
+    }
+
+    // Cheapest first; a handful of entries needs no more than an insertion sort.
+    for (int i = 1; i < VALIDATE_SETTINGS; i++)
+    {
+        for (int j = i; j > 0 && results[order[j]].cost < results[order[j - 1]].cost; j--)
+        {
+            int swap = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = swap;
+        }
+    }
+
+    bprintlf("\n%-16s %12s %12s %12s %12s %8s %10s  %s", "SETTING", "COST (ms)", "MAX ERROR", "RMS ERROR", "MAX ERR (s)", "PARETO", "BUDGET", "STATUS");
+
+    int failures = 0;
+    for (int i = 0; i < VALIDATE_SETTINGS; i++)
+    {
+        const validate_setting_t *setting = &validate_settings[order[i]];
+        const validate_result_t *result = &results[order[i]];
+        double allowed = budget > 0 ? budget : setting->budget;
+        bool passed = result->max_error <= allowed;
+        failures += !passed;
+
+        bprintlf("%-16s %12.3f %12.3e %12.3e %12.1f %8s %10.1e  %s", setting->name, result->cost * 1e3, result->max_error, result->rms_error, result->max_seconds, result->pareto ? "*" : "", allowed, passed ? GREEN_FG "PASS" : RED_FG "FAIL");
+    }
+
+    bprintlf("\n%d settings over %d cases against adaptive %g; %d over budget.", VALIDATE_SETTINGS, count, VALIDATE_REFERENCE_TOLERANCE, failures);
+
+    return failures > 0 || !reference_passed || elliptical_failures > 0 || monte_carlo_failures > 0;
+}